@@ -493,26 +493,243 @@ Bzzt_Board *Bzzt_Board_From_ZZT_Board(ZZTworld *zw)
     if (!zw)
         return NULL;
 
-    ZZTblock *block = zztBoardGetBlock(zw);
-    Bzzt_Board *bzzt_board = Bzzt_Board_Create((const char *)zztBoardGetTitle(zw), block->width, block->height);
-
-    bzzt_board->board_n = zztBoardGetBoard_n(zw);
-    bzzt_board->board_s = zztBoardGetBoard_s(zw);
-    bzzt_board->board_e = zztBoardGetBoard_e(zw);
-    bzzt_board->board_w = zztBoardGetBoard_w(zw);
-    bzzt_board->max_shots = zztBoardGetMaxshots(zw);
-    bzzt_board->darkness = zztBoardGetDarkness(zw);
-    bzzt_board->reenter = zztBoardGetReenter(zw);
-    bzzt_board->reenter_x = zztBoardGetReenter_x(zw);
-    bzzt_board->reenter_y = zztBoardGetReenter_y(zw);
-    bzzt_board->time_limit = zztBoardGetTimelimit(zw);
-
-    const char *msg = (const char *)zztBoardGetMessage(zw);
+    return Bzzt_Board_From_ZZT_Board_Ptr(zztBoardGetCurPtr(zw));
+}
+
+static void copy_zzt_board_info(Bzzt_Board *b, ZZTboard *zb)
+{
+    b->board_n = zb->info.board_n;
+    b->board_s = zb->info.board_s;
+    b->board_e = zb->info.board_e;
+    b->board_w = zb->info.board_w;
+    b->max_shots = zb->info.maxshots;
+    b->darkness = zb->info.darkness;
+    b->reenter = zb->info.reenter;
+    b->reenter_x = zb->info.reenter_x;
+    b->reenter_y = zb->info.reenter_y;
+    b->time_limit = zb->info.timelimit;
+
+    const char *msg = (const char *)zb->info.message;
     if (msg)
     {
-        strncpy(bzzt_board->message, msg, sizeof(bzzt_board->message) - 1);
-        bzzt_board->message[sizeof(bzzt_board->message) - 1] = '\0';
+        strncpy(b->message, msg, sizeof(b->message) - 1);
+        b->message[sizeof(b->message) - 1] = '\0';
     }
+}
+
+// Fixed display attributes of the text elements, ZZT_CUSTOMTEXT through ZZT_BWHITETEXT
+static const uint8_t zzt_text_attr_table[] = {
+    0x08, 0x1F, 0x2F, 0x3F, 0x4F, 0x5F, 0x6F, 0x0F,
+    0x0F, 0x9F, 0xAF, 0xBF, 0xCF, 0xDF, 0xEF, 0xFF};
+
+/**
+ * @brief Glyph and attribute of a tile that has no stat on it.
+ *
+ * Mirrors zztLoneTileGetDisplayChar/Color, minus line walls, which depend
+ * on their neighbors and are resolved after the whole board is decoded.
+ */
+static void zzt_lone_visual(uint8_t type, uint8_t color, uint8_t *glyph, uint8_t *attr)
+{
+    if (type >= ZZT_CUSTOMTEXT)
+        *glyph = color;
+    else
+        *glyph = _zzt_display_char_table[type];
+
+    if (type > 127)
+        *attr = (uint8_t)(type - 128);
+    else if (type == ZZT_EMPTY)
+        *attr = 0x0F;
+    else if (type >= ZZT_CUSTOMTEXT && type <= ZZT_BWHITETEXT && type != ZZT_WHITETEXT + 1) // 0x36 keeps its color
+        *attr = zzt_text_attr_table[type - ZZT_CUSTOMTEXT];
+    else
+        *attr = color;
+}
+
+static void set_tile_attr(Bzzt_Tile *tile, uint8_t attr)
+{
+    tile->fg = bzzt_get_color(attr & 0x0F);
+    tile->bg = bzzt_get_color((attr >> 4) & 0x07); // 3 bits: background is 0-7 in EGA
+    tile->blink = (attr & 0x80) != 0;              // bit 7: blink flag
+}
+
+static bool is_line_neighbor(const Bzzt_Board *b, int x, int y)
+{
+    // Off-board counts as connected, same as ZZT
+    if (x < 0 || y < 0 || x >= b->width || y >= b->height)
+        return true;
+
+    uint8_t element = b->tiles[y * b->width + x].element;
+    return element == ZZT_LINE || element == ZZT_EDGE;
+}
+
+static void resolve_line_glyphs(Bzzt_Board *b)
+{
+    for (int y = 0; y < b->height; ++y)
+    {
+        for (int x = 0; x < b->width; ++x)
+        {
+            Bzzt_Tile *tile = &b->tiles[y * b->width + x];
+            if (tile->element != ZZT_LINE)
+                continue;
+
+            int flags = 0;
+            if (is_line_neighbor(b, x, y - 1))
+                flags |= 1;
+            if (is_line_neighbor(b, x, y + 1))
+                flags |= 2;
+            if (is_line_neighbor(b, x - 1, y))
+                flags |= 4;
+            if (is_line_neighbor(b, x + 1, y))
+                flags |= 8;
+            tile->glyph = _zzt_display_char_line_table[flags];
+        }
+    }
+}
+
+// Apply what a stat changes about how its tile is drawn
+static void apply_param_visual(Bzzt_Tile *tile, const ZZTparam *param)
+{
+    switch (tile->element)
+    {
+    case ZZT_TRANSPORTER:
+        if (param->xstep == -1)
+            tile->glyph = '<';
+        else if (param->xstep == 1)
+            tile->glyph = '>';
+        else if (param->ystep == -1)
+            tile->glyph = '^';
+        else
+            tile->glyph = 'v';
+        break;
+    case ZZT_OBJECT:
+        tile->glyph = param->data[0];
+        break;
+    case ZZT_PUSHER:
+        if (param->xstep == -1)
+            tile->glyph = 17;
+        else if (param->xstep == 1)
+            tile->glyph = 16;
+        else if (param->ystep == -1)
+            tile->glyph = 30;
+        else
+            tile->glyph = 31;
+        break;
+    case ZZT_PLAYER:
+        set_tile_attr(tile, 0x1F);
+        break;
+    }
+}
+
+/**
+ * @brief Convert a board that is still in its packed file form.
+ *
+ * RLE runs are expanded straight into the Bzzt tile array. Glyph and color
+ * are resolved once per run rather than once per cell, and no ZZTblock is
+ * built along the way. The ZZTboard is only read, so several boards can be
+ * converted at once. Returns NULL if the runs end before the board is full.
+ */
+static Bzzt_Board *board_from_zzt_packed(ZZTboard *zb)
+{
+    Bzzt_Board *b = Bzzt_Board_Create((const char *)zb->title, ZZT_BOARD_X_SIZE, ZZT_BOARD_Y_SIZE);
+    if (!b)
+        return NULL;
+
+    copy_zzt_board_info(b, zb);
+
+    const uint8_t *packed = zb->packed;
+    const uint8_t *packed_end = zb->packed + zb->packedlen;
+    int cell_count = b->width * b->height;
+    int cell = 0;
+    bool has_lines = false;
+    while (cell < cell_count)
+    {
+        if (packed_end - packed < 3)
+        {
+            Debug_Log(LOG_LEVEL_ERROR, LOG_BOARD, "Board '%s': packed data ends at tile %d of %d",
+                      (const char *)zb->title, cell, cell_count);
+            Bzzt_Board_Destroy(b);
+            return NULL;
+        }
+
+        int run = packed[0] ? packed[0] : 256;
+        uint8_t type = packed[1];
+        uint8_t color = packed[2];
+        packed += 3;
+
+        // The file may describe more tiles than the board holds; drop the excess
+        if (run > cell_count - cell)
+            run = cell_count - cell;
+
+        Bzzt_Tile fill = {0};
+        uint8_t attr;
+        zzt_lone_visual(type, color, &fill.glyph, &attr);
+        set_tile_attr(&fill, attr);
+        fill.element = type;
+        fill.visible = type != ZZT_INVISIBLE;
+        has_lines |= type == ZZT_LINE;
+
+        int x = cell % b->width;
+        int y = cell / b->width;
+        for (int end = cell + run; cell < end; ++cell)
+        {
+            fill.x = x;
+            fill.y = y;
+            b->tiles[cell] = fill;
+            if (++x == b->width)
+            {
+                x = 0;
+                y++;
+            }
+        }
+    }
+
+    if (has_lines)
+        resolve_line_glyphs(b);
+
+    for (int i = 0; i < zb->info.paramcount; ++i)
+    {
+        ZZTparam *param = &zb->params[i];
+        ZZTtile ztile = {ZZT_EMPTY, 0x0F, param}; // Only the type is read from it
+        if (param->x < b->width && param->y < b->height)
+        {
+            Bzzt_Tile *tile = &b->tiles[param->y * b->width + param->x];
+            ztile.type = tile->element;
+            if (tile->element != ZZT_LINE)
+                apply_param_visual(tile, param);
+        }
+
+        Bzzt_Stat *stat = Bzzt_Stat_From_ZZT_Param(param, ztile, param->x, param->y);
+        if (!stat)
+            continue;
+
+        // Stats go in directly so the stat index is built once, not per stat
+        if (b->stat_count >= b->stat_cap && grow_stats(b) != 0)
+        {
+            free(stat->program);
+            free(stat);
+            break;
+        }
+        b->stats[b->stat_count++] = stat;
+    }
+    Bzzt_Board_Rebuild_Stat_Index(b);
+
+    return b;
+}
+
+Bzzt_Board *Bzzt_Board_From_ZZT_Board_Ptr(ZZTboard *zb)
+{
+    if (!zb)
+        return NULL;
+
+    if (!zb->bigboard)
+        return (zb->packed && zb->params) ? board_from_zzt_packed(zb) : NULL;
+
+    ZZTblock *block = zb->bigboard;
+    Bzzt_Board *bzzt_board = Bzzt_Board_Create((const char *)zb->title, block->width, block->height);
+    if (!bzzt_board)
+        return NULL;
+
+    copy_zzt_board_info(bzzt_board, zb);
 
     // Populate tiles
     for (int y = 0; y < bzzt_board->height; ++y)
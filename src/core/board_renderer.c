@@ -1,6 +1,8 @@
 #include "board_renderer.h"
 #include "renderer.h"
 #include "bzzt.h"
+#include "snapshot.h"
+#include "clock.h"
 
 // static const Bzzt_Object empty = {
 //     .id = 0,
@@ -46,91 +48,81 @@
 //     }
 // }
 
-static void clear_board(Renderer *r, const Bzzt_Board *b)
+static void clear_board(Renderer *r, const Bzzt_Render_Snapshot *s)
 {
-    int count = b->width * b->height;
+    int count = s->width * s->height;
 
     for (int i = 0; i < count; ++i)
     {
-        int col = i % b->width;
-        int row = i / b->width;
+        int col = i % s->width;
+        int row = i / s->width;
         Renderer_Draw_Cell(r, col, row, 0, COLOR_BLACK, COLOR_BLACK);
     }
 }
 
-void Renderer_Draw_Board(Renderer *r, Bzzt_World *w, const Bzzt_Board *b)
+void Renderer_Draw_Board(Renderer *r, const Bzzt_Render_Snapshot *s)
 {
-    if (!r || !b)
+    if (!r || !s || !s->valid)
         return;
 
     // Clear the board
-    clear_board(r, b);
+    clear_board(r, s);
+
+    bool blink_off = s->allow_blink && !s->blink_state;
 
     // Step 1: Draw all static tiles (non-stat tiles)
-    for (int y = 0; y < b->height; ++y)
+    for (int y = 0; y < s->height; ++y)
     {
-        for (int x = 0; x < b->width; ++x)
+        for (int x = 0; x < s->width; ++x)
         {
-            Bzzt_Tile tile = Bzzt_Board_Get_Tile((Bzzt_Board *)b, x, y);
-            Bzzt_Stat *stat = Bzzt_Board_Get_Stat_At((Bzzt_Board *)b, x, y);
+            const Bzzt_Render_Cell *cell = &s->cells[y * s->width + x];
+            const Bzzt_Tile *tile = &cell->tile;
 
             // Only draw tiles that don't have stats on them
             // OR draw the under-tile if stat is present
-            if (!stat)
+            if (!cell->under_stat)
             {
-                if (tile.blink && w->allow_blink && !w->blink_state)
+                if (tile->blink && blink_off)
                 {
                     // Blink off - draw background
-                    if (tile.element == ZZT_WATER)
-                        Renderer_Draw_Cell(r, x, y, ' ', tile.bg,
-                                           tile.bg);
+                    if (tile->element == ZZT_WATER)
+                        Renderer_Draw_Cell(r, x, y, ' ', tile->bg,
+                                           tile->bg);
                 }
-                else if (tile.visible)
+                else if (tile->visible)
                 {
-                    Renderer_Draw_Cell(r, x, y, tile.glyph, tile.fg,
-                                       tile.bg);
+                    Renderer_Draw_Cell(r, x, y, tile->glyph, tile->fg,
+                                       tile->bg);
                 }
             }
             else
             {
                 // Draw under-tile for this stat's position
-                if (stat->under.visible)
-                    Renderer_Draw_Cell(r, x, y, stat->under.glyph,
-                                       stat->under.fg, stat->under.bg);
+                if (tile->visible)
+                    Renderer_Draw_Cell(r, x, y, tile->glyph,
+                                       tile->fg, tile->bg);
             }
         }
     }
 
-    for (int i = 0; i < b->stat_count; ++i)
+    double now_ms = Bzzt_Clock_Now_Ms();
+    for (int i = 0; i < s->stat_count; ++i)
     {
-        Bzzt_Stat *stat = b->stats[i];
-        if (!stat)
-            continue;
-        if (!Bzzt_Board_Is_In_Bounds((Bzzt_Board *)b, stat->x, stat->y))
-            continue;
+        const Bzzt_Render_Stat *stat = &s->stats[i];
+        const Bzzt_Tile *tile = &stat->tile;
 
         // Get interpolated position
         float render_x, render_y;
-        Bzzt_Get_Interpolated_Position(w, stat, &render_x, &render_y);
+        Bzzt_Render_Snapshot_Stat_Position(s, stat, now_ms, &render_x, &render_y);
 
-        // Get the tile at the stat's LOGICAL position (not interpolated)
-        Bzzt_Tile tile = Bzzt_Board_Get_Tile((Bzzt_Board *)b, stat->x, stat->y);
-        if (tile.element == ZZT_PLAYER)
-            tile = Bzzt_World_Get_Player_Render_Tile(w, tile);
+        // Handle blinking (paused player): don't draw stat during blink-off
+        if (tile->blink && blink_off)
+            continue;
 
-        // Check if we should draw this stat
-        bool should_draw = true;
-
-        // Handle blinking (paused player)
-        if (tile.blink && w->allow_blink && !w->blink_state)
-        {
-            should_draw = false; // Don't draw stat during blink-off
-        }
-
-        if (should_draw && tile.visible)
+        if (tile->visible)
         {
             Renderer_Draw_Cell_Float(r, render_x, render_y,
-                                     tile.glyph, tile.fg, tile.bg);
+                                     tile->glyph, tile->fg, tile->bg);
         }
     }
 }
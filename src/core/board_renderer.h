@@ -12,7 +12,6 @@
 #pragma once
 #include "renderer.h"
 
-typedef struct Bzzt_Board Bzzt_Board;
-typedef struct Bzzt_World Bzzt_World;
+typedef struct Bzzt_Render_Snapshot Bzzt_Render_Snapshot;
 
-void Renderer_Draw_Board(Renderer *, Bzzt_World *, const Bzzt_Board *);
\ No newline at end of file
+void Renderer_Draw_Board(Renderer *, const Bzzt_Render_Snapshot *);
\ No newline at end of file
@@ -23,11 +23,15 @@
 #define BZZT_MAX_PATH_LENGTH 1024
 
 #define BZZT_ENABLE_INTERPOLATION 0
+#define BZZT_ENABLE_SIM_THREAD 1 // Run world ticks on their own thread instead of inside Engine_Update
 
 typedef struct InputState InputState;
 typedef struct Bzzt_Timer Bzzt_Timer;
 typedef struct UI UI;
 typedef struct Engine Engine;
+typedef struct Bzzt_Thread_Pool Bzzt_Thread_Pool;
+typedef struct BZWFile BZWFile;
+typedef struct Bzzt_Board_Prefetch Bzzt_Board_Prefetch;
 
 // The direction an object is facing
 typedef enum
@@ -69,6 +73,7 @@ typedef struct Bzzt_Stat
     uint8_t data[3];
     uint8_t data_label[3];
     int16_t follower, leader;
+    int intent_slot; // Index into the world's intent buffer during a two-phase tick, -1 otherwise
 
     Bzzt_Tile under;
 
@@ -121,8 +126,43 @@ typedef struct Bzzt_Board
     int16_t time_limit;
 
     int idx;
+    bool live; // Keeps ticking while the player is on another board (parallel ticking only)
 } Bzzt_Board;
 
+/**
+ * @brief What a live background board changed in the world during one
+ * parallel tick. Each board ticks against its own copy of the world; the
+ * copies are diffed afterwards and the deltas merged in board order.
+ */
+typedef struct Bzzt_World_Delta
+{
+    int board_idx;
+    int ammo, gems, torches, score;
+} Bzzt_World_Delta;
+
+typedef enum Bzzt_Intent_Type
+{
+    BZZT_INTENT_NONE = 0, // Not due to act at its planned index
+    BZZT_INTENT_SERIAL,   // No planner for this element; runs its normal tick during resolve
+    BZZT_INTENT_MOVE,
+    BZZT_INTENT_PUSH
+} Bzzt_Intent_Type;
+
+/**
+ * @brief What a stat means to do this tick, worked out against the board as it
+ * was before any stat (other than the player) acted. Resolve re-checks it
+ * against the live board and falls back to the normal tick on a conflict.
+ */
+typedef struct Bzzt_Stat_Intent
+{
+    Bzzt_Intent_Type type;
+    Direction dir;
+    int from_x, from_y;   // Stat position when planned
+    int to_x, to_y;       // Target cell of a move
+    uint8_t seen_element; // Element at the target when planned
+    int player_x, player_y; // Player position a seek was worked out from
+} Bzzt_Stat_Intent;
+
 typedef struct Bzzt_World
 {
     char title[64];
@@ -165,6 +205,21 @@ typedef struct Bzzt_World
     bool strict_palette;
 
     bool loaded;
+
+    uint32_t rng_state; // World RNG; live background boards get their own seed per tick
+
+    bool parallel_ticking;        // Tick every live board each tick, not just the current one
+    bool background;              // A live board's private copy of the world during a parallel tick
+    Bzzt_Thread_Pool *tick_pool;  // Workers for live boards and two-phase planning
+
+    ZZTworld *zzt_source; // Packed boards not converted yet; freed once every board is converted
+    BZWFile *bzw_source;  // Boards not read yet from a mapped .bzzt file; closed once every board is read
+    int boards_pending;   // Entries of boards[] still NULL because they wait in zzt_source or bzw_source
+    Bzzt_Board_Prefetch *prefetch; // Converts pending boards next to the current one in the background; NULL when off
+
+    bool two_phase_ticking;      // Plan stat intents in parallel, then resolve them in stat order
+    Bzzt_Stat_Intent *intents;   // Plan buffer for the current board, one per stat
+    int intents_cap;
 } Bzzt_World;
 
 typedef struct Bzzt_Viewport
@@ -186,6 +241,8 @@ bool Bzzt_Tile_Is_Walkable(Bzzt_World *w, Bzzt_Tile tile);
 bool Bzzt_Tile_Is_Pushable(Bzzt_Tile tile);
 
 Bzzt_World *Bzzt_World_From_ZZT_Stream(FILE *fp, const char *display_name);
+// Load a ZZT world from a buffer holding the whole file; the buffer can be freed afterwards
+Bzzt_World *Bzzt_World_From_ZZT_Memory(const uint8_t *data, size_t size, const char *display_name);
 
 bool Bzzt_Tile_Is_Blocked(Bzzt_Board *b, Bzzt_Tile tile, Direction direction);
 
@@ -246,12 +303,20 @@ void Bzzt_Board_Stat_Die(Bzzt_Board *b, Bzzt_Stat *stat);
 
 // Update a given stat
 void Bzzt_Stat_Update(UI *ui, Bzzt_World *w, Bzzt_Stat *stat, int stat_idx);
+// Work out what a stat will do this tick without touching the board. Safe to call from several threads at once.
+void Bzzt_Stat_Plan(Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat, int stat_idx, Bzzt_Stat_Intent *out);
+// Apply a planned intent to the current board, or run the normal tick if the plan went stale.
+// stat_idx is the stat's index now, which decides whether it acts, as in Bzzt_Stat_Update.
+void Bzzt_Stat_Resolve(UI *ui, Bzzt_World *w, Bzzt_Stat *stat, int stat_idx, const Bzzt_Stat_Intent *intent);
 
 void Bzzt_Stat_Destroy(Bzzt_Stat *s);
 
-void Bzzt_Get_Interpolated_Position(Bzzt_World *w, Bzzt_Stat *stat, float *out_x, float *out_y);
-
 void Bzzt_World_Toggle_Interpolation(Bzzt_World *w);
+void Bzzt_World_Cycle_Turbo(Bzzt_World *w);
+// Two-phase ticking on with one worker per CPU, or back off
+void Bzzt_World_Toggle_Two_Phase_Ticking(Bzzt_World *w);
+// Parallel ticking of live boards on with one worker per CPU, or back off
+void Bzzt_World_Toggle_Parallel_Ticking(Bzzt_World *w);
 
 // Return a Bzzt object by its unique object id.
 Bzzt_Object *Bzzt_Board_Get_Object(Bzzt_Board *b, int id);
@@ -277,8 +342,13 @@ int Bzzt_Board_Get_Bullet_Count(Bzzt_Board *b);
 // Spawn a new stat of given type at x/y position with default values
 Bzzt_Stat *Bzzt_Board_Spawn_Stat(Bzzt_Board *b, uint8_t type, int x, int y, Color_Bzzt fg, Color_Bzzt bg);
 
+// Bump whenever ZZT conversion changes what a converted world looks like; cached conversions from other versions are dropped
+#define BZZT_ZZT_CONVERTER_VERSION 1
+
 // Convert the currently selected board in a ZZT world to a Bzzt board
 Bzzt_Board *Bzzt_Board_From_ZZT_Board(ZZTworld *zw);
+// Convert a ZZT board to a Bzzt board; packed boards are decoded directly without unpacking them
+Bzzt_Board *Bzzt_Board_From_ZZT_Board_Ptr(ZZTboard *zb);
 
 /* -- --*/
 
@@ -288,14 +358,26 @@ Bzzt_Board *Bzzt_Board_From_ZZT_Board(ZZTworld *zw);
 Bzzt_World *Bzzt_World_Create(char *title);
 // Add given board to a Bzzt_World
 void Bzzt_World_Add_Board(Bzzt_World *world, Bzzt_Board *board);
-// Load a Bzzt_World from a file
+// Replace w's boards and state with a native .bzzt world. Boards are read as they are first asked for.
+// Returns 0 on success; on failure w is left unchanged.
 int Bzzt_World_Load(Bzzt_World *w, const char *path);
-// Save a Bzzt_World to a file
+// Save a Bzzt_World as a native .bzzt world. Returns 0 on success.
 int Bzzt_World_Save(Bzzt_World *w, const char *path);
 // Destroy a Bzzt_World
 void Bzzt_World_Destroy(Bzzt_World *w);
 // Do updates and logic handlers for a Bzzt_World
-void Bzzt_World_Update(Engine *e, Bzzt_World *w, InputState *in);
+void Bzzt_World_Update(UI *ui, Bzzt_World *w, InputState *in);
+// Return the board at idx, converting or reading it from the world's source file on first use
+Bzzt_Board *Bzzt_World_Get_Board(Bzzt_World *w, int idx);
+// Convert the pending boards reachable from the current one (its four exits and passage targets) on a
+// background worker, so switching to them doesn't stall a tick
+bool Bzzt_World_Set_Prefetch(Bzzt_World *w, bool enabled);
+// Queue the current board's neighbours for prefetch; board switches already do this
+void Bzzt_World_Prefetch_Neighbors(Bzzt_World *w);
+// Pending boards asked for that were already prefetched, still being prefetched (and waited on), or not queued at all
+void Bzzt_World_Get_Prefetch_Stats(Bzzt_World *w, uint64_t *hits, uint64_t *waits, uint64_t *misses);
+// Rough heap footprint of the world, counting pending boards at the size they will have once converted
+size_t Bzzt_World_Memory_Estimate(const Bzzt_World *w);
 // Switch the current board to a new one based on a target board index. Set player at given x/y position.
 bool Bzzt_World_Switch_Board_To(Bzzt_World *w, int board_idx, int x, int y);
 // Pause or unpause the game
@@ -308,9 +390,30 @@ bool Bzzt_World_Damage_Player(UI *ui, Bzzt_World *w, int amount, Bzzt_DamageSour
 Bzzt_Tile Bzzt_World_Get_Player_Render_Tile(Bzzt_World *w, Bzzt_Tile tile);
 int Bzzt_World_Normalize_Game_Speed(int game_speed);
 int Bzzt_World_Message_Ticks(Bzzt_World *w);
+// Uniform random number in [0, range), advancing the given RNG state
+uint32_t Bzzt_Random_Next(uint32_t *state, uint32_t range);
+// Uniform random number in [0, 1), advancing the given RNG state
+double Bzzt_Random_Unit(uint32_t *state);
+// Uniform random number in [0, range) from the world RNG
+uint32_t Bzzt_World_Random(Bzzt_World *w, uint32_t range);
+// Plan the current board's stats on a worker pool, then resolve them in stat order. Off by default.
+// threads < 0 uses one per CPU; 0 plans on the tick thread unless parallel ticking has a pool.
+bool Bzzt_World_Set_Two_Phase_Ticking(Bzzt_World *w, bool enabled, int threads);
+// Tick live boards the player isn't on alongside the current one, on a worker pool. Off by default.
+// Converts every board still packed, so their live flags are known. threads <= 0 uses one per CPU.
+bool Bzzt_World_Set_Parallel_Ticking(Bzzt_World *w, bool enabled, int threads);
+// Mark a board as live so it keeps ticking in parallel mode while the player is elsewhere
+void Bzzt_World_Set_Board_Live(Bzzt_World *w, int board_idx, bool live);
+// Add what a background board changed to w's counters, clamped as the counters are
+void Bzzt_World_Merge_Board_Delta(Bzzt_World *w, const Bzzt_World_Delta *delta);
 
 // Convert a ZZT world to a Bzzt world
 Bzzt_World *Bzzt_World_From_ZZT_World(char *file);
+// Convert a ZZT world and all of its boards, unpacking boards on the given pool (NULL = this thread)
+Bzzt_World *Bzzt_World_From_ZZT_World_Parallel(char *file, Bzzt_Thread_Pool *pool);
+// Convert every board still packed, spreading them over the pool (NULL = this thread).
+// Returns false if any board failed to convert; those boards stay NULL.
+bool Bzzt_World_Convert_All_Boards(Bzzt_World *w, Bzzt_Thread_Pool *pool);
 
 /* -- --*/
 
@@ -0,0 +1,5 @@
+#pragma once
+
+// Monotonic, high-resolution wall clock in milliseconds. The epoch is
+// arbitrary, so only differences between two readings are meaningful.
+double Bzzt_Clock_Now_Ms(void);
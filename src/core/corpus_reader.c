@@ -0,0 +1,569 @@
+#if defined(__linux__)
+#define _GNU_SOURCE // syscall() and MAP_POPULATE, for io_uring
+#endif
+
+#include "corpus_reader.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "clock.h"
+#include "debugger.h"
+#include "thread_pool.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define CORPUS_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+#endif
+
+#define CORPUS_MAX_BATCH 4096
+
+#ifdef CORPUS_HAVE_IO_URING
+// The rings of one io_uring instance, mapped straight from the kernel; no liburing needed
+typedef struct Corpus_Ring
+{
+    int fd;
+    void *sq_map, *cq_map;
+    size_t sq_map_size, cq_map_size;
+    struct io_uring_sqe *sqes;
+    size_t sqes_size;
+    unsigned *sq_tail, *sq_mask, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_cqe *cqes;
+    unsigned unsubmitted; // Queued SQEs the kernel has not taken yet
+} Corpus_Ring;
+
+// A file whose read is in flight on the ring
+typedef struct Corpus_Slot
+{
+    bool busy;
+    int index;
+    int fd;
+    uint8_t *data;
+    size_t size, done;
+    struct iovec iov;
+} Corpus_Slot;
+#endif
+
+struct Bzzt_Corpus_Reader
+{
+    const char *const *paths;
+    int count;
+    int next_path; // Next file to start reading
+    int in_flight;
+    int batch;
+    Bzzt_Corpus_Stats stats;
+    double start_ms;
+
+    // Finished files not handed over yet, oldest first
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    Bzzt_Corpus_File *done;
+    int done_head, done_count, done_cap;
+
+    Bzzt_Thread_Pool *pool; // BZZT_CORPUS_THREADS
+#ifdef CORPUS_HAVE_IO_URING
+    Corpus_Ring ring; // BZZT_CORPUS_IO_URING
+    Corpus_Slot *slots;
+#endif
+};
+
+typedef struct Corpus_Job
+{
+    Bzzt_Corpus_Reader *reader;
+    int index;
+} Corpus_Job;
+
+const char *Bzzt_Corpus_Backend_Name(Bzzt_Corpus_Backend backend)
+{
+    switch (backend)
+    {
+    case BZZT_CORPUS_IO_URING:
+        return "io_uring";
+    case BZZT_CORPUS_THREADS:
+        return "threads";
+    default:
+        return "auto";
+    }
+}
+
+// Caller holds r->lock, or is the only thread touching the queue
+static void corpus_push_done(Bzzt_Corpus_Reader *r, int index, uint8_t *data, size_t size)
+{
+    Bzzt_Corpus_File *f = &r->done[(r->done_head + r->done_count) % r->done_cap];
+    f->index = index;
+    f->path = r->paths[index];
+    f->data = data;
+    f->size = size;
+    r->done_count++;
+}
+
+static bool corpus_pop_done(Bzzt_Corpus_Reader *r, Bzzt_Corpus_File *out)
+{
+    if (r->done_count == 0)
+        return false;
+
+    *out = r->done[r->done_head];
+    r->done_head = (r->done_head + 1) % r->done_cap;
+    r->done_count--;
+    return true;
+}
+
+static void corpus_count_file(Bzzt_Corpus_Reader *r, const Bzzt_Corpus_File *f)
+{
+    if (f->data)
+    {
+        r->stats.files_read++;
+        r->stats.bytes += f->size;
+    }
+    else
+    {
+        r->stats.files_failed++;
+        Debug_Log(LOG_LEVEL_DEBUG, LOG_WORLD, "Corpus reader could not read %s.", f->path);
+    }
+    r->stats.elapsed_ms = Bzzt_Clock_Now_Ms() - r->start_ms;
+}
+
+// ---------------- thread pool backend -------------------------------------
+
+static bool corpus_read_whole_file(const char *path, uint8_t **out_data, size_t *out_size)
+{
+    FILE *fp = fopen(path, "rb");
+    if (!fp)
+        return false;
+
+    struct stat st;
+    if (fstat(fileno(fp), &st) != 0 || st.st_size < 0 || st.st_size > BZZT_CORPUS_MAX_FILE_BYTES)
+    {
+        fclose(fp);
+        return false;
+    }
+
+    size_t size = (size_t)st.st_size;
+    uint8_t *data = malloc(size ? size : 1);
+    bool ok = data && fread(data, 1, size, fp) == size;
+    fclose(fp);
+    if (!ok)
+    {
+        free(data);
+        return false;
+    }
+
+    *out_data = data;
+    *out_size = size;
+    return true;
+}
+
+static void corpus_run_read_job(void *arg)
+{
+    Corpus_Job *job = (Corpus_Job *)arg;
+    Bzzt_Corpus_Reader *r = job->reader;
+
+    uint8_t *data = NULL;
+    size_t size = 0;
+    if (!corpus_read_whole_file(r->paths[job->index], &data, &size))
+        data = NULL;
+
+    pthread_mutex_lock(&r->lock);
+    corpus_push_done(r, job->index, data, size);
+    pthread_cond_signal(&r->ready);
+    pthread_mutex_unlock(&r->lock);
+    free(job);
+}
+
+static bool corpus_threads_next(Bzzt_Corpus_Reader *r, Bzzt_Corpus_File *out)
+{
+    // Keep a batch of reads queued; the done queue has room for all of them
+    while (r->in_flight < r->batch && r->next_path < r->count)
+    {
+        Corpus_Job *job = malloc(sizeof(Corpus_Job));
+        if (!job)
+            break;
+        job->reader = r;
+        job->index = r->next_path++;
+        r->in_flight++;
+        if (!Bzzt_Thread_Pool_Submit(r->pool, NULL, corpus_run_read_job, job))
+            corpus_run_read_job(job);
+    }
+
+    pthread_mutex_lock(&r->lock);
+    while (r->done_count == 0 && r->in_flight > 0)
+        pthread_cond_wait(&r->ready, &r->lock);
+    bool got = corpus_pop_done(r, out);
+    pthread_mutex_unlock(&r->lock);
+
+    if (got)
+        r->in_flight--;
+    return got;
+}
+
+// ---------------- io_uring backend ----------------------------------------
+
+#ifdef CORPUS_HAVE_IO_URING
+
+static int corpus_ring_enter(Corpus_Ring *ring, unsigned to_submit, unsigned min_complete)
+{
+    return (int)syscall(__NR_io_uring_enter, ring->fd, to_submit, min_complete, IORING_ENTER_GETEVENTS, NULL, 0);
+}
+
+static void corpus_ring_close(Corpus_Ring *ring)
+{
+    if (ring->sqes)
+        munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_map && ring->cq_map != ring->sq_map)
+        munmap(ring->cq_map, ring->cq_map_size);
+    if (ring->sq_map)
+        munmap(ring->sq_map, ring->sq_map_size);
+    if (ring->fd >= 0)
+        close(ring->fd);
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = -1;
+}
+
+// False when the kernel has no io_uring or won't give us one (seccomp, old kernels, limits)
+static bool corpus_ring_open(Corpus_Ring *ring, unsigned entries)
+{
+    memset(ring, 0, sizeof(*ring));
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = entries * 2;
+    ring->fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (ring->fd < 0 && errno == EINVAL)
+    {
+        // Kernels before 5.5 can't size the completion ring; the default of twice the entries is what we asked for
+        memset(&params, 0, sizeof(params));
+        ring->fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    }
+    if (ring->fd < 0)
+    {
+        ring->fd = -1;
+        return false;
+    }
+
+    ring->sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_map = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_map && ring->cq_map_size > ring->sq_map_size)
+        ring->sq_map_size = ring->cq_map_size;
+
+    ring->sq_map = mmap(NULL, ring->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                        IORING_OFF_SQ_RING);
+    if (ring->sq_map == MAP_FAILED)
+    {
+        ring->sq_map = NULL;
+        corpus_ring_close(ring);
+        return false;
+    }
+
+    ring->cq_map = single_map ? ring->sq_map
+                              : mmap(NULL, ring->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                     ring->fd, IORING_OFF_CQ_RING);
+    if (ring->cq_map == MAP_FAILED)
+    {
+        ring->cq_map = NULL;
+        corpus_ring_close(ring);
+        return false;
+    }
+
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                      IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED)
+    {
+        ring->sqes = NULL;
+        corpus_ring_close(ring);
+        return false;
+    }
+
+    uint8_t *sq = ring->sq_map;
+    uint8_t *cq = ring->cq_map;
+    ring->sq_tail = (unsigned *)(sq + params.sq_off.tail);
+    ring->sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned *)(sq + params.sq_off.array);
+    ring->cq_head = (unsigned *)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned *)(cq + params.cq_off.tail);
+    ring->cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+    return true;
+}
+
+// Queue a read of whatever is left of the slot's file
+static void corpus_ring_queue_read(Corpus_Ring *ring, Corpus_Slot *slot, int slot_idx)
+{
+    unsigned tail = *ring->sq_tail;
+    unsigned idx = tail & *ring->sq_mask;
+    struct io_uring_sqe *sqe = &ring->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+
+    slot->iov.iov_base = slot->data + slot->done;
+    slot->iov.iov_len = slot->size - slot->done;
+    sqe->opcode = IORING_OP_READV; // Plain READ needs 5.6; READV works wherever io_uring does
+    sqe->fd = slot->fd;
+    sqe->addr = (uint64_t)(uintptr_t)&slot->iov;
+    sqe->len = 1;
+    sqe->off = slot->done;
+    sqe->user_data = (uint64_t)slot_idx;
+
+    ring->sq_array[idx] = idx;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ring->unsubmitted++;
+}
+
+static void corpus_slot_finish(Bzzt_Corpus_Reader *r, Corpus_Slot *slot, bool ok)
+{
+    close(slot->fd);
+    if (ok)
+    {
+        corpus_push_done(r, slot->index, slot->data, slot->done);
+    }
+    else
+    {
+        free(slot->data);
+        corpus_push_done(r, slot->index, NULL, 0);
+    }
+    slot->busy = false;
+    slot->data = NULL;
+    r->in_flight--;
+}
+
+// Open files into free slots and queue their reads. Files that can't be
+// opened, and empty ones, go straight to the done queue.
+static void corpus_uring_start_reads(Bzzt_Corpus_Reader *r)
+{
+    for (int s = 0; s < r->batch && r->next_path < r->count && r->done_count < r->batch; ++s)
+    {
+        Corpus_Slot *slot = &r->slots[s];
+        if (slot->busy)
+            continue;
+
+        int index = r->next_path++;
+        int fd = open(r->paths[index], O_RDONLY | O_CLOEXEC);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0 || st.st_size < 0 || st.st_size > BZZT_CORPUS_MAX_FILE_BYTES)
+        {
+            if (fd >= 0)
+                close(fd);
+            corpus_push_done(r, index, NULL, 0);
+            continue;
+        }
+
+        uint8_t *data = malloc(st.st_size ? (size_t)st.st_size : 1);
+        if (!data || st.st_size == 0)
+        {
+            close(fd);
+            corpus_push_done(r, index, data, 0);
+            continue;
+        }
+
+        slot->busy = true;
+        slot->index = index;
+        slot->fd = fd;
+        slot->data = data;
+        slot->size = (size_t)st.st_size;
+        slot->done = 0;
+        r->in_flight++;
+        corpus_ring_queue_read(&r->ring, slot, s);
+    }
+}
+
+static void corpus_uring_reap(Bzzt_Corpus_Reader *r)
+{
+    Corpus_Ring *ring = &r->ring;
+    unsigned head = *ring->cq_head;
+    unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head)
+    {
+        struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+        Corpus_Slot *slot = &r->slots[cqe->user_data];
+        int res = cqe->res;
+
+        if (res == -EINTR || res == -EAGAIN)
+            corpus_ring_queue_read(ring, slot, (int)cqe->user_data);
+        else if (res < 0)
+            corpus_slot_finish(r, slot, false);
+        else if (res == 0)
+            corpus_slot_finish(r, slot, true); // File shrank since fstat; keep what was there
+        else if ((slot->done += (size_t)res) < slot->size)
+            corpus_ring_queue_read(ring, slot, (int)cqe->user_data); // Short read
+        else
+            corpus_slot_finish(r, slot, true);
+    }
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+}
+
+// Submit what is queued, and when block is set wait for a completion if any read is in flight
+static bool corpus_uring_wait(Bzzt_Corpus_Reader *r, bool block)
+{
+    Corpus_Ring *ring = &r->ring;
+    for (;;)
+    {
+        int ret = corpus_ring_enter(ring, ring->unsubmitted, block && r->in_flight > 0 ? 1 : 0);
+        if (ret >= 0)
+        {
+            ring->unsubmitted -= (unsigned)ret;
+            return true;
+        }
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        {
+            Debug_Log(LOG_LEVEL_ERROR, LOG_WORLD, "io_uring_enter failed: %s", strerror(errno));
+            return false;
+        }
+        // EAGAIN/EBUSY: completions are backed up; take them off the ring and retry
+        corpus_uring_reap(r);
+        if (r->done_count > 0)
+            return true;
+    }
+}
+
+static bool corpus_uring_next(Bzzt_Corpus_Reader *r, Bzzt_Corpus_File *out)
+{
+    for (;;)
+    {
+        if (corpus_pop_done(r, out))
+            return true;
+        if (r->in_flight == 0 && r->next_path >= r->count)
+            return false;
+
+        corpus_uring_start_reads(r);
+        if (r->done_count > 0 && r->ring.unsubmitted == 0)
+            continue;
+        // With a file already waiting to be handed over, just submit the new reads
+        if (!corpus_uring_wait(r, r->done_count == 0))
+        {
+            // The ring is unusable; report what is in flight as failed
+            for (int s = 0; s < r->batch; ++s)
+            {
+                if (r->slots[s].busy)
+                    corpus_slot_finish(r, &r->slots[s], false);
+            }
+            r->next_path = r->count;
+            continue;
+        }
+        corpus_uring_reap(r);
+    }
+}
+
+#endif /* CORPUS_HAVE_IO_URING */
+
+// ---------------- public API ----------------------------------------------
+
+static bool corpus_start_threads(Bzzt_Corpus_Reader *r)
+{
+    // Reads block, so run more of them at once than there are CPUs
+    int threads = Bzzt_Cpu_Count() * 2;
+    if (threads > r->batch)
+        threads = r->batch;
+    r->pool = Bzzt_Thread_Pool_Create(threads);
+    r->stats.backend = BZZT_CORPUS_THREADS;
+    return r->pool != NULL;
+}
+
+Bzzt_Corpus_Reader *Bzzt_Corpus_Reader_Open(const char *const *paths, int count, Bzzt_Corpus_Backend backend, int batch)
+{
+    if (!paths || count < 0)
+        return NULL;
+
+    Bzzt_Corpus_Reader *r = calloc(1, sizeof(Bzzt_Corpus_Reader));
+    if (!r)
+        return NULL;
+
+    r->paths = paths;
+    r->count = count;
+    r->batch = batch > 0 ? batch : BZZT_CORPUS_DEFAULT_BATCH;
+    if (r->batch > CORPUS_MAX_BATCH)
+        r->batch = CORPUS_MAX_BATCH;
+    r->done_cap = r->batch * 2;
+    r->done = calloc((size_t)r->done_cap, sizeof(Bzzt_Corpus_File));
+    pthread_mutex_init(&r->lock, NULL);
+    pthread_cond_init(&r->ready, NULL);
+    r->start_ms = Bzzt_Clock_Now_Ms();
+
+    bool started = false;
+#ifdef CORPUS_HAVE_IO_URING
+    r->ring.fd = -1;
+    if (backend != BZZT_CORPUS_THREADS)
+    {
+        r->slots = calloc((size_t)r->batch, sizeof(Corpus_Slot));
+        started = r->slots && corpus_ring_open(&r->ring, (unsigned)r->batch);
+        if (started)
+            r->stats.backend = BZZT_CORPUS_IO_URING;
+        else if (backend == BZZT_CORPUS_IO_URING)
+            Debug_Log(LOG_LEVEL_WARN, LOG_WORLD, "io_uring is not available; reading the corpus on threads.");
+    }
+#else
+    if (backend == BZZT_CORPUS_IO_URING)
+        Debug_Log(LOG_LEVEL_WARN, LOG_WORLD, "io_uring is not available; reading the corpus on threads.");
+#endif
+    if (!started)
+        started = corpus_start_threads(r);
+
+    if (!r->done || !started)
+    {
+        Bzzt_Corpus_Reader_Close(r);
+        return NULL;
+    }
+    return r;
+}
+
+bool Bzzt_Corpus_Reader_Next(Bzzt_Corpus_Reader *r, Bzzt_Corpus_File *out)
+{
+    if (!r || !out)
+        return false;
+
+    bool got;
+#ifdef CORPUS_HAVE_IO_URING
+    if (r->stats.backend == BZZT_CORPUS_IO_URING)
+        got = corpus_uring_next(r, out);
+    else
+#endif
+        got = corpus_threads_next(r, out);
+
+    if (got)
+        corpus_count_file(r, out);
+    return got;
+}
+
+void Bzzt_Corpus_Reader_Get_Stats(const Bzzt_Corpus_Reader *r, Bzzt_Corpus_Stats *out)
+{
+    if (r && out)
+        *out = r->stats;
+}
+
+void Bzzt_Corpus_Reader_Close(Bzzt_Corpus_Reader *r)
+{
+    if (!r)
+        return;
+
+    // Reads still in flight write into our buffers; let them land first
+    r->next_path = r->count;
+    if (r->pool)
+        Bzzt_Thread_Pool_Destroy(r->pool);
+#ifdef CORPUS_HAVE_IO_URING
+    if (r->ring.fd >= 0)
+    {
+        while (r->in_flight > 0 && corpus_uring_wait(r, true))
+            corpus_uring_reap(r);
+        corpus_ring_close(&r->ring);
+    }
+    free(r->slots);
+#endif
+
+    Bzzt_Corpus_File f;
+    while (r->done && corpus_pop_done(r, &f))
+        free(f.data);
+    free(r->done);
+    pthread_mutex_destroy(&r->lock);
+    pthread_cond_destroy(&r->ready);
+    free(r);
+}
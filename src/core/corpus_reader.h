@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum Bzzt_Corpus_Backend
+{
+    BZZT_CORPUS_AUTO,     // io_uring where the kernel allows it, otherwise threads
+    BZZT_CORPUS_IO_URING, // Batched reads through one io_uring (Linux)
+    BZZT_CORPUS_THREADS,  // Blocking reads spread over a thread pool
+} Bzzt_Corpus_Backend;
+
+#define BZZT_CORPUS_DEFAULT_BATCH 64                    // Files in flight at once
+#define BZZT_CORPUS_MAX_FILE_BYTES (64 * 1024 * 1024)   // Larger files are reported as failed reads
+
+// One whole file, handed over by Bzzt_Corpus_Reader_Next
+typedef struct Bzzt_Corpus_File
+{
+    int index;        // Position in the paths array given to Open
+    const char *path; // That entry of the paths array
+    uint8_t *data;    // The file's bytes; the caller frees them. NULL if it could not be read.
+    size_t size;
+} Bzzt_Corpus_File;
+
+typedef struct Bzzt_Corpus_Stats
+{
+    int files_read, files_failed;
+    uint64_t bytes;
+    double elapsed_ms; // From Open to the latest file handed over
+    Bzzt_Corpus_Backend backend; // The one actually in use
+} Bzzt_Corpus_Stats;
+
+/* Reads a list of files for bulk jobs (indexing, conversion, benchmarks),
+ * keeping a batch of reads in flight instead of reading one file at a time.
+ * Files come back in the order their reads complete, not the order given. */
+typedef struct Bzzt_Corpus_Reader Bzzt_Corpus_Reader;
+
+// paths must stay valid until Close. batch <= 0 picks BZZT_CORPUS_DEFAULT_BATCH.
+Bzzt_Corpus_Reader *Bzzt_Corpus_Reader_Open(const char *const *paths, int count, Bzzt_Corpus_Backend backend, int batch);
+// Wait for the next complete file. False once every file has been handed over.
+bool Bzzt_Corpus_Reader_Next(Bzzt_Corpus_Reader *r, Bzzt_Corpus_File *out);
+void Bzzt_Corpus_Reader_Get_Stats(const Bzzt_Corpus_Reader *r, Bzzt_Corpus_Stats *out);
+// Stops outstanding reads and frees anything not handed over yet
+void Bzzt_Corpus_Reader_Close(Bzzt_Corpus_Reader *r);
+const char *Bzzt_Corpus_Backend_Name(Bzzt_Corpus_Backend backend);
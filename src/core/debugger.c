@@ -18,6 +18,7 @@
 #include <stdbool.h>
 #include <sys/stat.h>
 #include <stdint.h>
+#include <pthread.h>
 
 #if defined(_WIN32)
 #include <io.h>
@@ -30,6 +31,7 @@
 #endif
 
 static Debugger *dbg = NULL;
+static pthread_mutex_t log_lock = PTHREAD_MUTEX_INITIALIZER; // Worker threads log too; keep lines whole
 
 static void get_time(struct tm *out_tm, time_t *out_sec)
 {
@@ -202,7 +204,9 @@ void Debug_Printf(LogType lt, const char *fmt, ...)
 
     va_list ap;
     va_start(ap, fmt);
+    pthread_mutex_lock(&log_lock);
     write_line(type_str, fmt, ap);
+    pthread_mutex_unlock(&log_lock);
     va_end(ap);
 }
 
@@ -230,11 +234,15 @@ const char *Debug_Log(LogLevel lvl, LogType lt, const char *fmt, ...)
                                                       : "";
 
     static char prefix[64];
-    snprintf(prefix, sizeof prefix, "[%s] %s %s: ", tbuf, lvl_s, typ_s);
+    char line_prefix[64];
+    snprintf(line_prefix, sizeof line_prefix, "[%s] %s %s: ", tbuf, lvl_s, typ_s);
 
     va_list ap;
     va_start(ap, fmt);
+    pthread_mutex_lock(&log_lock);
+    memcpy(prefix, line_prefix, sizeof prefix);
     write_line(prefix, fmt, ap);
+    pthread_mutex_unlock(&log_lock);
     va_end(ap);
 
     return prefix;
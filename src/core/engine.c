@@ -19,10 +19,15 @@
 #include "ui.h"
 #include "bui_loader.h"
 #include "file_browser.h"
-#include "zip_archive.h"
+#include "world_cache.h"
+#include "mem_cache.h"
+#include "world_loader.h"
+#include "world_preload.h"
 #include "color.h"
 #include "coords.h"
 #include "bzzt.h"
+#include "sim_thread.h"
+#include "snapshot.h"
 #include "raylib.h"
 
 #define ZZT_FILE "untitled.zzt" // temp file load
@@ -49,13 +54,86 @@ static void clear_pending_world_load(Engine *e)
     e->world_to_load_from_zip = false;
 }
 
+static void stop_simulation(Engine *e)
+{
+    if (!e)
+        return;
+
+    if (e->sim)
+    {
+        Bzzt_Sim_Thread_Stop(e->sim);
+        e->sim = NULL;
+    }
+    e->view = NULL;
+}
+
+// Point the renderer and sidebar at the world's latest state
+static void refresh_world_view(Engine *e)
+{
+    if (!e || !e->world)
+        return;
+
+    if (e->sim)
+    {
+        const Bzzt_Render_Snapshot *latest = Bzzt_Sim_Thread_Acquire_Snapshot(e->sim);
+        if (latest)
+            e->view = latest;
+    }
+    else if (Bzzt_Render_Snapshot_Capture(&e->local_view, e->world, e->sim_ui))
+    {
+        e->view = &e->local_view;
+    }
+
+    if (!e->view)
+        return;
+
+    e->hud = e->view->counters;
+    UI_Mirror_Message(e->ui, e->view->message, e->view->message_ticks_remaining, e->view->message_active);
+}
+
+static void start_simulation(Engine *e)
+{
+    if (!e || !e->world)
+        return;
+
+#if BZZT_ENABLE_SIM_THREAD
+    if (!e->sim)
+    {
+        e->sim = Bzzt_Sim_Thread_Start(e->world, e->sim_ui);
+        if (!e->sim)
+            Debug_Log(LOG_LEVEL_WARN, LOG_ENGINE, "Simulation thread unavailable; ticking on the main thread.");
+    }
+#endif
+
+    refresh_world_view(e);
+}
+
+// Route a world command through the simulation thread when it owns the world
+static void send_world_command(Engine *e, Bzzt_Sim_Command_Type type)
+{
+    if (!e || !e->world)
+        return;
+
+    if (e->sim)
+        Bzzt_Sim_Thread_Push_Command(e->sim, type);
+    else
+        Bzzt_Sim_Apply_Command(e->world, type);
+}
+
 static void destroy_current_world(Engine *e)
 {
     if (!e || !e->world)
         return;
 
+    stop_simulation(e);
     Bzzt_World_Destroy(e->world);
     e->world = NULL;
+
+    if (e->sim_ui)
+    {
+        UI_Destroy(e->sim_ui);
+        e->sim_ui = NULL;
+    }
 }
 
 static void reset_file_browser_scroll(Engine *e)
@@ -105,6 +183,27 @@ static void bind_file_browser_ui(Engine *e)
     }
 }
 
+// Preload the world under the cursor and show what is known about it in the status line
+static void update_world_preload(Engine *e)
+{
+    char path[BZZT_MAX_PATH_LENGTH];
+    char member[BZZT_MAX_PATH_LENGTH];
+    bool is_world = FileBrowser_GetSelectedWorld(e->file_browser, path, sizeof(path), member, sizeof(member));
+    Bzzt_World_Preload_Update(e->preload, is_world ? path : NULL, member, GetFrameTime() * 1000.0);
+
+    Bzzt_World_Preview preview;
+    if (!is_world || !Bzzt_World_Preload_Preview(e->preload, path, member, &preview))
+    {
+        FileBrowser_SetPreview(e->file_browser, NULL);
+        return;
+    }
+
+    char text[128];
+    snprintf(text, sizeof(text), "%s: %d boards, %zu KB. Enter to play.", preview.title[0] ? preview.title : "Untitled",
+             preview.board_count, (preview.size + 1023) / 1024);
+    FileBrowser_SetPreview(e->file_browser, text);
+}
+
 static void load_splash_screen(UI *ui, UIActionRegistry *registry);
 
 static bool title_mode_from_loaded_world(Engine *e)
@@ -201,7 +300,10 @@ static void close_file_browser(Engine *e)
         return;
 
     e->file_browser_active = false;
+    FileBrowser_CancelScan(e->file_browser); // Reopening lists the directory again
     FileBrowser_ClearStatus(e->file_browser);
+    FileBrowser_SetPreview(e->file_browser, NULL);
+    Bzzt_World_Preload_Clear(e->preload);
     reset_file_browser_scroll(e);
 
     if (e->ui)
@@ -220,7 +322,7 @@ static void btn_press_pause(UIActionContext *ctx)
     if (!ctx)
         return;
 
-    Bzzt_World_Set_Pause(ctx->engine->world, true);
+    send_world_command(ctx->engine, BZZT_SIM_CMD_PAUSE);
 }
 
 // Pressing p at zzt title screen
@@ -241,12 +343,19 @@ static void btn_title_press_play(UIActionContext *ctx)
     UIOverlay_Set_Visible(ui_ctx->play_mode.overlay_play_screen_display, true);
 
     Input_Clear_Movement(ctx->engine->input);
+}
+
+// Move the player onto the start board, paused, once the world is no longer ticking
+static void enter_play_mode(Engine *e)
+{
+    if (!e || !e->world || !e->world->start_board)
+        return;
 
-    Bzzt_World *world = ctx->engine->world;
+    Bzzt_World *world = e->world;
     Bzzt_Board *start_board = world->start_board;
     Bzzt_Stat *player = start_board->stats[0];
     int idx = start_board->idx;
-    Bzzt_World_Switch_Board_To(ctx->engine->world, idx, player->x, player->y);
+    Bzzt_World_Switch_Board_To(world, idx, player->x, player->y);
     Bzzt_World_Set_Pause(world, true);
 }
 
@@ -366,8 +475,8 @@ static void register_ui_actions(Engine *e)
 
 static const char *format_keys_display(void *ud)
 {
-    Bzzt_World *world = (Bzzt_World *)ud;
-    if (!world)
+    Bzzt_Render_Counters *hud = (Bzzt_Render_Counters *)ud;
+    if (!hud)
         return "";
 
     char *buf = keys_display_buffer;
@@ -391,7 +500,7 @@ static const char *format_keys_display(void *ud)
 
     for (int i = 0; i < 7; i++)
     {
-        if (world->keys[i])
+        if (hud->keys[i])
         {
             // Show this key with its color
             written += sprintf(buf + written, "%s\\c12",
@@ -407,29 +516,29 @@ static bool bind_world_stats_to_ui(Engine *e)
     if (!e || !e->world || !e->ui)
         return false;
 
-    Bzzt_World *world = e->world;
+    Bzzt_Render_Counters *hud = &e->hud;
     UI *ui = e->ui;
 
     UIElement_Text *health_text = (UIElement_Text *)UIElement_Find_By_Name(ui, "health");
     if (health_text)
-        UIText_Rebind_To_Data(health_text, &world->health, "\\c002  \\f14Health:%d", BIND_INT16);
+        UIText_Rebind_To_Data(health_text, &hud->health, "\\c002  \\f14Health:%d", BIND_INT16);
 
     UIElement_Text *ammo_text = (UIElement_Text *)UIElement_Find_By_Name(ui, "ammo");
     if (ammo_text)
-        UIText_Rebind_To_Data(ammo_text, &world->ammo, "\\f11\\c132    \\f14Ammo:%d", BIND_INT16);
+        UIText_Rebind_To_Data(ammo_text, &hud->ammo, "\\f11\\c132    \\f14Ammo:%d", BIND_INT16);
 
     UIElement_Text *torches_text = (UIElement_Text *)UIElement_Find_By_Name(ui, "torches");
     if (torches_text)
-        UIText_Rebind_To_Data(torches_text, &world->torches, "\\f6\\c157 \\f14Torches:%d", BIND_INT16);
+        UIText_Rebind_To_Data(torches_text, &hud->torches, "\\f6\\c157 \\f14Torches:%d", BIND_INT16);
 
     UIElement_Text *gems_text = (UIElement_Text *)UIElement_Find_By_Name(ui, "gems");
     if (gems_text)
-        UIText_Rebind_To_Data(gems_text, &world->gems, "\\f11\\c004    \\f14Gems:%d", BIND_INT16);
+        UIText_Rebind_To_Data(gems_text, &hud->gems, "\\f11\\c004    \\f14Gems:%d", BIND_INT16);
 
     UIElement_Text *score_text = (UIElement_Text *)UIElement_Find_By_Name(ui, "score");
     if (score_text)
     {
-        UIText_Rebind_To_Data(score_text, &world->score, "\\f14Score:%d", BIND_INT16);
+        UIText_Rebind_To_Data(score_text, &hud->score, "\\f14Score:%d", BIND_INT16);
     }
 
     UIElement_Text *keys_text = (UIElement_Text *)UIElement_Find_By_Name(ui, "keys");
@@ -438,7 +547,7 @@ static bool bind_world_stats_to_ui(Engine *e)
         if (keys_text->owns_ud && keys_text->ud)
             free(keys_text->ud);
         keys_text->textCallback = format_keys_display;
-        keys_text->ud = world;
+        keys_text->ud = hud;
         keys_text->owns_ud = false;
     }
 
@@ -482,69 +591,23 @@ static void init_camera(Engine *e)
     e->camera->cell_height = 32;
 }
 
+// Bring up the title screen of the world a finished load handed over
 static bool zzt_title_init(Engine *e)
 {
-    Bzzt_World *world = NULL;
-    char file[sizeof(e->world_to_load)] = {0};
-    snprintf(file, sizeof(file), "%s", e->world_to_load[0] ? e->world_to_load : ZZT_FILE);
-
-    if (e->world_to_load_from_zip)
-    {
-        FILE *stream = NULL;
-        char error[192] = {0};
-        char display_name[BZZT_MAX_PATH_LENGTH] = {0};
-
-        if (!ZipArchive_Extract_World_To_Stream(e->world_to_load,
-                                                e->world_to_load_member,
-                                                &stream,
-                                                error,
-                                                sizeof(error)))
-        {
-            Debug_Printf(LOG_ENGINE,
-                         "Error extracting zipped ZZT world %s!/%s: %s",
-                         e->world_to_load,
-                         e->world_to_load_member,
-                         error);
-            FileBrowser_ClearPendingLocation(e->file_browser);
-            clear_pending_world_load(e);
-            return false;
-        }
-
-        size_t written = 0;
-        size_t outer_len = strnlen(e->world_to_load, sizeof(display_name) - 1);
-        memcpy(display_name, e->world_to_load, outer_len);
-        written = outer_len;
-        if (written < sizeof(display_name) - 1)
-            display_name[written++] = '!';
-        if (written < sizeof(display_name) - 1)
-            display_name[written++] = '/';
-        size_t remaining = sizeof(display_name) - written - 1;
-        if (remaining > 0)
-        {
-            size_t member_len = strnlen(e->world_to_load_member, remaining);
-            memcpy(display_name + written, e->world_to_load_member, member_len);
-            written += member_len;
-        }
-        display_name[written] = '\0';
-        world = Bzzt_World_From_ZZT_Stream(stream, display_name);
-        fclose(stream);
-    }
-    else
-    {
-        world = Bzzt_World_From_ZZT_World(file);
-    }
-
-    clear_pending_world_load(e);
+    Bzzt_World *world = e->loaded_world;
+    e->loaded_world = NULL;
     if (!world)
     {
-        Debug_Printf(LOG_ENGINE, "Error loading ZZT world %s", file);
         FileBrowser_ClearPendingLocation(e->file_browser);
         return false;
     }
 
     UI *ui = UI_Create(true, true);
-    if (!ui)
+    UI *sim_ui = UI_Create_Headless();
+    if (!ui || !sim_ui)
     {
+        UI_Destroy(ui);
+        UI_Destroy(sim_ui);
         Bzzt_World_Destroy(world);
         FileBrowser_ClearPendingLocation(e->file_browser);
         return false;
@@ -553,6 +616,7 @@ static bool zzt_title_init(Engine *e)
     if (!UI_Load_From_BUI(ui, PLAY_SIDEBAR_BUI))
     {
         UI_Destroy(ui);
+        UI_Destroy(sim_ui);
         Bzzt_World_Destroy(world);
         FileBrowser_ClearPendingLocation(e->file_browser);
         return false;
@@ -566,6 +630,9 @@ static bool zzt_title_init(Engine *e)
     destroy_current_world(e);
 
     e->world = world;
+    if (!Bzzt_World_Set_Prefetch(world, true))
+        Debug_Log(LOG_LEVEL_WARN, LOG_ENGINE, "Board prefetch is off; board switches may stall.");
+    e->sim_ui = sim_ui;
     e->ui = ui;
     e->file_browser_active = false;
     Input_Clear_Movement(e->input);
@@ -582,6 +649,51 @@ static bool zzt_title_init(Engine *e)
     return true;
 }
 
+// Hand the world picked in the file browser to a background loader, unless a preload already did
+static bool start_world_load(Engine *e)
+{
+    const char *path = e->world_to_load[0] ? e->world_to_load : ZZT_FILE;
+    if (!e->loader)
+        e->loader = Bzzt_World_Loader_Start(path, e->world_to_load_from_zip ? e->world_to_load_member : NULL);
+    clear_pending_world_load(e);
+    if (!e->loader)
+        return false;
+
+    FileBrowser_SetStatus(e->file_browser, "Loading... Esc cancels.");
+    return true;
+}
+
+static void return_to_file_browser(Engine *e, const char *status)
+{
+    e->state = ENGINE_STATE_MENU;
+    e->file_browser_active = true;
+    reset_file_browser_scroll(e);
+    FileBrowser_ClearPendingLocation(e->file_browser);
+    FileBrowser_SetStatus(e->file_browser, status);
+}
+
+// Move on to the title screen once the loader is done; the status line set when it started stays up until then
+static void update_world_load(Engine *e, InputState *in)
+{
+    if (in->ESC_pressed)
+        Bzzt_World_Loader_Cancel(e->loader);
+
+    if (!Bzzt_World_Loader_Poll(e->loader))
+        return;
+
+    char error[192] = {0};
+    e->loaded_world = Bzzt_World_Loader_Finish(e->loader, error, sizeof(error));
+    e->loader = NULL;
+    if (!e->loaded_world)
+    {
+        return_to_file_browser(e, error);
+        return;
+    }
+
+    FileBrowser_ClearStatus(e->file_browser);
+    Engine_Set_State(e, ENGINE_STATE_TITLE);
+}
+
 static void load_splash_screen(UI *ui, UIActionRegistry *registry)
 {
     if (!ui)
@@ -612,6 +724,9 @@ static void apply_state_change(Engine *e)
     EngineState next = e->pending_state;
     e->state = next;
 
+    // Transitions mutate the world directly, so take it back from the simulation first
+    stop_simulation(e);
+
     switch (next)
     {
     case ENGINE_STATE_MENU:
@@ -656,39 +771,39 @@ static void apply_state_change(Engine *e)
             Editor_Destroy(e->editor);
             e->editor = NULL;
         }
-        if (e->world && !e->world_to_load[0] && !e->world_to_load_from_zip)
+        if (e->loaded_world)
         {
-            if (!title_mode_from_loaded_world(e))
-            {
-                e->state = ENGINE_STATE_MENU;
-                e->file_browser_active = true;
-                reset_file_browser_scroll(e);
-                FileBrowser_SetStatus(e->file_browser, "Failed to return to title screen.");
-            }
+            if (!zzt_title_init(e))
+                return_to_file_browser(e, "Failed to load selected .zzt world.");
         }
-        else if (!zzt_title_init(e))
+        else if (!title_mode_from_loaded_world(e))
         {
-            e->state = ENGINE_STATE_MENU;
-            e->file_browser_active = true;
-            reset_file_browser_scroll(e);
-            FileBrowser_SetStatus(e->file_browser, "Failed to load selected .zzt world.");
+            return_to_file_browser(e, "Failed to return to title screen.");
         }
         break;
+    case ENGINE_STATE_LOADING:
+        if (!start_world_load(e))
+            return_to_file_browser(e, "Failed to load selected .zzt world.");
+        break;
     case ENGINE_STATE_PLAY:
+        enter_play_mode(e);
+        break;
     case ENGINE_STATE__COUNT:
         break;
     }
+
+    if (e->state == ENGINE_STATE_TITLE || e->state == ENGINE_STATE_PLAY)
+        start_simulation(e);
 }
 
 static void sync_ui_to_world_state(Engine *e)
 {
-    if (!e || !e->world || !e->ui_ctx)
+    if (!e || !e->view || !e->ui_ctx)
         return;
 
-    Bzzt_World *world = e->world;
     UIContext *ui_ctx = e->ui_ctx;
 
-    if (e->state == ENGINE_STATE_PLAY && world->paused)
+    if (e->state == ENGINE_STATE_PLAY && e->view->paused)
     {
         if (!ui_ctx->play_mode.pausing_text->base.properties.enabled)
         {
@@ -725,6 +840,11 @@ bool Engine_Init(Engine *e, InputState *in)
     Debug_Printf(LOG_ENGINE, "Initializing bzzt engine.");
 
     e->world = NULL;
+    e->sim_ui = NULL;
+    e->sim = NULL;
+    e->view = NULL;
+    memset(&e->local_view, 0, sizeof(e->local_view));
+    memset(&e->hud, 0, sizeof(e->hud));
     e->editor = NULL;
     e->running = true;
     e->debugShow = false;
@@ -736,8 +856,15 @@ bool Engine_Init(Engine *e, InputState *in)
     e->file_browser_open_requested = false;
     e->file_browser_scroll_direction = 0;
     e->file_browser_scroll_timer_ms = 0.0;
+    e->loader = NULL;
+    e->loaded_world = NULL;
+    e->preload = Bzzt_World_Preload_Create(BZZT_WORLD_PRELOAD_CAPACITY, BZZT_WORLD_PRELOAD_SETTLE_MS);
     clear_pending_world_load(e);
 
+    Bzzt_World_Cache_Configure(BZZT_WORLD_CACHE_DEFAULT_DIR, BZZT_WORLD_CACHE_DEFAULT_MAX_BYTES);
+    Bzzt_World_Cache_Trim(); // Clears out entries a different converter version left behind
+    Bzzt_Mem_Cache_Configure(BZZT_MEM_CACHE_DEFAULT_BUDGET);
+
     init_cursor(e);
 
     e->ui = UI_Create(true, true);
@@ -791,6 +918,8 @@ void Engine_Update(Engine *e, InputState *i, MouseState *m)
                 break;
             }
 
+            FileBrowser_Update(e->file_browser);
+
             if (IsKeyPressed(KEY_PAGE_UP))
             {
                 FileBrowser_MovePage(e->file_browser, -1);
@@ -856,12 +985,25 @@ void Engine_Update(Engine *e, InputState *i, MouseState *m)
                 if (result == FILE_BROWSER_ACTIVATE_SELECTED_WORLD)
                 {
                     FileBrowser_RememberPendingLocation(e->file_browser);
+                    FileBrowser_SetPreview(e->file_browser, NULL);
+                    e->loaded_world =
+                        Bzzt_World_Preload_Take(e->preload, selected_path, selected_member, &e->loader);
+                    Bzzt_World_Preload_Clear(e->preload); // The rest would only compete with the chosen world
+                    if (e->loaded_world)
+                    {
+                        Engine_Set_State(e, ENGINE_STATE_TITLE);
+                        break;
+                    }
+
                     snprintf(e->world_to_load, sizeof(e->world_to_load), "%s", selected_path);
                     snprintf(e->world_to_load_member, sizeof(e->world_to_load_member), "%s", selected_member);
                     e->world_to_load_from_zip = selected_member[0] != '\0';
-                    Engine_Set_State(e, ENGINE_STATE_TITLE);
+                    Engine_Set_State(e, ENGINE_STATE_LOADING);
                 }
             }
+
+            if (e->file_browser_active)
+                update_world_preload(e);
         }
         break;
 
@@ -871,10 +1013,27 @@ void Engine_Update(Engine *e, InputState *i, MouseState *m)
         {
             if (i->I_pressed)
             {
-                Bzzt_World_Toggle_Interpolation(e->world);
+                send_world_command(e, BZZT_SIM_CMD_TOGGLE_INTERPOLATION);
             }
+            if (i->TAB_pressed)
+            {
+                send_world_command(e, BZZT_SIM_CMD_CYCLE_TURBO);
+            }
+            if (i->F3_pressed)
+            {
+                send_world_command(e, BZZT_SIM_CMD_TOGGLE_TWO_PHASE);
+            }
+            if (i->F4_pressed)
+            {
+                send_world_command(e, BZZT_SIM_CMD_TOGGLE_PARALLEL);
+            }
+
+            if (e->sim)
+                Bzzt_Sim_Thread_Push_Input(e->sim, i);
+            else
+                Bzzt_World_Update(e->sim_ui, e->world, i);
 
-            Bzzt_World_Update(e, e->world, i);
+            refresh_world_view(e);
             sync_ui_to_world_state(e);
         }
         break;
@@ -883,6 +1042,11 @@ void Engine_Update(Engine *e, InputState *i, MouseState *m)
         Editor_Update(e, i);
         break;
 
+    case ENGINE_STATE_LOADING:
+        if (e->loader)
+            update_world_load(e, i);
+        break;
+
     default:
         break;
     }
@@ -909,8 +1073,22 @@ void Engine_Quit(Engine *e)
     if (e->ui)
         UI_Destroy(e->ui);
 
-    if (e->world)
-        Bzzt_World_Destroy(e->world);
+    if (e->loader)
+    {
+        Bzzt_World_Loader_Cancel(e->loader);
+        Bzzt_World_Destroy(Bzzt_World_Loader_Finish(e->loader, NULL, 0));
+        e->loader = NULL;
+    }
+    Bzzt_World_Preload_Destroy(e->preload);
+    e->preload = NULL;
+    if (e->loaded_world)
+    {
+        Bzzt_World_Destroy(e->loaded_world);
+        e->loaded_world = NULL;
+    }
+
+    destroy_current_world(e);
+    Bzzt_Render_Snapshot_Free(&e->local_view);
 
     if (e->action_registry)
         UIAction_Registry_Destroy(e->action_registry);
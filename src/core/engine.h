@@ -13,6 +13,7 @@
 #include "raylib.h"
 #include "color.h"
 #include "bz_char.h"
+#include "snapshot.h"
 
 typedef struct Bzzt_World Bzzt_World;
 typedef struct UI UI;
@@ -25,6 +26,9 @@ typedef struct UIOverlay UIOverlay;
 typedef struct UIElement UIElement;
 typedef struct UIElement_Text UIElement_Text;
 typedef struct FileBrowser FileBrowser;
+typedef struct Bzzt_Sim_Thread Bzzt_Sim_Thread;
+typedef struct Bzzt_World_Loader Bzzt_World_Loader;
+typedef struct Bzzt_World_Preload Bzzt_World_Preload;
 
 typedef enum EngineState
 {
@@ -32,6 +36,7 @@ typedef enum EngineState
     ENGINE_STATE_TITLE, // At title screen board of a zzt world
     ENGINE_STATE_PLAY,  // Playing a zzt world
     ENGINE_STATE_EDIT,  // Using the editor
+    ENGINE_STATE_LOADING, // Loading a world in the background; the file browser shows progress
     ENGINE_STATE__COUNT
 } EngineState;
 
@@ -94,6 +99,11 @@ typedef struct Engine
     UI *ui;
     Editor *editor;
     Bzzt_World *world;
+    UI *sim_ui;                       // Headless UI the simulation flashes messages into; mirrored onto ui
+    Bzzt_Sim_Thread *sim;             // Owns the world while ticks run off the main thread
+    const Bzzt_Render_Snapshot *view; // What the renderer draws for the current world
+    Bzzt_Render_Snapshot local_view;  // Captured each frame when ticking on the main thread
+    Bzzt_Render_Counters hud;         // Sidebar counters, refreshed from the view each frame
     Font font;
     Cursor *cursor;
     InputState *input;
@@ -110,6 +120,9 @@ typedef struct Engine
     char world_to_load[1024];
     char world_to_load_member[1024];
     bool world_to_load_from_zip;
+    Bzzt_World_Loader *loader; // Set while in ENGINE_STATE_LOADING
+    Bzzt_World *loaded_world;  // A finished load, waiting for the title screen to take it
+    Bzzt_World_Preload *preload; // Worlds loaded ahead of time from the file browser selection
 
     bool running;
     bool firstBoot;
@@ -1,7 +1,13 @@
+#if defined(__linux__)
+#define _DEFAULT_SOURCE // d_type in struct dirent
+#endif
+
 #include "file_browser.h"
 
 #include <dirent.h>
+#include <errno.h>
 #include <limits.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -22,6 +28,7 @@
 #define FILE_BROWSER_DISPLAY_PATH_MAX 2048
 #define FILE_BROWSER_DEFAULT_VISIBLE_ROWS 11
 #define FILE_BROWSER_MAX_ZIP_DEPTH 8
+#define FILE_BROWSER_SCAN_BATCH 64
 
 typedef enum FileBrowserMode
 {
@@ -43,16 +50,35 @@ typedef struct FileBrowserEntry
 {
     char *name;
     char *path;
+    char *row; // The name as drawn in the list, formatted the first time it scrolls into view
     FileBrowserEntryType type;
 } FileBrowserEntry;
 
+/* A directory listing read on its own thread. The worker hands entries over
+ * in batches through pending, and FileBrowser_Update merges them into the
+ * list. The thread is detached rather than joined, since a readdir on a slow
+ * mount can take seconds; whichever of the browser and the worker lets go
+ * last frees the scan. */
+typedef struct FileBrowserScan
+{
+    DIR *dir;
+    char dir_path[PATH_MAX]; // For stat() where there is no fstatat
+    pthread_mutex_t lock;
+    FileBrowserEntry *pending; // Read but not yet merged into the list
+    int pending_count;
+    int pending_cap;
+    bool finished;
+    bool failed; // Some entries could not be read
+    int cancel;
+    int refs;
+} FileBrowserScan;
+
 typedef struct FileBrowserZipContext
 {
     char archive_path[PATH_MAX];
     char display_root[FILE_BROWSER_DISPLAY_PATH_MAX];
     char member_from_parent[PATH_MAX];
     char zip_dir[PATH_MAX];
-    bool owns_temp_archive;
     struct FileBrowserZipContext *parent;
 } FileBrowserZipContext;
 
@@ -78,7 +104,14 @@ struct FileBrowser
     int scroll_offset;
     int visible_rows;
     char status[FILE_BROWSER_STATUS_MAX];
+    char preview[FILE_BROWSER_STATUS_MAX]; // Shown in the status line while there is no status
+    char scan_status[FILE_BROWSER_STATUS_MAX];
+    FileBrowserScan *scan; // The listing is still being read while set
     char list_buffer[FILE_BROWSER_LIST_BUFFER_MAX];
+    bool list_valid; // list_buffer still shows list_start/list_selected/list_rows of the current entries
+    int list_start;
+    int list_selected;
+    int list_rows;
     char path_buffer[FILE_BROWSER_PATH_BUFFER_MAX];
     FileBrowserSavedLocation saved_location;
     FileBrowserSavedLocation pending_location;
@@ -131,17 +164,51 @@ static FileBrowserZipContext *file_browser_current_zip(FileBrowser *browser)
     return browser->zip_context;
 }
 
+static void file_browser_release_scan(FileBrowserScan *scan)
+{
+    if (__atomic_sub_fetch(&scan->refs, 1, __ATOMIC_ACQ_REL) != 0)
+        return;
+
+    for (int i = 0; i < scan->pending_count; ++i)
+    {
+        free(scan->pending[i].name);
+        free(scan->pending[i].path);
+    }
+    free(scan->pending); // Pending entries are never drawn, so they have no row yet
+    pthread_mutex_destroy(&scan->lock);
+    free(scan);
+}
+
+// Stop reading the current directory; whatever the worker still hands over is dropped
+static void file_browser_cancel_scan(FileBrowser *browser)
+{
+    if (!browser || !browser->scan)
+        return;
+
+    __atomic_store_n(&browser->scan->cancel, 1, __ATOMIC_RELAXED);
+    file_browser_release_scan(browser->scan);
+    browser->scan = NULL;
+}
+
 static void file_browser_free_entries(FileBrowser *browser)
 {
-    if (!browser || !browser->entries)
+    if (!browser)
+        return;
+
+    // Any scan in progress is filling the list being thrown away
+    file_browser_cancel_scan(browser);
+    browser->list_valid = false;
+    if (!browser->entries)
         return;
 
     for (int i = 0; i < browser->entries_count; ++i)
     {
         free(browser->entries[i].name);
         free(browser->entries[i].path);
+        free(browser->entries[i].row);
         browser->entries[i].name = NULL;
         browser->entries[i].path = NULL;
+        browser->entries[i].row = NULL;
     }
 
     free(browser->entries);
@@ -159,8 +226,6 @@ static void file_browser_clear_zip_contexts(FileBrowser *browser)
     while (ctx)
     {
         FileBrowserZipContext *parent = ctx->parent;
-        if (ctx->owns_temp_archive)
-            unlink(ctx->archive_path);
         free(ctx);
         ctx = parent;
     }
@@ -213,8 +278,10 @@ static bool file_browser_add_entry(FileBrowser *browser,
         return false;
     }
 
+    entry->row = NULL;
     entry->type = type;
     browser->entries_count++;
+    browser->list_valid = false;
     return true;
 }
 
@@ -345,26 +412,36 @@ static bool file_browser_parent_zip_dir(const char *dir, char *out_dir, size_t o
     return true;
 }
 
-static bool file_browser_path_is_directory(const char *path)
+static bool file_browser_entry_is_directory(const FileBrowserScan *scan, const struct dirent *entry)
 {
-    if (!path)
+#if defined(DT_DIR) && defined(DT_REG)
+    // Most filesystems say what the entry is; only links and the unsure need a stat
+    if (entry->d_type == DT_DIR)
+        return true;
+    if (entry->d_type == DT_REG)
         return false;
+#endif
 
     struct stat st = {0};
-    if (stat(path, &st) != 0)
+#if !defined(_WIN32)
+    if (fstatat(dirfd(scan->dir), entry->d_name, &st, 0) != 0)
+        return false;
+#else
+    char full_path[PATH_MAX] = {0};
+    if (!file_browser_join_path(full_path, sizeof(full_path), scan->dir_path, entry->d_name) ||
+        stat(full_path, &st) != 0)
         return false;
+#endif
 
     return S_ISDIR(st.st_mode);
 }
 
-static FileBrowserEntryType file_browser_entry_type(const char *dir, const struct dirent *entry)
+static FileBrowserEntryType file_browser_entry_type(const FileBrowserScan *scan, const struct dirent *entry)
 {
     const char *name = entry->d_name;
     const char *ext = strrchr(name, '.');
-    char full_path[PATH_MAX] = {0};
 
-    if (file_browser_join_path(full_path, sizeof(full_path), dir, name) &&
-        file_browser_path_is_directory(full_path))
+    if (file_browser_entry_is_directory(scan, entry))
         return FILE_BROWSER_ENTRY_DIRECTORY;
 
     if (!ext)
@@ -383,7 +460,6 @@ static FileBrowserEntryType file_browser_entry_type(const char *dir, const struc
 static bool file_browser_push_zip_context(FileBrowser *browser,
                                           const char *archive_path,
                                           const char *display_root,
-                                          bool owns_temp_archive,
                                           const char *member_from_parent)
 {
     if (!browser || !archive_path || !display_root)
@@ -408,7 +484,6 @@ static bool file_browser_push_zip_context(FileBrowser *browser,
         return false;
     }
 
-    ctx->owns_temp_archive = owns_temp_archive;
     ctx->parent = browser->zip_context;
     browser->zip_context = ctx;
     browser->mode = FILE_BROWSER_MODE_ZIP;
@@ -422,8 +497,6 @@ static bool file_browser_pop_zip_context(FileBrowser *browser)
 
     FileBrowserZipContext *ctx = browser->zip_context;
     browser->zip_context = ctx->parent;
-    if (ctx->owns_temp_archive)
-        unlink(ctx->archive_path);
     free(ctx);
 
     browser->mode = browser->zip_context ? FILE_BROWSER_MODE_ZIP : FILE_BROWSER_MODE_FILESYSTEM;
@@ -439,14 +512,14 @@ static bool file_browser_enter_nested_zip(FileBrowser *browser, const FileBrowse
     if (!ctx)
         return false;
 
-    char temp_path[PATH_MAX] = {0};
+    char nested_path[PATH_MAX] = {0};
     char error[FILE_BROWSER_STATUS_MAX] = {0};
-    if (!ZipArchive_Extract_Member_To_Temp_File(ctx->archive_path,
-                                                entry->path,
-                                                temp_path,
-                                                sizeof(temp_path),
-                                                error,
-                                                sizeof(error)))
+    if (!ZipArchive_Open_Nested(ctx->archive_path,
+                                entry->path,
+                                nested_path,
+                                sizeof(nested_path),
+                                error,
+                                sizeof(error)))
     {
         FileBrowser_SetStatus(browser, error[0] ? error : "Unable to open nested zip archive.");
         return false;
@@ -456,14 +529,12 @@ static bool file_browser_enter_nested_zip(FileBrowser *browser, const FileBrowse
     if (snprintf(display_root, sizeof(display_root), "%s!/%s", ctx->display_root, entry->path) >=
         (int)sizeof(display_root))
     {
-        unlink(temp_path);
         FileBrowser_SetStatus(browser, "Nested zip path is too long.");
         return false;
     }
 
-    if (!file_browser_push_zip_context(browser, temp_path, display_root, true, entry->path))
+    if (!file_browser_push_zip_context(browser, nested_path, display_root, entry->path))
     {
-        unlink(temp_path);
         FileBrowser_SetStatus(browser, "Out of memory while opening nested zip.");
         return false;
     }
@@ -539,7 +610,6 @@ static bool file_browser_restore_saved_location(FileBrowser *browser,
     if (!file_browser_push_zip_context(browser,
                                        location->top_archive_path,
                                        location->top_archive_path,
-                                       false,
                                        NULL))
     {
         file_browser_clear_zip_contexts(browser);
@@ -559,14 +629,14 @@ static bool file_browser_restore_saved_location(FileBrowser *browser,
             return false;
         }
 
-        char temp_path[PATH_MAX] = {0};
+        char nested_path[PATH_MAX] = {0};
         char error[FILE_BROWSER_STATUS_MAX] = {0};
-        if (!ZipArchive_Extract_Member_To_Temp_File(parent->archive_path,
-                                                    location->zip_members[level - 1],
-                                                    temp_path,
-                                                    sizeof(temp_path),
-                                                    error,
-                                                    sizeof(error)))
+        if (!ZipArchive_Open_Nested(parent->archive_path,
+                                    location->zip_members[level - 1],
+                                    nested_path,
+                                    sizeof(nested_path),
+                                    error,
+                                    sizeof(error)))
         {
             file_browser_clear_zip_contexts(browser);
             return false;
@@ -580,12 +650,10 @@ static bool file_browser_restore_saved_location(FileBrowser *browser,
                                  location->zip_members[level - 1]);
 
         if (!file_browser_push_zip_context(browser,
-                                           temp_path,
+                                           nested_path,
                                            display_root,
-                                           true,
                                            location->zip_members[level - 1]))
         {
-            unlink(temp_path);
             file_browser_clear_zip_contexts(browser);
             return false;
         }
@@ -605,6 +673,194 @@ static bool file_browser_restore_saved_location(FileBrowser *browser,
     return true;
 }
 
+// Hand entries from the worker's batch to the browser; false if it could not take them
+static bool file_browser_scan_flush(FileBrowserScan *scan, FileBrowserEntry *batch, int *batch_count)
+{
+    bool ok = true;
+    pthread_mutex_lock(&scan->lock);
+    if (scan->pending_count + *batch_count > scan->pending_cap)
+    {
+        int new_cap = scan->pending_cap == 0 ? FILE_BROWSER_SCAN_BATCH * 4 : scan->pending_cap * 2;
+        while (new_cap < scan->pending_count + *batch_count)
+            new_cap *= 2;
+
+        FileBrowserEntry *grown = realloc(scan->pending, sizeof(FileBrowserEntry) * (size_t)new_cap);
+        if (grown)
+        {
+            scan->pending = grown;
+            scan->pending_cap = new_cap;
+        }
+        else
+            ok = false;
+    }
+
+    if (ok)
+    {
+        memcpy(scan->pending + scan->pending_count, batch, sizeof(FileBrowserEntry) * (size_t)*batch_count);
+        scan->pending_count += *batch_count;
+    }
+    pthread_mutex_unlock(&scan->lock);
+
+    if (!ok)
+    {
+        for (int i = 0; i < *batch_count; ++i)
+        {
+            free(batch[i].name);
+            free(batch[i].path);
+        }
+    }
+    *batch_count = 0;
+    return ok;
+}
+
+static void *file_browser_scan_main(void *arg)
+{
+    FileBrowserScan *scan = (FileBrowserScan *)arg;
+    FileBrowserEntry batch[FILE_BROWSER_SCAN_BATCH];
+    int batch_count = 0;
+    bool failed = false;
+
+    while (!__atomic_load_n(&scan->cancel, __ATOMIC_RELAXED))
+    {
+        errno = 0;
+        struct dirent *entry = readdir(scan->dir);
+        if (!entry)
+        {
+            failed |= errno != 0;
+            break;
+        }
+
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            continue;
+
+        FileBrowserEntry *scanned = &batch[batch_count];
+        scanned->type = file_browser_entry_type(scan, entry);
+        scanned->row = NULL;
+        scanned->name = strdup(entry->d_name);
+        scanned->path = strdup(entry->d_name);
+        if (!scanned->name || !scanned->path)
+        {
+            free(scanned->name);
+            free(scanned->path);
+            failed = true;
+            break;
+        }
+
+        if (++batch_count == FILE_BROWSER_SCAN_BATCH && !file_browser_scan_flush(scan, batch, &batch_count))
+        {
+            failed = true;
+            break;
+        }
+    }
+
+    if (batch_count > 0 && !file_browser_scan_flush(scan, batch, &batch_count))
+        failed = true;
+    closedir(scan->dir);
+
+    pthread_mutex_lock(&scan->lock);
+    scan->failed = failed;
+    scan->finished = true;
+    pthread_mutex_unlock(&scan->lock);
+
+    file_browser_release_scan(scan);
+    return NULL;
+}
+
+// Read the rest of dp, opened from dir_path, on a worker thread, which takes over closing it
+static FileBrowserScan *file_browser_start_scan(DIR *dp, const char *dir_path)
+{
+    FileBrowserScan *scan = calloc(1, sizeof(FileBrowserScan));
+    if (!scan)
+        return NULL;
+
+    if (pthread_mutex_init(&scan->lock, NULL) != 0)
+    {
+        free(scan);
+        return NULL;
+    }
+
+    scan->dir = dp;
+    snprintf(scan->dir_path, sizeof(scan->dir_path), "%s", dir_path);
+    scan->refs = 2; // The browser's and the worker's
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, file_browser_scan_main, scan) == 0)
+        pthread_detach(thread);
+    else
+        file_browser_scan_main(scan); // No thread to spare; read it here instead
+
+    return scan;
+}
+
+// Merge whatever the worker has read into the sorted list, keeping the selected entry selected
+static void file_browser_merge_scanned(FileBrowser *browser)
+{
+    FileBrowserScan *scan = browser->scan;
+    if (!scan)
+        return;
+
+    pthread_mutex_lock(&scan->lock);
+    FileBrowserEntry *batch = scan->pending;
+    int batch_count = scan->pending_count;
+    bool finished = scan->finished;
+    bool failed = scan->failed;
+    scan->pending = NULL;
+    scan->pending_count = 0;
+    scan->pending_cap = 0;
+    pthread_mutex_unlock(&scan->lock);
+
+    if (batch_count > 0 && !file_browser_reserve(browser, browser->entries_count + batch_count))
+    {
+        for (int i = 0; i < batch_count; ++i)
+        {
+            free(batch[i].name);
+            free(batch[i].path);
+        }
+        batch_count = 0;
+        failed = true;
+    }
+
+    if (batch_count > 0)
+    {
+        qsort(batch, (size_t)batch_count, sizeof(FileBrowserEntry), file_browser_compare_entries);
+
+        // Merge from the back so the list can be merged in place. Entry 0 is always ../
+        int selected = browser->selected_index;
+        int i = browser->entries_count - 1;
+        int j = batch_count - 1;
+        int k = browser->entries_count + batch_count - 1;
+        while (j >= 0)
+        {
+            if (i >= 1 && file_browser_compare_entries(&browser->entries[i], &batch[j]) > 0)
+            {
+                if (i == browser->selected_index)
+                    selected = k;
+                browser->entries[k--] = browser->entries[i--];
+            }
+            else
+                browser->entries[k--] = batch[j--];
+        }
+        browser->entries_count += batch_count;
+        browser->list_valid = false;
+
+        // Shift the view with the selection so the list doesn't jump under the cursor
+        browser->scroll_offset += selected - browser->selected_index;
+        browser->selected_index = selected;
+        file_browser_adjust_scroll(browser);
+    }
+    free(batch);
+
+    if (finished)
+    {
+        file_browser_release_scan(scan);
+        browser->scan = NULL;
+        if (failed)
+            FileBrowser_SetStatus(browser, "Some entries in this directory could not be read.");
+    }
+    else if (failed)
+        FileBrowser_SetStatus(browser, "Out of memory while reading that directory.");
+}
+
 static bool file_browser_scan_filesystem(FileBrowser *browser, const char *dir)
 {
     if (!browser || !dir)
@@ -633,35 +889,21 @@ static bool file_browser_scan_filesystem(FileBrowser *browser, const char *dir)
         return false;
     }
 
-    struct dirent *entry = NULL;
-    while ((entry = readdir(dp)) != NULL)
+    // The rest of the listing arrives through FileBrowser_Update
+    browser->scan = file_browser_start_scan(dp, resolved_dir);
+    if (!browser->scan)
     {
-        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
-            continue;
-
-        FileBrowserEntryType type = file_browser_entry_type(resolved_dir, entry);
-        if (!file_browser_add_entry(browser, entry->d_name, entry->d_name, type))
-        {
-            closedir(dp);
-            return false;
-        }
-    }
-
-    closedir(dp);
-
-    if (browser->entries_count > 1)
-    {
-        qsort(browser->entries + 1,
-              (size_t)(browser->entries_count - 1),
-              sizeof(FileBrowserEntry),
-              file_browser_compare_entries);
+        closedir(dp);
+        FileBrowser_SetStatus(browser, "Out of memory while reading that directory.");
     }
 
     browser->mode = FILE_BROWSER_MODE_FILESYSTEM;
     snprintf(browser->current_dir, sizeof(browser->current_dir), "%s", resolved_dir);
     browser->selected_index = 0;
     browser->scroll_offset = 0;
-    FileBrowser_ClearStatus(browser);
+    if (browser->scan)
+        FileBrowser_ClearStatus(browser);
+    file_browser_merge_scanned(browser);
     return true;
 }
 
@@ -784,6 +1026,19 @@ static void file_browser_format_name(char *dst,
     dst[written] = '\0';
 }
 
+// The entry's row text, formatted on first use and kept until the listing changes
+static const char *file_browser_entry_row(FileBrowserEntry *entry)
+{
+    if (!entry->row)
+    {
+        char name[192] = {0};
+        file_browser_format_name(name, sizeof(name), entry, 48);
+        entry->row = strdup(name);
+    }
+
+    return entry->row ? entry->row : "";
+}
+
 FileBrowser *FileBrowser_Create(void)
 {
     FileBrowser *browser = calloc(1, sizeof(FileBrowser));
@@ -804,6 +1059,7 @@ void FileBrowser_Destroy(FileBrowser *browser)
 
     file_browser_free_entries(browser);
     file_browser_clear_zip_contexts(browser);
+    ZipArchive_Clear_Caches();
     free(browser);
 }
 
@@ -818,6 +1074,20 @@ bool FileBrowser_Open(FileBrowser *browser, const char *start_dir)
     return file_browser_scan_filesystem(browser, start_dir);
 }
 
+bool FileBrowser_Update(FileBrowser *browser)
+{
+    if (!browser)
+        return false;
+
+    file_browser_merge_scanned(browser);
+    return browser->scan != NULL;
+}
+
+void FileBrowser_CancelScan(FileBrowser *browser)
+{
+    file_browser_cancel_scan(browser);
+}
+
 bool FileBrowser_MoveSelection(FileBrowser *browser, int delta)
 {
     if (!browser || browser->entries_count <= 0 || delta == 0)
@@ -870,6 +1140,14 @@ void FileBrowser_SetStatus(FileBrowser *browser, const char *status)
     snprintf(browser->status, sizeof(browser->status), "%s", status);
 }
 
+void FileBrowser_SetPreview(FileBrowser *browser, const char *preview)
+{
+    if (!browser)
+        return;
+
+    file_browser_copy_text(browser->preview, sizeof(browser->preview), preview);
+}
+
 void FileBrowser_ClearStatus(FileBrowser *browser)
 {
     FileBrowser_SetStatus(browser, NULL);
@@ -1028,7 +1306,7 @@ FileBrowserActivateResult FileBrowser_Activate(FileBrowser *browser,
             return FILE_BROWSER_ACTIVATE_NONE;
         }
 
-        if (!file_browser_push_zip_context(browser, path, display_root, false, NULL))
+        if (!file_browser_push_zip_context(browser, path, display_root, NULL))
         {
             FileBrowser_SetStatus(browser, "Out of memory while opening zip.");
             return FILE_BROWSER_ACTIVATE_NONE;
@@ -1043,9 +1321,9 @@ FileBrowserActivateResult FileBrowser_Activate(FileBrowser *browser,
         return FILE_BROWSER_ACTIVATE_NAVIGATED;
     }
 
-    if (entry->type != FILE_BROWSER_ENTRY_ZZT)
+    if (entry->type != FILE_BROWSER_ENTRY_ZZT && entry->type != FILE_BROWSER_ENTRY_BZZT)
     {
-        FileBrowser_SetStatus(browser, "Only .zzt files can be opened right now.");
+        FileBrowser_SetStatus(browser, "Only .zzt and .bzzt files can be opened right now.");
         return FILE_BROWSER_ACTIVATE_NONE;
     }
 
@@ -1062,6 +1340,35 @@ FileBrowserActivateResult FileBrowser_Activate(FileBrowser *browser,
     return FILE_BROWSER_ACTIVATE_SELECTED_WORLD;
 }
 
+bool FileBrowser_GetSelectedWorld(const FileBrowser *browser,
+                                  char *out_path,
+                                  size_t out_path_size,
+                                  char *out_member_path,
+                                  size_t out_member_path_size)
+{
+    if (!browser || browser->entries_count <= 0 || !out_path || out_path_size == 0 || !out_member_path ||
+        out_member_path_size == 0)
+        return false;
+
+    const FileBrowserEntry *entry = &browser->entries[browser->selected_index];
+    out_member_path[0] = '\0';
+
+    if (browser->mode == FILE_BROWSER_MODE_ZIP)
+    {
+        const FileBrowserZipContext *ctx = browser->zip_context;
+        if (!ctx || entry->type != FILE_BROWSER_ENTRY_ZZT)
+            return false;
+
+        return snprintf(out_path, out_path_size, "%s", ctx->archive_path) < (int)out_path_size &&
+               snprintf(out_member_path, out_member_path_size, "%s", entry->path) < (int)out_member_path_size;
+    }
+
+    if (entry->type != FILE_BROWSER_ENTRY_ZZT && entry->type != FILE_BROWSER_ENTRY_BZZT)
+        return false;
+
+    return file_browser_join_path(out_path, out_path_size, browser->current_dir, entry->path);
+}
+
 const char *FileBrowser_FormatDirectory(void *ud)
 {
     FileBrowser *browser = (FileBrowser *)ud;
@@ -1124,10 +1431,9 @@ const char *FileBrowser_FormatEntries(void *ud)
     if (!browser)
         return "";
 
-    browser->list_buffer[0] = '\0';
-
     if (browser->entries_count <= 0)
     {
+        browser->list_valid = false;
         snprintf(browser->list_buffer, sizeof(browser->list_buffer), "\\f8  (empty)");
         return browser->list_buffer;
     }
@@ -1137,34 +1443,34 @@ const char *FileBrowser_FormatEntries(void *ud)
     if (end > browser->entries_count)
         end = browser->entries_count;
 
+    // Redrawing an unchanged window reuses the text from last time
+    if (browser->list_valid && browser->list_start == start && browser->list_selected == browser->selected_index &&
+        browser->list_rows == browser->visible_rows)
+        return browser->list_buffer;
+
+    // Only the rows on screen are composed, so this costs the same however long the list is
+    size_t used = 0;
     for (int i = start; i < end; ++i)
     {
-        const FileBrowserEntry *entry = &browser->entries[i];
-        char line[256] = {0};
-        char name[192] = {0};
         const bool selected = i == browser->selected_index;
+        const char *pieces[3] = {selected ? "\\b1\\f15> " : "  ", file_browser_entry_row(&browser->entries[i]),
+                                 i < end - 1 ? "\n" : ""};
 
-        file_browser_format_name(name, sizeof(name), entry, 48);
-
-        snprintf(line,
-                 sizeof(line),
-                 "%s%s%s",
-                 selected ? "\\b1\\f15> " : "",
-                 selected ? "" : "  ",
-                 name);
-
-        strncat(browser->list_buffer,
-                line,
-                sizeof(browser->list_buffer) - strlen(browser->list_buffer) - 1);
-
-        if (i < end - 1)
+        for (int p = 0; p < 3; ++p)
         {
-            strncat(browser->list_buffer,
-                    "\n",
-                    sizeof(browser->list_buffer) - strlen(browser->list_buffer) - 1);
+            size_t len = strlen(pieces[p]);
+            if (len > sizeof(browser->list_buffer) - 1 - used)
+                len = sizeof(browser->list_buffer) - 1 - used;
+            memcpy(browser->list_buffer + used, pieces[p], len);
+            used += len;
         }
     }
+    browser->list_buffer[used] = '\0';
 
+    browser->list_valid = true;
+    browser->list_start = start;
+    browser->list_selected = browser->selected_index;
+    browser->list_rows = browser->visible_rows;
     return browser->list_buffer;
 }
 
@@ -1176,6 +1482,14 @@ const char *FileBrowser_FormatStatus(void *ud)
 
     if (browser->status[0] != '\0')
         return browser->status;
+    if (browser->preview[0] != '\0')
+        return browser->preview;
+    if (browser->scan)
+    {
+        snprintf(browser->scan_status, sizeof(browser->scan_status), "\\f8Scanning... %d entries so far.",
+                 browser->entries_count - 1);
+        return browser->scan_status;
+    }
 
     return "\\f8Directories are yellow. .zip files are light blue. Nested zips are browsable. Only .zzt files open.";
 }
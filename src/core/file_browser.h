@@ -16,11 +16,18 @@ FileBrowser *FileBrowser_Create(void);
 void FileBrowser_Destroy(FileBrowser *browser);
 
 bool FileBrowser_Open(FileBrowser *browser, const char *start_dir);
+// Directories are read on a worker thread. Call once a frame to merge what it has read
+// into the list; returns true while the directory is still being read.
+bool FileBrowser_Update(FileBrowser *browser);
+// Stop reading the current directory, leaving the list with what has been read so far
+void FileBrowser_CancelScan(FileBrowser *browser);
 bool FileBrowser_MoveSelection(FileBrowser *browser, int delta);
 bool FileBrowser_MovePage(FileBrowser *browser, int page_delta);
 void FileBrowser_SetVisibleRows(FileBrowser *browser, int rows);
 void FileBrowser_SetStatus(FileBrowser *browser, const char *status);
 void FileBrowser_ClearStatus(FileBrowser *browser);
+// Text for the status line while no status is set; NULL clears it
+void FileBrowser_SetPreview(FileBrowser *browser, const char *preview);
 void FileBrowser_RememberPendingLocation(FileBrowser *browser);
 void FileBrowser_CommitPendingLocation(FileBrowser *browser);
 void FileBrowser_ClearPendingLocation(FileBrowser *browser);
@@ -31,6 +38,14 @@ FileBrowserActivateResult FileBrowser_Activate(FileBrowser *browser,
                                                char *out_member_path,
                                                size_t out_member_path_size);
 
+// Write the path (and zip member) Activate would open for the selected entry, without opening it.
+// Returns false when the selection is not a world.
+bool FileBrowser_GetSelectedWorld(const FileBrowser *browser,
+                                  char *out_path,
+                                  size_t out_path_size,
+                                  char *out_member_path,
+                                  size_t out_member_path_size);
+
 const char *FileBrowser_FormatDirectory(void *ud);
 const char *FileBrowser_FormatEntries(void *ud);
 const char *FileBrowser_FormatStatus(void *ud);
@@ -0,0 +1,148 @@
+#include "file_map.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "debugger.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define FILE_MAP_READ_CHUNK 65536
+
+static const uint8_t empty_file[1];
+
+bool Bzzt_File_Map_From_Stream(FILE *fp, Bzzt_File_Map *out)
+{
+    if (!fp || !out)
+        return false;
+
+    memset(out, 0, sizeof(*out));
+
+    size_t cap = FILE_MAP_READ_CHUNK, len = 0;
+    uint8_t *buf = malloc(cap);
+    if (!buf)
+        return false;
+
+    for (;;)
+    {
+        if (len == cap)
+        {
+            uint8_t *tmp = realloc(buf, cap * 2);
+            if (!tmp)
+            {
+                free(buf);
+                return false;
+            }
+            buf = tmp;
+            cap *= 2;
+        }
+
+        size_t got = fread(buf + len, 1, cap - len, fp);
+        len += got;
+        if (got == 0)
+            break;
+    }
+
+    if (ferror(fp))
+    {
+        Debug_Log(LOG_LEVEL_ERROR, LOG_ENGINE, "Error reading stream into memory.");
+        free(buf);
+        return false;
+    }
+
+    out->data = buf;
+    out->size = len;
+    out->mapped = false;
+    return true;
+}
+
+bool Bzzt_File_Map_Open(const char *path, Bzzt_File_Map *out)
+{
+    if (!path || !out)
+        return false;
+
+    memset(out, 0, sizeof(*out));
+
+#if !defined(_WIN32)
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        close(fd);
+        return false;
+    }
+
+    // mmap refuses zero-length mappings
+    if (st.st_size == 0)
+    {
+        close(fd);
+        out->data = empty_file;
+        return true;
+    }
+
+    void *addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED)
+    {
+        out->data = addr;
+        out->size = (size_t)st.st_size;
+        out->mapped = true;
+        out->fd = fd;
+        return true;
+    }
+    close(fd);
+    // Some filesystems can't be mapped; fall through and read the file instead
+#endif
+
+    FILE *fp = fopen(path, "rb");
+    if (!fp)
+        return false;
+    bool ok = Bzzt_File_Map_From_Stream(fp, out);
+    fclose(fp);
+    return ok;
+}
+
+bool Bzzt_File_Map_Covers(const Bzzt_File_Map *map, uint64_t end)
+{
+    if (!map || !map->mapped)
+        return true;
+
+#if !defined(_WIN32)
+    struct stat st;
+    if (fstat(map->fd, &st) != 0 || st.st_size < 0 || (uint64_t)st.st_size < end)
+    {
+        Debug_Log(LOG_LEVEL_ERROR, LOG_ENGINE, "Mapped file has shrunk below %llu bytes.", (unsigned long long)end);
+        return false;
+    }
+#endif
+    return true;
+}
+
+void Bzzt_File_Map_Close(Bzzt_File_Map *map)
+{
+    if (!map || !map->data)
+        return;
+
+    if (map->data != empty_file)
+    {
+#if !defined(_WIN32)
+        if (map->mapped)
+        {
+            munmap((void *)map->data, map->size);
+            close(map->fd);
+        }
+        else
+            free((void *)map->data);
+#else
+        free((void *)map->data);
+#endif
+    }
+
+    memset(map, 0, sizeof(*map));
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// A whole file's bytes, read-only. Memory-mapped where the platform allows,
+// otherwise read onto the heap; callers can't tell the difference.
+//
+// A mapping is only as good as the file under it: if another process
+// truncates the file, touching a page past the new end raises SIGBUS rather
+// than returning an error. Short-lived maps (parse, then close) live with
+// that window. Maps kept open across frames call Bzzt_File_Map_Covers before
+// each read and fail the read cleanly when the file has shrunk; a truncation
+// that lands between the check and the read is still not caught.
+typedef struct Bzzt_File_Map
+{
+    const uint8_t *data;
+    size_t size;
+    bool mapped;
+    int fd; // Kept open while mapped, for Bzzt_File_Map_Covers
+} Bzzt_File_Map;
+
+bool Bzzt_File_Map_Open(const char *path, Bzzt_File_Map *out);
+// Read everything left in an open stream into a heap-backed map
+bool Bzzt_File_Map_From_Stream(FILE *fp, Bzzt_File_Map *out);
+// False if the bytes [0, end) are no longer all backed by the file on disk.
+// Always true for heap-backed maps.
+bool Bzzt_File_Map_Covers(const Bzzt_File_Map *map, uint64_t end);
+// Safe on a zeroed or already-closed map
+void Bzzt_File_Map_Close(Bzzt_File_Map *map);
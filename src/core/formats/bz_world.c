@@ -0,0 +1,716 @@
+/**
+ * @file bz_world.c
+ * @brief Reading and writing .bzzt worlds
+ *
+ * Everything read from the file is range checked before it is used, so a
+ * truncated or damaged file fails to load instead of crashing: section and
+ * program bounds, bool bytes, stat positions, follower/leader links and
+ * program counters. Element ids are not checked, since any byte is one the
+ * engine can look up (unknown ones have no defaults and no behaviour).
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "bz_world.h"
+#include "bzzt.h"
+#include "debugger.h"
+#include "file_map.h"
+
+#if defined(_WIN32)
+#include <process.h>
+#define bzw_getpid() _getpid()
+#else
+#include <unistd.h>
+#define bzw_getpid() getpid()
+#endif
+
+#define BZW_ALIGN 16
+#define BZW_MAX_BOARDS 65535
+#define BZW_MAX_BOARD_DIM 4096
+
+struct BZWFile
+{
+    Bzzt_File_Map map;
+    BZWWorldRecord world;
+    BZWSection *boards; // Indexed by board
+};
+
+typedef struct BZWBuffer
+{
+    uint8_t *data;
+    size_t len, cap;
+} BZWBuffer;
+
+// FNV-1a over 8-byte words; a byte at a time cost as much as the rest of a load
+static uint64_t bzw_hash(const uint8_t *p, size_t n)
+{
+    uint64_t h = 1469598103934665603ull;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, p + i, sizeof(word));
+        h = (h ^ word) * 1099511628211ull;
+    }
+    for (; i < n; ++i)
+        h = (h ^ p[i]) * 1099511628211ull;
+    return h;
+}
+
+static uint32_t bzw_layout_tag(void)
+{
+    // Everything a board section copies as raw memory; the bytes of these
+    // numbers also differ between little and big endian builds
+    const uint32_t layout[] = {
+        (uint32_t)sizeof(void *), (uint32_t)sizeof(size_t), (uint32_t)sizeof(int), (uint32_t)sizeof(bool),
+        (uint32_t)sizeof(Bzzt_Tile),
+        (uint32_t)offsetof(Bzzt_Tile, visible), (uint32_t)offsetof(Bzzt_Tile, blink),
+        (uint32_t)offsetof(Bzzt_Tile, x), (uint32_t)offsetof(Bzzt_Tile, y),
+        (uint32_t)offsetof(Bzzt_Tile, element), (uint32_t)offsetof(Bzzt_Tile, glyph),
+        (uint32_t)offsetof(Bzzt_Tile, fg), (uint32_t)offsetof(Bzzt_Tile, bg),
+        (uint32_t)sizeof(Bzzt_Stat),
+        (uint32_t)offsetof(Bzzt_Stat, x), (uint32_t)offsetof(Bzzt_Stat, y),
+        (uint32_t)offsetof(Bzzt_Stat, prev_x), (uint32_t)offsetof(Bzzt_Stat, prev_y),
+        (uint32_t)offsetof(Bzzt_Stat, step_x), (uint32_t)offsetof(Bzzt_Stat, step_y),
+        (uint32_t)offsetof(Bzzt_Stat, cycle), (uint32_t)offsetof(Bzzt_Stat, data),
+        (uint32_t)offsetof(Bzzt_Stat, data_label), (uint32_t)offsetof(Bzzt_Stat, follower),
+        (uint32_t)offsetof(Bzzt_Stat, leader), (uint32_t)offsetof(Bzzt_Stat, intent_slot),
+        (uint32_t)offsetof(Bzzt_Stat, under), (uint32_t)offsetof(Bzzt_Stat, program),
+        (uint32_t)offsetof(Bzzt_Stat, program_length), (uint32_t)offsetof(Bzzt_Stat, program_counter),
+    };
+    uint64_t h = bzw_hash((const uint8_t *)layout, sizeof(layout));
+    return (uint32_t)(h ^ (h >> 32));
+}
+
+// count elements of elem bytes starting at off fit inside size bytes
+static bool bzw_range_ok(uint64_t size, uint64_t off, uint64_t count, uint64_t elem)
+{
+    if (off > size)
+        return false;
+    return elem == 0 || count <= (size - off) / elem;
+}
+
+// bool fields are copied as raw bytes, and anything but 0 or 1 in one is undefined
+static bool bzw_tile_bytes_ok(const uint8_t *tile)
+{
+    return tile[offsetof(Bzzt_Tile, visible)] <= 1 && tile[offsetof(Bzzt_Tile, blink)] <= 1;
+}
+
+// Anywhere from -1 (where the title monitor is parked) up to the board's far
+// edge or 255, whichever is larger: ZZT stores positions as bytes and keeps
+// some stats on its border, so off-board stats up to 255 come from real worlds
+static bool bzw_stat_pos_ok(int pos, int dim)
+{
+    return pos >= -1 && (pos < dim || pos <= UINT8_MAX);
+}
+
+static bool bzw_stat_link_ok(int16_t link, int stat_count)
+{
+    return link >= -1 && link < stat_count;
+}
+
+/* -- Reading --*/
+
+static bool bzw_read_world_section(BZWFile *f, const BZWSection *s)
+{
+    if (s->size != sizeof(BZWWorldRecord))
+        return false;
+
+    const uint8_t *p = f->map.data + s->offset;
+    if (bzw_hash(p, (size_t)s->size) != s->hash)
+        return false;
+
+    memcpy(&f->world, p, sizeof(f->world));
+    return f->world.board_count > 0 && f->world.board_count <= BZW_MAX_BOARDS;
+}
+
+BZWFile *BZW_Open(const char *path)
+{
+    if (!path)
+        return NULL;
+
+    BZWFile *f = calloc(1, sizeof(BZWFile));
+    if (!f)
+        return NULL;
+
+    if (!Bzzt_File_Map_Open(path, &f->map))
+    {
+        free(f);
+        return NULL;
+    }
+
+    const char *problem = NULL;
+    BZWHeader h;
+    const uint8_t *table = NULL;
+    bool found_world = false;
+    BZWSection s;
+
+    if (f->map.size < sizeof(BZWHeader))
+    {
+        problem = "too small";
+        goto fail;
+    }
+    memcpy(&h, f->map.data, sizeof(h));
+    if (memcmp(h.magic, "BzW", 4) != 0)
+    {
+        problem = "not a .bzzt world";
+        goto fail;
+    }
+    if (h.format_version != BZW_FORMAT_VERSION)
+    {
+        problem = "unsupported format version";
+        goto fail;
+    }
+    if (h.layout_tag != bzw_layout_tag())
+    {
+        problem = "written by a build with a different board layout";
+        goto fail;
+    }
+    if (h.file_size != f->map.size ||
+        !bzw_range_ok(f->map.size, h.section_table_offset, h.section_count, sizeof(BZWSection)))
+    {
+        problem = "truncated";
+        goto fail;
+    }
+
+    // The world record says how many boards to expect, so find it first
+    table = f->map.data + h.section_table_offset;
+    for (uint32_t i = 0; i < h.section_count; ++i)
+    {
+        memcpy(&s, table + (size_t)i * sizeof(BZWSection), sizeof(s));
+        if (!bzw_range_ok(f->map.size, s.offset, s.size, 1))
+        {
+            problem = "section out of range";
+            goto fail;
+        }
+        if (s.type == BZW_SECTION_WORLD && !found_world)
+        {
+            if (!bzw_read_world_section(f, &s))
+            {
+                problem = "bad world record";
+                goto fail;
+            }
+            found_world = true;
+        }
+    }
+    if (!found_world)
+    {
+        problem = "no world record";
+        goto fail;
+    }
+
+    f->boards = calloc((size_t)f->world.board_count, sizeof(BZWSection));
+    if (!f->boards)
+    {
+        problem = "out of memory";
+        goto fail;
+    }
+    for (uint32_t i = 0; i < h.section_count; ++i)
+    {
+        memcpy(&s, table + (size_t)i * sizeof(BZWSection), sizeof(s));
+        if (s.type != BZW_SECTION_BOARD)
+            continue;
+        if (s.index >= (uint32_t)f->world.board_count || f->boards[s.index].type != 0)
+        {
+            problem = "bad board section";
+            goto fail;
+        }
+        f->boards[s.index] = s;
+    }
+    for (int i = 0; i < f->world.board_count; ++i)
+    {
+        if (f->boards[i].type != BZW_SECTION_BOARD)
+        {
+            problem = "missing a board";
+            goto fail;
+        }
+    }
+
+    return f;
+
+fail:
+    Debug_Log(LOG_LEVEL_ERROR, LOG_WORLD, "Could not open %s: %s.", path, problem);
+    BZW_Close(f);
+    return NULL;
+}
+
+void BZW_Close(BZWFile *f)
+{
+    if (!f)
+        return;
+    Bzzt_File_Map_Close(&f->map);
+    free(f->boards);
+    free(f);
+}
+
+int BZW_Board_Count(const BZWFile *f)
+{
+    return f ? f->world.board_count : 0;
+}
+
+void BZW_Start_Boards(const BZWFile *f, int *start_idx, int *current_idx)
+{
+    const BZWWorldRecord *r = &f->world;
+    *start_idx = r->start_board_idx < r->board_count ? r->start_board_idx : 0;
+    *current_idx = (r->boards_current >= 0 && r->boards_current < r->board_count) ? r->boards_current : 0;
+}
+
+bool BZW_Read_World(const BZWFile *f, Bzzt_World *w)
+{
+    if (!f || !w)
+        return false;
+
+    const BZWWorldRecord *r = &f->world;
+    memcpy(w->title, r->title, sizeof(w->title));
+    w->title[sizeof(w->title) - 1] = '\0';
+    memcpy(w->author, r->author, sizeof(w->author));
+    w->author[sizeof(w->author) - 1] = '\0';
+    w->version = r->version;
+
+    int start_idx, current_idx;
+    BZW_Start_Boards(f, &start_idx, &current_idx);
+    w->boards_current = current_idx;
+    w->start_board_idx = (uint16_t)start_idx;
+    w->title_monitor_x = r->title_monitor_x;
+    w->title_monitor_y = r->title_monitor_y;
+    w->game_speed = (int16_t)Bzzt_World_Normalize_Game_Speed(r->game_speed);
+
+    w->ammo = r->ammo;
+    w->gems = r->gems;
+    w->health = r->health;
+    w->torches = r->torches;
+    w->score = r->score;
+    memcpy(w->keys, r->keys, sizeof(w->keys));
+    w->torch_cycles = r->torch_cycles;
+    w->energizer_cycles = r->energizer_cycles;
+    memcpy(w->flags, r->flags, sizeof(w->flags));
+    for (int i = 0; i < 10; ++i)
+        w->flags[i][20] = '\0';
+    w->time_passed = r->time_passed;
+
+    w->on_title = r->on_title != 0;
+    w->zzt_compatible = r->zzt_compatible != 0;
+    w->allow_scroll = r->allow_scroll != 0;
+    w->strict_palette = r->strict_palette != 0;
+    w->allow_blink = r->allow_blink != 0;
+    w->rng_state = r->rng_state;
+    return true;
+}
+
+static Bzzt_Board *bzw_board_fail(Bzzt_Board *b, int idx, const char *problem)
+{
+    Debug_Log(LOG_LEVEL_ERROR, LOG_WORLD, "Could not read board %d: %s.", idx, problem);
+    Bzzt_Board_Destroy(b);
+    return NULL;
+}
+
+Bzzt_Board *BZW_Read_Board(const BZWFile *f, int idx)
+{
+    if (!f || idx < 0 || idx >= f->world.board_count)
+        return NULL;
+
+    const BZWSection *s = &f->boards[idx];
+    // The map lives as long as the world does, so check the file is still all there
+    if (!Bzzt_File_Map_Covers(&f->map, s->offset + s->size))
+        return bzw_board_fail(NULL, idx, "file truncated on disk");
+
+    const uint8_t *p = f->map.data + s->offset;
+    uint64_t size = s->size;
+    if (bzw_hash(p, (size_t)size) != s->hash)
+        return bzw_board_fail(NULL, idx, "checksum mismatch");
+
+    BZWBoardRecord r;
+    if (size < sizeof(r))
+        return bzw_board_fail(NULL, idx, "truncated");
+    memcpy(&r, p, sizeof(r));
+
+    if (r.width < 1 || r.height < 1 || r.width > BZW_MAX_BOARD_DIM || r.height > BZW_MAX_BOARD_DIM || r.stat_count < 0)
+        return bzw_board_fail(NULL, idx, "bad dimensions");
+
+    size_t tile_count = (size_t)r.width * (size_t)r.height;
+    if (!bzw_range_ok(size, r.tiles_offset, tile_count, sizeof(Bzzt_Tile)) ||
+        !bzw_range_ok(size, r.stats_offset, (uint64_t)r.stat_count, sizeof(Bzzt_Stat)) ||
+        !bzw_range_ok(size, r.name_offset, (uint64_t)r.name_length + 1, 1) ||
+        !bzw_range_ok(size, r.programs_offset, r.programs_size, 1))
+        return bzw_board_fail(NULL, idx, "section out of range");
+
+    const uint8_t *tiles = p + r.tiles_offset;
+    const uint8_t *stats = p + r.stats_offset;
+    const char *name = (const char *)(p + r.name_offset);
+    const char *programs = (const char *)(p + r.programs_offset);
+    if (name[r.name_length] != '\0')
+        return bzw_board_fail(NULL, idx, "bad name");
+
+    for (size_t i = 0; i < tile_count; ++i)
+    {
+        if (!bzw_tile_bytes_ok(tiles + i * sizeof(Bzzt_Tile)))
+            return bzw_board_fail(NULL, idx, "bad tile");
+    }
+
+    Bzzt_Board *b = Bzzt_Board_Create(name, r.width, r.height);
+    if (!b)
+        return bzw_board_fail(NULL, idx, "out of memory");
+
+    memcpy(b->tiles, tiles, tile_count * sizeof(Bzzt_Tile));
+
+    if (r.stat_count > b->stat_cap)
+    {
+        Bzzt_Stat **grown = realloc(b->stats, (size_t)r.stat_count * sizeof(Bzzt_Stat *));
+        if (!grown)
+            return bzw_board_fail(b, idx, "out of memory");
+        b->stats = grown;
+        b->stat_cap = r.stat_count;
+    }
+
+    uint64_t program_pos = 0;
+    for (int i = 0; i < r.stat_count; ++i)
+    {
+        const uint8_t *raw = stats + (size_t)i * sizeof(Bzzt_Stat);
+        if (!bzw_tile_bytes_ok(raw + offsetof(Bzzt_Stat, under)))
+            return bzw_board_fail(b, idx, "bad stat");
+
+        Bzzt_Stat *stat = malloc(sizeof(Bzzt_Stat));
+        if (!stat)
+            return bzw_board_fail(b, idx, "out of memory");
+        memcpy(stat, raw, sizeof(Bzzt_Stat));
+        stat->program = NULL;
+        stat->intent_slot = -1;
+        b->stats[b->stat_count++] = stat;
+
+        if (!bzw_stat_pos_ok(stat->x, r.width) || !bzw_stat_pos_ok(stat->y, r.height) ||
+            !bzw_stat_pos_ok(stat->prev_x, r.width) || !bzw_stat_pos_ok(stat->prev_y, r.height))
+        {
+            stat->program_length = 0;
+            return bzw_board_fail(b, idx, "stat out of bounds");
+        }
+        if (!bzw_stat_link_ok(stat->follower, r.stat_count) || !bzw_stat_link_ok(stat->leader, r.stat_count))
+        {
+            stat->program_length = 0;
+            return bzw_board_fail(b, idx, "bad stat link");
+        }
+        // A ZZT stat that ran #end keeps its instruction pointer at -1
+        if (stat->program_counter > stat->program_length && stat->program_counter != (size_t)-1)
+        {
+            stat->program_length = 0;
+            return bzw_board_fail(b, idx, "bad program counter");
+        }
+
+        if (stat->program_length == 0)
+            continue;
+
+        uint64_t length = stat->program_length;
+        if (length >= r.programs_size - program_pos || programs[program_pos + length] != '\0')
+        {
+            stat->program_length = 0;
+            return bzw_board_fail(b, idx, "bad program");
+        }
+
+        stat->program = malloc((size_t)length + 1);
+        if (!stat->program)
+        {
+            stat->program_length = 0;
+            return bzw_board_fail(b, idx, "out of memory");
+        }
+        memcpy(stat->program, programs + program_pos, (size_t)length + 1);
+        program_pos += length + 1;
+    }
+
+    b->max_shots = r.max_shots;
+    b->darkness = r.darkness;
+    b->board_n = r.board_n;
+    b->board_s = r.board_s;
+    b->board_w = r.board_w;
+    b->board_e = r.board_e;
+    b->reenter = r.reenter;
+    b->reenter_x = r.reenter_x;
+    b->reenter_y = r.reenter_y;
+    b->time_limit = r.time_limit;
+    b->live = r.live != 0;
+    memcpy(b->message, r.message, sizeof(b->message));
+    b->message[sizeof(b->message) - 1] = '\0';
+    b->idx = idx;
+
+    Bzzt_Board_Rebuild_Stat_Index(b);
+    return b;
+}
+
+/* -- Writing --*/
+
+static bool bzw_reserve(BZWBuffer *buf, size_t extra)
+{
+    if (buf->cap - buf->len >= extra)
+        return true;
+
+    size_t cap = buf->cap ? buf->cap : 65536;
+    while (cap - buf->len < extra)
+        cap *= 2;
+    uint8_t *tmp = realloc(buf->data, cap);
+    if (!tmp)
+        return false;
+    buf->data = tmp;
+    buf->cap = cap;
+    return true;
+}
+
+static bool bzw_append(BZWBuffer *buf, const void *p, size_t n)
+{
+    if (!bzw_reserve(buf, n))
+        return false;
+    memcpy(buf->data + buf->len, p, n);
+    buf->len += n;
+    return true;
+}
+
+// Zero-pad to the next BZW_ALIGN boundary
+static bool bzw_align(BZWBuffer *buf)
+{
+    size_t pad = (BZW_ALIGN - buf->len % BZW_ALIGN) % BZW_ALIGN;
+    if (!bzw_reserve(buf, pad))
+        return false;
+    memset(buf->data + buf->len, 0, pad);
+    buf->len += pad;
+    return true;
+}
+
+static void bzw_fill_world_record(BZWWorldRecord *r, const Bzzt_World *w)
+{
+    memset(r, 0, sizeof(*r));
+    memcpy(r->title, w->title, sizeof(r->title));
+    memcpy(r->author, w->author, sizeof(r->author));
+    r->version = w->version;
+    r->board_count = w->boards_count;
+    r->boards_current = w->boards_current;
+    r->start_board_idx = w->start_board_idx;
+    r->title_monitor_x = w->title_monitor_x;
+    r->title_monitor_y = w->title_monitor_y;
+    r->game_speed = w->game_speed;
+    r->ammo = w->ammo;
+    r->gems = w->gems;
+    r->health = w->health;
+    r->torches = w->torches;
+    r->score = w->score;
+    memcpy(r->keys, w->keys, sizeof(r->keys));
+    r->torch_cycles = w->torch_cycles;
+    r->energizer_cycles = w->energizer_cycles;
+    memcpy(r->flags, w->flags, sizeof(r->flags));
+    r->time_passed = w->time_passed;
+    r->on_title = w->on_title;
+    r->zzt_compatible = w->zzt_compatible;
+    r->allow_scroll = w->allow_scroll;
+    r->strict_palette = w->strict_palette;
+    r->allow_blink = w->allow_blink;
+    r->rng_state = w->rng_state;
+}
+
+// Tiles and stats go out in their in-memory layout, but built member by member
+// on zeroed memory so their padding is written as zeros, not heap leftovers
+static void bzw_clean_tile(Bzzt_Tile *out, const Bzzt_Tile *t)
+{
+    memset(out, 0, sizeof(*out));
+    out->visible = t->visible;
+    out->blink = t->blink;
+    out->x = t->x;
+    out->y = t->y;
+    out->element = t->element;
+    out->glyph = t->glyph;
+    out->fg = t->fg;
+    out->bg = t->bg;
+}
+
+static void bzw_clean_stat(Bzzt_Stat *out, const Bzzt_Stat *s)
+{
+    memset(out, 0, sizeof(*out));
+    out->x = s->x;
+    out->y = s->y;
+    out->prev_x = s->prev_x;
+    out->prev_y = s->prev_y;
+    out->step_x = s->step_x;
+    out->step_y = s->step_y;
+    out->cycle = s->cycle;
+    memcpy(out->data, s->data, sizeof(out->data));
+    memcpy(out->data_label, s->data_label, sizeof(out->data_label));
+    out->follower = s->follower;
+    out->leader = s->leader;
+    out->intent_slot = -1;
+    bzw_clean_tile(&out->under, &s->under);
+    out->program = NULL;
+    out->program_length = s->program ? s->program_length : 0;
+    out->program_counter = s->program_counter;
+}
+
+// Append one board section at the current (aligned) end of buf
+static bool bzw_write_board(BZWBuffer *buf, const Bzzt_Board *b)
+{
+    size_t start = buf->len;
+    BZWBoardRecord r;
+    memset(&r, 0, sizeof(r));
+    if (!bzw_append(buf, &r, sizeof(r)))
+        return false;
+
+    r.width = b->width;
+    r.height = b->height;
+    r.stat_count = b->stat_count;
+    r.max_shots = b->max_shots;
+    r.darkness = b->darkness;
+    r.board_n = b->board_n;
+    r.board_s = b->board_s;
+    r.board_w = b->board_w;
+    r.board_e = b->board_e;
+    r.reenter = b->reenter;
+    r.reenter_x = b->reenter_x;
+    r.reenter_y = b->reenter_y;
+    r.time_limit = b->time_limit;
+    r.live = b->live;
+    memcpy(r.message, b->message, sizeof(r.message));
+
+    if (!bzw_align(buf))
+        return false;
+    r.tiles_offset = buf->len - start;
+    size_t tile_count = (size_t)b->width * (size_t)b->height;
+    if (!bzw_reserve(buf, tile_count * sizeof(Bzzt_Tile)))
+        return false;
+    for (size_t i = 0; i < tile_count; ++i)
+    {
+        Bzzt_Tile tile;
+        bzw_clean_tile(&tile, &b->tiles[i]);
+        memcpy(buf->data + buf->len, &tile, sizeof(tile));
+        buf->len += sizeof(tile);
+    }
+
+    if (!bzw_align(buf))
+        return false;
+    r.stats_offset = buf->len - start;
+    for (int i = 0; i < b->stat_count; ++i)
+    {
+        Bzzt_Stat copy;
+        bzw_clean_stat(&copy, b->stats[i]);
+        if (!bzw_append(buf, &copy, sizeof(copy)))
+            return false;
+    }
+
+    const char *name = b->name ? b->name : "";
+    r.name_offset = buf->len - start;
+    r.name_length = (uint32_t)strlen(name);
+    if (!bzw_append(buf, name, (size_t)r.name_length + 1))
+        return false;
+
+    r.programs_offset = buf->len - start;
+    for (int i = 0; i < b->stat_count; ++i)
+    {
+        const Bzzt_Stat *stat = b->stats[i];
+        if (!stat->program || stat->program_length == 0)
+            continue;
+        if (!bzw_append(buf, stat->program, stat->program_length) || !bzw_append(buf, "", 1))
+            return false;
+    }
+    r.programs_size = buf->len - r.programs_offset - start;
+
+    memcpy(buf->data + start, &r, sizeof(r));
+    return true;
+}
+
+static bool bzw_write_file(const char *path, const BZWBuffer *buf)
+{
+    // Write beside the target and swap it in, so a failed save leaves the old file alone.
+    // The name is unique to this save, as two threads or processes may be saving the same world.
+    static unsigned save_counter;
+    unsigned save_id = __atomic_add_fetch(&save_counter, 1, __ATOMIC_RELAXED);
+    char tmp_path[BZZT_MAX_PATH_LENGTH + 32];
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.%ld-%u.tmp", path, (long)bzw_getpid(), save_id) >=
+        (int)sizeof(tmp_path))
+        return false;
+
+    FILE *fp = fopen(tmp_path, "wb");
+    if (!fp)
+        return false;
+
+    bool ok = fwrite(buf->data, 1, buf->len, fp) == buf->len;
+    if (fclose(fp) != 0)
+        ok = false;
+    if (!ok)
+    {
+        remove(tmp_path);
+        return false;
+    }
+
+#if defined(_WIN32)
+    remove(path); // rename() won't replace an existing file here
+#endif
+    if (rename(tmp_path, path) != 0)
+    {
+        remove(tmp_path);
+        return false;
+    }
+    return true;
+}
+
+bool BZW_Save(const char *path, Bzzt_World *w)
+{
+    if (!path || !w || w->boards_count < 1 || w->boards_count > BZW_MAX_BOARDS)
+        return false;
+
+    for (int i = 0; i < w->boards_count; ++i)
+    {
+        if (!Bzzt_World_Get_Board(w, i))
+        {
+            Debug_Log(LOG_LEVEL_ERROR, LOG_WORLD, "Could not save %s: board %d is missing.", path, i);
+            return false;
+        }
+    }
+
+    uint32_t section_count = (uint32_t)w->boards_count + 1;
+    BZWSection *sections = calloc(section_count, sizeof(BZWSection));
+    BZWBuffer buf = {0};
+    bool ok = sections != NULL;
+
+    BZWHeader h;
+    memset(&h, 0, sizeof(h));
+    ok = ok && bzw_append(&buf, &h, sizeof(h));
+
+    BZWWorldRecord record;
+    bzw_fill_world_record(&record, w);
+    ok = ok && bzw_align(&buf);
+    if (ok)
+    {
+        sections[0] = (BZWSection){BZW_SECTION_WORLD, 0, buf.len, sizeof(record), 0};
+        ok = bzw_append(&buf, &record, sizeof(record));
+    }
+
+    for (int i = 0; ok && i < w->boards_count; ++i)
+    {
+        ok = bzw_align(&buf);
+        size_t start = buf.len;
+        ok = ok && bzw_write_board(&buf, w->boards[i]);
+        sections[i + 1] = (BZWSection){BZW_SECTION_BOARD, (uint32_t)i, start, buf.len - start, 0};
+    }
+
+    ok = ok && bzw_align(&buf);
+    if (ok)
+    {
+        for (uint32_t i = 0; i < section_count; ++i)
+            sections[i].hash = bzw_hash(buf.data + sections[i].offset, (size_t)sections[i].size);
+
+        memcpy(h.magic, "BzW", 4);
+        h.format_version = BZW_FORMAT_VERSION;
+        h.layout_tag = bzw_layout_tag();
+        h.section_count = section_count;
+        h.section_table_offset = buf.len;
+        ok = bzw_append(&buf, sections, section_count * sizeof(BZWSection));
+        h.file_size = buf.len;
+    }
+
+    if (ok)
+    {
+        memcpy(buf.data, &h, sizeof(h));
+        ok = bzw_write_file(path, &buf);
+    }
+
+    if (!ok)
+        Debug_Log(LOG_LEVEL_ERROR, LOG_WORLD, "Could not save %s.", path);
+
+    free(buf.data);
+    free(sections);
+    return ok;
+}
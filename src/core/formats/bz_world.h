@@ -0,0 +1,100 @@
+/**
+ * @file bz_world.h
+ * @brief Defines the .bzzt (native bzzt world) file format
+ *
+ * A header, then a table of sections. One section holds the world record and
+ * each board gets its own, so a board can be read without touching the rest.
+ * Board sections keep tiles and stats exactly as they sit in memory; loading
+ * one is a bounds check, two copies and a program pointer fixup per stat.
+ * Because of that the file is tied to the tile/stat layout of the build that
+ * wrote it, and the header carries a tag of that layout to refuse files from
+ * a build that lays them out differently.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bzzt.h"
+
+#define BZW_FORMAT_VERSION 1
+
+enum
+{
+    BZW_SECTION_WORLD = 1,
+    BZW_SECTION_BOARD = 2
+};
+
+#pragma pack(push, 1)
+typedef struct BZWHeader
+{
+    char magic[4];                 // "BzW\0"
+    uint16_t format_version;       // BZW_FORMAT_VERSION
+    uint16_t flags;                // unused for now
+    uint32_t layout_tag;           // Hash of the Bzzt_Tile/Bzzt_Stat layout the board sections mirror
+    uint32_t section_count;
+    uint64_t section_table_offset; // BZWSection[section_count]
+    uint64_t file_size;
+} BZWHeader;
+
+typedef struct BZWSection
+{
+    uint32_t type;   // BZW_SECTION_*
+    uint32_t index;  // Board index for board sections
+    uint64_t offset; // From the start of the file
+    uint64_t size;
+    uint64_t hash;   // FNV-1a of the section's bytes
+} BZWSection;
+
+typedef struct BZWWorldRecord
+{
+    char title[64];
+    char author[32];
+    uint32_t version;
+    int32_t board_count;
+    int32_t boards_current;
+    uint16_t start_board_idx;
+    int16_t title_monitor_x, title_monitor_y;
+    int16_t game_speed;
+    int16_t ammo, gems, health, torches, score;
+    uint8_t keys[7];
+    int16_t torch_cycles, energizer_cycles;
+    char flags[10][21];
+    int16_t time_passed;
+    uint8_t on_title, zzt_compatible, allow_scroll, strict_palette, allow_blink;
+    uint32_t rng_state;
+} BZWWorldRecord;
+
+typedef struct BZWBoardRecord
+{
+    int32_t width, height;
+    int32_t stat_count;
+    uint32_t name_length;     // Not counting the NUL stored after it
+    uint64_t tiles_offset;    // Bzzt_Tile[width * height], from the start of the section
+    uint64_t stats_offset;    // Bzzt_Stat[stat_count] with program pointers cleared
+    uint64_t name_offset;
+    uint64_t programs_offset; // Each stat's program and its NUL, in stat order
+    uint64_t programs_size;
+    uint8_t max_shots, darkness;
+    uint8_t board_n, board_s, board_w, board_e;
+    uint8_t reenter, reenter_x, reenter_y;
+    uint8_t live;
+    int16_t time_limit;
+    char message[59];
+} BZWBoardRecord;
+#pragma pack(pop)
+
+// BZWFile (declared in bzzt.h) is an open .bzzt file. Reads never modify it,
+// so boards can be read from several threads at once.
+
+// Map and validate a .bzzt file. Board sections are only checked when read.
+BZWFile *BZW_Open(const char *path);
+void BZW_Close(BZWFile *f);
+int BZW_Board_Count(const BZWFile *f);
+// Copy the world record into w. Boards are left alone.
+bool BZW_Read_World(const BZWFile *f, Bzzt_World *w);
+// The start and current board indices BZW_Read_World would set
+void BZW_Start_Boards(const BZWFile *f, int *start_idx, int *current_idx);
+// Build board idx from its section, or NULL if it is missing or fails validation
+Bzzt_Board *BZW_Read_Board(const BZWFile *f, int idx);
+// Write every board of w; boards still waiting to be converted are converted first
+bool BZW_Save(const char *path, Bzzt_World *w);
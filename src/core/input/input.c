@@ -164,6 +164,9 @@ void Input_Poll(InputState *in)
     in->I_pressed = IsKeyPressed(KEY_I);
     in->L_pressed = IsKeyPressed(KEY_L);
     in->Q_pressed = IsKeyPressed(KEY_Q);
+    in->TAB_pressed = IsKeyPressed(KEY_TAB); // Turbo; T is ZZT's torch key
+    in->F3_pressed = IsKeyPressed(KEY_F3);   // Two-phase ticking
+    in->F4_pressed = IsKeyPressed(KEY_F4);   // Parallel ticking of live boards
     in->P_pressed = IsKeyPressed(KEY_P);
     in->ESC_pressed = IsKeyPressed(KEY_ESCAPE);
     in->SPACE_pressed = IsKeyPressed(KEY_SPACE);
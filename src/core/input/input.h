@@ -47,6 +47,9 @@ typedef struct InputState
     bool I_pressed;
     bool L_pressed;
     bool Q_pressed;
+    bool TAB_pressed;
+    bool F3_pressed;
+    bool F4_pressed;
     bool P_pressed;
     bool ESC_pressed;
     bool SPACE_pressed;
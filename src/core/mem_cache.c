@@ -0,0 +1,260 @@
+#include "mem_cache.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "debugger.h"
+
+typedef struct Mem_Cache_Node
+{
+    void *item;
+    size_t bytes;
+    Bzzt_Mem_Cache_Category category;
+    Bzzt_Mem_Cache_Evict_Fn evict;
+    void *ctx;
+    bool evicting; // Its evict callback is running, without the lock held
+    bool removed;  // Its owner let go of it during the eviction
+    struct Mem_Cache_Node *prev, *next;
+} Mem_Cache_Node;
+
+static pthread_mutex_t mem_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t mem_cache_evicted = PTHREAD_COND_INITIALIZER;
+static Mem_Cache_Node *mem_cache_head = NULL; // Most recently used
+static Mem_Cache_Node *mem_cache_tail = NULL; // Least recently used
+static int mem_cache_count = 0;
+static size_t mem_cache_budget = BZZT_MEM_CACHE_DEFAULT_BUDGET;
+static size_t mem_cache_used = 0;
+static size_t mem_cache_category_used[BZZT_MEM_CACHE__COUNT];
+static unsigned mem_cache_weights[BZZT_MEM_CACHE__COUNT] = {1, 1, 1};
+static unsigned long long mem_cache_evictions = 0;
+
+// The node tracking item, newest first. A node being evicted never matches: its
+// item may already be freed and the address in use again by a new item.
+static Mem_Cache_Node *mem_cache_find(const void *item)
+{
+    for (Mem_Cache_Node *node = mem_cache_head; node; node = node->next)
+    {
+        if (node->item == item && !node->evicting)
+            return node;
+    }
+    return NULL;
+}
+
+static Mem_Cache_Node *mem_cache_find_evicting(const void *item)
+{
+    for (Mem_Cache_Node *node = mem_cache_head; node; node = node->next)
+    {
+        if (node->item == item && node->evicting)
+            return node;
+    }
+    return NULL;
+}
+
+static void mem_cache_unlink(Mem_Cache_Node *node)
+{
+    if (node->prev)
+        node->prev->next = node->next;
+    else
+        mem_cache_head = node->next;
+    if (node->next)
+        node->next->prev = node->prev;
+    else
+        mem_cache_tail = node->prev;
+    node->prev = node->next = NULL;
+}
+
+static void mem_cache_push_front(Mem_Cache_Node *node)
+{
+    node->prev = NULL;
+    node->next = mem_cache_head;
+    if (mem_cache_head)
+        mem_cache_head->prev = node;
+    else
+        mem_cache_tail = node;
+    mem_cache_head = node;
+}
+
+static void mem_cache_forget(Mem_Cache_Node *node)
+{
+    mem_cache_unlink(node);
+    mem_cache_used -= node->bytes;
+    mem_cache_category_used[node->category] -= node->bytes;
+    mem_cache_count--;
+    free(node);
+}
+
+// The least recently used item of the category furthest over its weighted share of the budget.
+// While the total is over budget at least one category is.
+static Mem_Cache_Node *mem_cache_pick_victim(void)
+{
+    uint64_t total_weight = 0;
+    for (int c = 0; c < BZZT_MEM_CACHE__COUNT; ++c)
+        total_weight += mem_cache_weights[c];
+
+    uint64_t over[BZZT_MEM_CACHE__COUNT];
+    for (int c = 0; c < BZZT_MEM_CACHE__COUNT; ++c)
+    {
+        uint64_t share = total_weight ? (uint64_t)mem_cache_budget * mem_cache_weights[c] / total_weight : 0;
+        over[c] = mem_cache_category_used[c] > share ? mem_cache_category_used[c] - share : 0;
+    }
+
+    // A category with nothing left to evict (all of it mid-eviction) gives way to the next worst
+    for (;;)
+    {
+        int worst = -1;
+        for (int c = 0; c < BZZT_MEM_CACHE__COUNT; ++c)
+        {
+            if (over[c] > 0 && (worst < 0 || over[c] > over[worst]))
+                worst = c;
+        }
+        if (worst < 0)
+            return NULL;
+
+        for (Mem_Cache_Node *node = mem_cache_tail; node; node = node->prev)
+        {
+            if (!node->evicting && node->category == (Bzzt_Mem_Cache_Category)worst)
+                return node;
+        }
+        over[worst] = 0;
+    }
+}
+
+void Bzzt_Mem_Cache_Configure(size_t budget_bytes)
+{
+    pthread_mutex_lock(&mem_cache_lock);
+    mem_cache_budget = budget_bytes;
+    pthread_mutex_unlock(&mem_cache_lock);
+    Debug_Log(LOG_LEVEL_DEBUG, LOG_ENGINE, "Cache memory budget: %zu KB.", budget_bytes / 1024);
+    Bzzt_Mem_Cache_Trim();
+}
+
+void Bzzt_Mem_Cache_Set_Weight(Bzzt_Mem_Cache_Category category, unsigned weight)
+{
+    if (category < 0 || category >= BZZT_MEM_CACHE__COUNT)
+        return;
+
+    pthread_mutex_lock(&mem_cache_lock);
+    mem_cache_weights[category] = weight;
+    pthread_mutex_unlock(&mem_cache_lock);
+}
+
+void Bzzt_Mem_Cache_Insert(Bzzt_Mem_Cache_Category category, void *item, size_t bytes,
+                           Bzzt_Mem_Cache_Evict_Fn evict, void *ctx)
+{
+    if (!item || !evict || category < 0 || category >= BZZT_MEM_CACHE__COUNT)
+        return;
+
+    pthread_mutex_lock(&mem_cache_lock);
+    Mem_Cache_Node *node = mem_cache_find(item);
+    if (node)
+    {
+        // Already tracked; just take the new size
+        mem_cache_used -= node->bytes;
+        mem_cache_category_used[node->category] -= node->bytes;
+    }
+    else
+    {
+        node = calloc(1, sizeof(Mem_Cache_Node));
+        if (!node)
+        {
+            pthread_mutex_unlock(&mem_cache_lock);
+            return;
+        }
+        node->item = item;
+        mem_cache_count++;
+        mem_cache_push_front(node);
+    }
+
+    node->bytes = bytes;
+    node->category = category;
+    node->evict = evict;
+    node->ctx = ctx;
+    mem_cache_used += bytes;
+    mem_cache_category_used[category] += bytes;
+    pthread_mutex_unlock(&mem_cache_lock);
+}
+
+void Bzzt_Mem_Cache_Touch(void *item)
+{
+    pthread_mutex_lock(&mem_cache_lock);
+    Mem_Cache_Node *node = mem_cache_find(item);
+    if (node && !node->evicting && node != mem_cache_head)
+    {
+        mem_cache_unlink(node);
+        mem_cache_push_front(node);
+    }
+    pthread_mutex_unlock(&mem_cache_lock);
+}
+
+void Bzzt_Mem_Cache_Remove(void *item)
+{
+    if (!item)
+        return;
+
+    pthread_mutex_lock(&mem_cache_lock);
+    Mem_Cache_Node *node = mem_cache_find(item);
+    if (node)
+    {
+        mem_cache_forget(node);
+    }
+    else if ((node = mem_cache_find_evicting(item)) != NULL)
+    {
+        // The eviction drops the node once its callback returns
+        node->removed = true;
+        while (mem_cache_find_evicting(item))
+            pthread_cond_wait(&mem_cache_evicted, &mem_cache_lock);
+    }
+    pthread_mutex_unlock(&mem_cache_lock);
+}
+
+void Bzzt_Mem_Cache_Trim(void)
+{
+    pthread_mutex_lock(&mem_cache_lock);
+    // Items that won't go are moved to the front, so one pass over the list is enough
+    int attempts = mem_cache_count;
+    while (mem_cache_budget > 0 && mem_cache_used > mem_cache_budget && attempts-- > 0)
+    {
+        Mem_Cache_Node *node = mem_cache_pick_victim();
+        if (!node)
+            break;
+
+        node->evicting = true;
+        Bzzt_Mem_Cache_Evict_Fn evict = node->evict;
+        void *ctx = node->ctx;
+        void *item = node->item;
+        pthread_mutex_unlock(&mem_cache_lock);
+        bool evicted = evict(ctx, item);
+        pthread_mutex_lock(&mem_cache_lock);
+
+        node->evicting = false;
+        if (evicted)
+            mem_cache_evictions++;
+        // A kept item that was inserted again meanwhile is tracked by the newer node
+        Mem_Cache_Node *newer = evicted || node->removed ? NULL : mem_cache_find(item);
+        if (evicted || node->removed || (newer && newer != node))
+        {
+            mem_cache_forget(node);
+        }
+        else
+        {
+            mem_cache_unlink(node);
+            mem_cache_push_front(node);
+        }
+        pthread_cond_broadcast(&mem_cache_evicted);
+    }
+    pthread_mutex_unlock(&mem_cache_lock);
+}
+
+void Bzzt_Mem_Cache_Get_Stats(Bzzt_Mem_Cache_Stats *out)
+{
+    if (!out)
+        return;
+
+    pthread_mutex_lock(&mem_cache_lock);
+    out->budget = mem_cache_budget;
+    out->used = mem_cache_used;
+    for (int c = 0; c < BZZT_MEM_CACHE__COUNT; ++c)
+        out->category_used[c] = mem_cache_category_used[c];
+    out->evictions = mem_cache_evictions;
+    pthread_mutex_unlock(&mem_cache_lock);
+}
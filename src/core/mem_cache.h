@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* One memory budget shared by the in-memory caches. Each cache registers the
+ * items it holds with their size and an evict callback; when the total goes
+ * over the budget, the least recently used item of the category furthest over
+ * its weighted share is evicted, whichever cache it belongs to.
+ *
+ * Evict callbacks can run on any thread. Insert and Touch may be called while
+ * holding the lock an evict callback takes, or from the callback itself;
+ * Remove and Trim may not. An item whose eviction is under way is no longer
+ * tracked as far as Insert and Touch are concerned, so an address the
+ * callback frees can be handed out and inserted again straight away. */
+
+typedef enum Bzzt_Mem_Cache_Category
+{
+    BZZT_MEM_CACHE_ZIP_MEMBERS, // Nested archives inflated out of zips
+    BZZT_MEM_CACHE_ZIP_INDEXES, // Parsed zip central directories
+    BZZT_MEM_CACHE_WORLDS,      // Worlds preloaded from the file browser
+    BZZT_MEM_CACHE__COUNT
+} Bzzt_Mem_Cache_Category;
+
+#define BZZT_MEM_CACHE_DEFAULT_BUDGET (192ull * 1024 * 1024)
+
+// Free item and return true, or return false to keep it (e.g. it is in use).
+// Return true as well if item is already gone.
+typedef bool (*Bzzt_Mem_Cache_Evict_Fn)(void *ctx, void *item);
+
+typedef struct Bzzt_Mem_Cache_Stats
+{
+    size_t budget;
+    size_t used;
+    size_t category_used[BZZT_MEM_CACHE__COUNT];
+    unsigned long long evictions;
+} Bzzt_Mem_Cache_Stats;
+
+// Set the byte budget and trim to it. 0 means no budget.
+void Bzzt_Mem_Cache_Configure(size_t budget_bytes);
+// Relative share of the budget a category keeps when others want room (default 1; 0 is evicted first)
+void Bzzt_Mem_Cache_Set_Weight(Bzzt_Mem_Cache_Category category, unsigned weight);
+
+// Start tracking item, as the most recently used. Call Trim afterwards, outside any cache lock.
+void Bzzt_Mem_Cache_Insert(Bzzt_Mem_Cache_Category category, void *item, size_t bytes,
+                           Bzzt_Mem_Cache_Evict_Fn evict, void *ctx);
+// Mark item as just used
+void Bzzt_Mem_Cache_Touch(void *item);
+// Stop tracking item before its owner frees it; waits out an eviction of it already under way
+void Bzzt_Mem_Cache_Remove(void *item);
+// Evict until within budget or nothing more can go
+void Bzzt_Mem_Cache_Trim(void);
+void Bzzt_Mem_Cache_Get_Stats(Bzzt_Mem_Cache_Stats *out);
@@ -393,6 +393,7 @@ void Renderer_Update(Renderer *r, Engine *e)
     switch (e->state)
     {
     case ENGINE_STATE_MENU:
+    case ENGINE_STATE_LOADING:
         // if (e->world) Renderer_Draw_Board(r, e->world->boards[e->world->boards_current]);
         if (e->ui)
         {
@@ -401,8 +402,8 @@ void Renderer_Update(Renderer *r, Engine *e)
         break;
     case ENGINE_STATE_TITLE:
     case ENGINE_STATE_PLAY:
-        if (e->world)
-            Renderer_Draw_Board(r, e->world, e->world->boards[e->world->boards_current]);
+        if (e->view)
+            Renderer_Draw_Board(r, e->view);
         if (e->ui)
             Renderer_Draw_UI(r, e->ui);
         break;
@@ -0,0 +1,290 @@
+#include "sim_thread.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bzzt.h"
+#include "clock.h"
+#include "debugger.h"
+#include "timing.h"
+#include "ui.h"
+
+#define SNAPSHOT_INDEX_MASK 3
+#define SNAPSHOT_FRESH 4 // Set on the middle slot when it holds a snapshot the reader has not taken
+
+struct Bzzt_Sim_Thread
+{
+    pthread_t thread;
+    int running; // Atomic
+
+    Bzzt_World *world;
+    UI *ui;
+    InputState input; // Simulation-side input, fed from the command queue
+
+    /* Triple buffer: the writer fills back, then swaps it into middle;
+     * the reader swaps middle into front when it is fresh. */
+    Bzzt_Render_Snapshot buffers[3];
+    int back;   // Writer-owned
+    int middle; // Atomic, shared
+    int front;  // Reader-owned
+
+    Bzzt_Sim_Command queue[BZZT_SIM_QUEUE_SIZE];
+    unsigned int queue_head; // Atomic, advanced by the simulation
+    unsigned int queue_tail; // Atomic, advanced by the render thread
+
+    // What the last published snapshot reflected, to skip identical publishes
+    uint64_t published_ticks;
+    bool published_blink, published_paused, published_message_active;
+    int16_t published_message_ticks;
+};
+
+static void sleep_ms(double ms)
+{
+    if (ms <= 0.0)
+        return;
+
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ms / 1000.0);
+    ts.tv_nsec = (long)((ms - (double)ts.tv_sec * 1000.0) * 1000000.0);
+    nanosleep(&ts, NULL);
+}
+
+static void apply_input(InputState *in, const Bzzt_Sim_Input *frame)
+{
+    for (int i = 0; i < frame->buffered_count && in->input_buffer_count < 8; ++i)
+        in->input_buffer[in->input_buffer_count++] = frame->buffered[i];
+
+    memcpy(in->arrow_stack, frame->arrow_stack, sizeof(in->arrow_stack));
+    in->arrow_stack_count = frame->arrow_stack_count;
+
+    // Edges stay latched until the next world update consumes them
+    in->SPACE_pressed = in->SPACE_pressed || frame->SPACE_pressed;
+    in->SHIFT_held = frame->SHIFT_held;
+}
+
+void Bzzt_Sim_Apply_Command(Bzzt_World *w, Bzzt_Sim_Command_Type type)
+{
+    if (!w)
+        return;
+
+    switch (type)
+    {
+    case BZZT_SIM_CMD_PAUSE:
+        Bzzt_World_Set_Pause(w, true);
+        break;
+    case BZZT_SIM_CMD_TOGGLE_INTERPOLATION:
+        Bzzt_World_Toggle_Interpolation(w);
+        break;
+    case BZZT_SIM_CMD_CYCLE_TURBO:
+        Bzzt_World_Cycle_Turbo(w);
+        break;
+    case BZZT_SIM_CMD_TOGGLE_TWO_PHASE:
+        Bzzt_World_Toggle_Two_Phase_Ticking(w);
+        break;
+    case BZZT_SIM_CMD_TOGGLE_PARALLEL:
+        Bzzt_World_Toggle_Parallel_Ticking(w);
+        break;
+    case BZZT_SIM_CMD_INPUT:
+        break;
+    }
+}
+
+static bool drain_commands(Bzzt_Sim_Thread *s)
+{
+    unsigned int head = __atomic_load_n(&s->queue_head, __ATOMIC_RELAXED);
+    unsigned int tail = __atomic_load_n(&s->queue_tail, __ATOMIC_ACQUIRE);
+    bool changed = false;
+
+    while (head != tail)
+    {
+        const Bzzt_Sim_Command *cmd = &s->queue[head & (BZZT_SIM_QUEUE_SIZE - 1)];
+        if (cmd->type == BZZT_SIM_CMD_INPUT)
+        {
+            apply_input(&s->input, &cmd->input);
+        }
+        else
+        {
+            Bzzt_Sim_Apply_Command(s->world, cmd->type);
+            changed = true;
+        }
+        head++;
+    }
+
+    __atomic_store_n(&s->queue_head, head, __ATOMIC_RELEASE);
+    return changed;
+}
+
+static bool push_command(Bzzt_Sim_Thread *s, const Bzzt_Sim_Command *cmd)
+{
+    unsigned int tail = __atomic_load_n(&s->queue_tail, __ATOMIC_RELAXED);
+    unsigned int head = __atomic_load_n(&s->queue_head, __ATOMIC_ACQUIRE);
+
+    if (tail - head >= BZZT_SIM_QUEUE_SIZE)
+        return false;
+
+    s->queue[tail & (BZZT_SIM_QUEUE_SIZE - 1)] = *cmd;
+    __atomic_store_n(&s->queue_tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static void publish_snapshot(Bzzt_Sim_Thread *s)
+{
+    Bzzt_Render_Snapshot *snap = &s->buffers[s->back];
+    if (!Bzzt_Render_Snapshot_Capture(snap, s->world, s->ui))
+        return;
+
+    s->published_ticks = snap->ticks_total;
+    s->published_blink = snap->blink_state;
+    s->published_paused = snap->paused;
+    s->published_message_active = snap->message_active;
+    s->published_message_ticks = snap->message_ticks_remaining;
+
+    int previous = __atomic_exchange_n(&s->middle, s->back | SNAPSHOT_FRESH, __ATOMIC_ACQ_REL);
+    s->back = previous & SNAPSHOT_INDEX_MASK;
+}
+
+static bool world_changed_since_publish(const Bzzt_Sim_Thread *s)
+{
+    const Bzzt_World *w = s->world;
+    const UI *ui = s->ui;
+
+    return (w->timer && w->timer->ticks_total != s->published_ticks) ||
+           w->blink_state != s->published_blink ||
+           w->paused != s->published_paused ||
+           (ui && (ui->message_active != s->published_message_active ||
+                   ui->message_ticks_remaining != s->published_message_ticks));
+}
+
+// Sleep until the next tick is due, but never so long that input sits in the queue
+static double sleep_budget_ms(const Bzzt_World *w)
+{
+    const Bzzt_Timer *t = w->timer;
+    if (!t || t->turbo_mode != BZZT_TURBO_OFF)
+        return 0.0;
+    if (t->paused || !t->schedule_valid)
+        return BZZT_SIM_MAX_SLEEP_MS;
+
+    double next_ms = t->epoch_ms + (double)(t->ticks_since_epoch + 1) * t->tick_duration_ms;
+    double wait_ms = next_ms - Bzzt_Clock_Now_Ms();
+    if (wait_ms > BZZT_SIM_MAX_SLEEP_MS)
+        wait_ms = BZZT_SIM_MAX_SLEEP_MS;
+    return wait_ms;
+}
+
+static void *sim_thread_main(void *arg)
+{
+    Bzzt_Sim_Thread *s = (Bzzt_Sim_Thread *)arg;
+
+    while (__atomic_load_n(&s->running, __ATOMIC_ACQUIRE))
+    {
+        bool changed = drain_commands(s);
+
+        Bzzt_World_Update(s->ui, s->world, &s->input);
+        s->input.SPACE_pressed = false;
+
+        if (changed || world_changed_since_publish(s))
+            publish_snapshot(s);
+
+        sleep_ms(sleep_budget_ms(s->world));
+    }
+
+    return NULL;
+}
+
+Bzzt_Sim_Thread *Bzzt_Sim_Thread_Start(Bzzt_World *w, UI *ui)
+{
+    if (!w)
+        return NULL;
+
+    Bzzt_Sim_Thread *s = calloc(1, sizeof(Bzzt_Sim_Thread));
+    if (!s)
+        return NULL;
+
+    s->world = w;
+    s->ui = ui;
+    s->back = 0;
+    s->front = 2;
+    s->middle = 1;
+
+    // Seed the middle slot before the thread exists so the first frame has something to draw
+    if (Bzzt_Render_Snapshot_Capture(&s->buffers[1], w, ui))
+        s->middle = 1 | SNAPSHOT_FRESH;
+
+    s->running = 1;
+    if (pthread_create(&s->thread, NULL, sim_thread_main, s) != 0)
+    {
+        Debug_Log(LOG_LEVEL_ERROR, LOG_ENGINE, "Failed to create simulation thread.");
+        for (int i = 0; i < 3; ++i)
+            Bzzt_Render_Snapshot_Free(&s->buffers[i]);
+        free(s);
+        return NULL;
+    }
+
+    return s;
+}
+
+void Bzzt_Sim_Thread_Stop(Bzzt_Sim_Thread *s)
+{
+    if (!s)
+        return;
+
+    __atomic_store_n(&s->running, 0, __ATOMIC_RELEASE);
+    pthread_join(s->thread, NULL);
+
+    for (int i = 0; i < 3; ++i)
+        Bzzt_Render_Snapshot_Free(&s->buffers[i]);
+    free(s);
+}
+
+bool Bzzt_Sim_Thread_Push_Input(Bzzt_Sim_Thread *s, InputState *in)
+{
+    if (!s || !in)
+        return false;
+
+    Bzzt_Sim_Command cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.type = BZZT_SIM_CMD_INPUT;
+    cmd.input.buffered_count = in->input_buffer_count;
+    memcpy(cmd.input.buffered, in->input_buffer, sizeof(cmd.input.buffered));
+    cmd.input.arrow_stack_count = in->arrow_stack_count;
+    memcpy(cmd.input.arrow_stack, in->arrow_stack, sizeof(cmd.input.arrow_stack));
+    cmd.input.SPACE_pressed = in->SPACE_pressed;
+    cmd.input.SHIFT_held = in->SHIFT_held;
+
+    if (!push_command(s, &cmd))
+    {
+        Debug_Log(LOG_LEVEL_WARN, LOG_ENGINE, "Simulation input queue full; dropping a frame of input.");
+        return false;
+    }
+
+    // The simulation owns these presses now
+    in->input_buffer_count = 0;
+    return true;
+}
+
+bool Bzzt_Sim_Thread_Push_Command(Bzzt_Sim_Thread *s, Bzzt_Sim_Command_Type type)
+{
+    if (!s)
+        return false;
+
+    Bzzt_Sim_Command cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.type = type;
+    return push_command(s, &cmd);
+}
+
+const Bzzt_Render_Snapshot *Bzzt_Sim_Thread_Acquire_Snapshot(Bzzt_Sim_Thread *s)
+{
+    if (!s)
+        return NULL;
+
+    if (__atomic_load_n(&s->middle, __ATOMIC_ACQUIRE) & SNAPSHOT_FRESH)
+    {
+        int previous = __atomic_exchange_n(&s->middle, s->front, __ATOMIC_ACQ_REL);
+        s->front = previous & SNAPSHOT_INDEX_MASK;
+    }
+
+    const Bzzt_Render_Snapshot *snap = &s->buffers[s->front];
+    return snap->valid ? snap : NULL;
+}
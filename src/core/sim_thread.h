@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "input.h"
+#include "snapshot.h"
+
+#define BZZT_SIM_QUEUE_SIZE 64    // Must be a power of two
+#define BZZT_SIM_MAX_SLEEP_MS 4.0 // Longest the simulation sleeps before checking for input
+
+typedef struct Bzzt_World Bzzt_World;
+typedef struct UI UI;
+
+typedef enum Bzzt_Sim_Command_Type
+{
+    BZZT_SIM_CMD_INPUT,
+    BZZT_SIM_CMD_PAUSE,
+    BZZT_SIM_CMD_TOGGLE_INTERPOLATION,
+    BZZT_SIM_CMD_CYCLE_TURBO,
+    BZZT_SIM_CMD_TOGGLE_TWO_PHASE,
+    BZZT_SIM_CMD_TOGGLE_PARALLEL
+} Bzzt_Sim_Command_Type;
+
+// The part of one frame's input the simulation cares about
+typedef struct Bzzt_Sim_Input
+{
+    ArrowKey buffered[8];
+    int buffered_count;
+    ArrowKey arrow_stack[4];
+    int arrow_stack_count;
+    bool SPACE_pressed;
+    bool SHIFT_held;
+} Bzzt_Sim_Input;
+
+typedef struct Bzzt_Sim_Command
+{
+    Bzzt_Sim_Command_Type type;
+    Bzzt_Sim_Input input;
+} Bzzt_Sim_Command;
+
+/* Runs a world's tick loop on its own thread. The render thread talks to it
+ * only through a single-producer/single-consumer command queue, and reads
+ * results through a triple buffer of render snapshots, so neither side ever
+ * waits on the other. While the thread runs, it owns the world and ui. */
+typedef struct Bzzt_Sim_Thread Bzzt_Sim_Thread;
+
+Bzzt_Sim_Thread *Bzzt_Sim_Thread_Start(Bzzt_World *w, UI *ui);
+// Join the thread; ownership of the world and ui returns to the caller
+void Bzzt_Sim_Thread_Stop(Bzzt_Sim_Thread *s);
+
+// Forward this frame's input. Buffered direction presses are moved out of in.
+bool Bzzt_Sim_Thread_Push_Input(Bzzt_Sim_Thread *s, InputState *in);
+bool Bzzt_Sim_Thread_Push_Command(Bzzt_Sim_Thread *s, Bzzt_Sim_Command_Type type);
+
+// Latest published snapshot. Valid until the next call from the same thread.
+const Bzzt_Render_Snapshot *Bzzt_Sim_Thread_Acquire_Snapshot(Bzzt_Sim_Thread *s);
+
+// Apply a non-input command directly to a world that is not owned by a sim thread
+void Bzzt_Sim_Apply_Command(Bzzt_World *w, Bzzt_Sim_Command_Type type);
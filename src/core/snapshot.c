@@ -0,0 +1,153 @@
+#include "snapshot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "timing.h"
+#include "ui.h"
+
+static bool ensure_capacity(Bzzt_Render_Snapshot *s, size_t cells, int stats)
+{
+    if (cells > s->cells_cap)
+    {
+        Bzzt_Render_Cell *tmp = realloc(s->cells, cells * sizeof(Bzzt_Render_Cell));
+        if (!tmp)
+            return false;
+        s->cells = tmp;
+        s->cells_cap = cells;
+    }
+
+    if (stats > s->stats_cap)
+    {
+        int new_cap = s->stats_cap ? s->stats_cap : 16;
+        while (new_cap < stats)
+            new_cap *= 2;
+        Bzzt_Render_Stat *tmp = realloc(s->stats, (size_t)new_cap * sizeof(Bzzt_Render_Stat));
+        if (!tmp)
+            return false;
+        s->stats = tmp;
+        s->stats_cap = new_cap;
+    }
+    return true;
+}
+
+bool Bzzt_Render_Snapshot_Capture(Bzzt_Render_Snapshot *s, Bzzt_World *w, const UI *ui)
+{
+    if (!s || !w)
+        return false;
+
+    s->valid = false;
+    Bzzt_Board *b = w->boards[w->boards_current];
+    if (!b)
+        return false;
+
+    size_t cell_count = (size_t)b->width * (size_t)b->height;
+    if (!ensure_capacity(s, cell_count, b->stat_count))
+        return false;
+
+    s->width = b->width;
+    s->height = b->height;
+
+    for (int y = 0; y < b->height; ++y)
+    {
+        for (int x = 0; x < b->width; ++x)
+        {
+            Bzzt_Render_Cell *cell = &s->cells[y * b->width + x];
+            Bzzt_Stat *stat = Bzzt_Board_Get_Stat_At(b, x, y);
+            cell->under_stat = stat != NULL;
+            cell->tile = stat ? stat->under : b->tiles[y * b->width + x];
+        }
+    }
+
+    int count = 0;
+    for (int i = 0; i < b->stat_count; ++i)
+    {
+        Bzzt_Stat *stat = b->stats[i];
+        if (!stat || !Bzzt_Board_Is_In_Bounds(b, stat->x, stat->y))
+            continue;
+
+        Bzzt_Render_Stat *out = &s->stats[count++];
+        out->x = stat->x;
+        out->y = stat->y;
+        out->prev_x = stat->prev_x;
+        out->prev_y = stat->prev_y;
+        out->tile = Bzzt_Board_Get_Tile(b, stat->x, stat->y);
+        if (out->tile.element == ZZT_PLAYER)
+            out->tile = Bzzt_World_Get_Player_Render_Tile(w, out->tile);
+    }
+    s->stat_count = count;
+
+    s->allow_blink = w->allow_blink;
+    s->blink_state = w->blink_state;
+    s->paused = w->paused;
+    s->on_title = w->on_title;
+
+    s->interpolate = false;
+    s->last_tick_ms = w->last_frame_time_ms;
+    s->tick_duration_ms = 0.0;
+    s->ticks_total = 0;
+    if (w->timer)
+    {
+        // Turbo frames render only the final tick, and a paused world holds still
+        s->interpolate = w->interpolation_enabled && !w->paused && w->timer->turbo_mode == BZZT_TURBO_OFF;
+        s->last_tick_ms = w->last_frame_time_ms - w->timer->accumulator_ms;
+        s->tick_duration_ms = w->timer->tick_duration_ms;
+        s->ticks_total = w->timer->ticks_total;
+    }
+
+    s->counters.health = w->health;
+    s->counters.ammo = w->ammo;
+    s->counters.gems = w->gems;
+    s->counters.torches = w->torches;
+    s->counters.score = w->score;
+    memcpy(s->counters.keys, w->keys, sizeof(s->counters.keys));
+
+    s->message[0] = '\0';
+    s->message_ticks_remaining = 0;
+    s->message_active = false;
+    if (ui && ui->message_active && ui->message_text)
+    {
+        snprintf(s->message, sizeof(s->message), "%s", ui->message_text);
+        s->message_ticks_remaining = ui->message_ticks_remaining;
+        s->message_active = true;
+    }
+
+    s->valid = true;
+    return true;
+}
+
+void Bzzt_Render_Snapshot_Free(Bzzt_Render_Snapshot *s)
+{
+    if (!s)
+        return;
+    free(s->cells);
+    free(s->stats);
+    memset(s, 0, sizeof(*s));
+}
+
+void Bzzt_Render_Snapshot_Stat_Position(const Bzzt_Render_Snapshot *s, const Bzzt_Render_Stat *stat,
+                                        double now_ms, float *out_x, float *out_y)
+{
+    if (!s || !stat || !out_x || !out_y)
+        return;
+
+#if BZZT_ENABLE_INTERPOLATION
+    if (s->interpolate && s->tick_duration_ms > 0.0)
+    {
+        double t = (now_ms - s->last_tick_ms) / s->tick_duration_ms;
+        if (t < 0.0)
+            t = 0.0;
+        if (t > 1.0)
+            t = 1.0;
+
+        *out_x = (float)stat->prev_x + (float)(stat->x - stat->prev_x) * (float)t;
+        *out_y = (float)stat->prev_y + (float)(stat->y - stat->prev_y) * (float)t;
+        return;
+    }
+#else
+    (void)now_ms;
+#endif
+
+    *out_x = (float)stat->x;
+    *out_y = (float)stat->y;
+}
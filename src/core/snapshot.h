@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "bzzt.h"
+
+// HUD values the sidebar binds to
+typedef struct Bzzt_Render_Counters
+{
+    int16_t health, ammo, gems, torches, score;
+    uint8_t keys[7];
+} Bzzt_Render_Counters;
+
+// One board cell as the renderer sees it: either the board tile, or the
+// tile under a stat when a stat stands there
+typedef struct Bzzt_Render_Cell
+{
+    Bzzt_Tile tile;
+    bool under_stat;
+} Bzzt_Render_Cell;
+
+typedef struct Bzzt_Render_Stat
+{
+    int x, y, prev_x, prev_y;
+    Bzzt_Tile tile; // Resolved tile at the stat's logical position
+} Bzzt_Render_Stat;
+
+/* Everything needed to draw one frame of a world, copied out of the
+ * simulation so the renderer never touches live world state. */
+typedef struct Bzzt_Render_Snapshot
+{
+    bool valid;
+    int width, height;
+    Bzzt_Render_Cell *cells;
+    size_t cells_cap;
+    Bzzt_Render_Stat *stats;
+    int stat_count, stats_cap;
+
+    bool allow_blink, blink_state;
+    bool paused, on_title;
+
+    bool interpolate;
+    double last_tick_ms; // Monotonic time of the last tick's deadline
+    double tick_duration_ms;
+    uint64_t ticks_total;
+
+    Bzzt_Render_Counters counters;
+
+    char message[64];
+    int16_t message_ticks_remaining;
+    bool message_active;
+} Bzzt_Render_Snapshot;
+
+// Copy the current board and HUD state of a world (and the message state of ui) into s.
+bool Bzzt_Render_Snapshot_Capture(Bzzt_Render_Snapshot *s, Bzzt_World *w, const UI *ui);
+void Bzzt_Render_Snapshot_Free(Bzzt_Render_Snapshot *s);
+
+// Where to draw a stat at time now_ms, blending between ticks when interpolation is on.
+void Bzzt_Render_Snapshot_Stat_Position(const Bzzt_Render_Snapshot *s, const Bzzt_Render_Stat *stat,
+                                        double now_ms, float *out_x, float *out_y);
@@ -32,6 +32,7 @@ static Direction direction_from_stat_step(Bzzt_Stat *stat);
 void zzt_player_tick(UI *ui, Bzzt_World *w, Bzzt_Stat *player_stat);
 void zzt_bullet_tick(UI *ui, Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat);
 static void zzt_star_tick(UI *ui, Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat);
+static void star_tick_toward(UI *ui, Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat, Direction planned_dir);
 void zzt_spinninggun_tick(Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat, Bzzt_Tile tile);
 static bool transporter_try_move_stat(Bzzt_Board *b, Bzzt_Stat *stat, int transporter_x, int transporter_y, Direction move_dir);
 void push_tile(Bzzt_Board *b, Direction direction, Bzzt_Tile tile);
@@ -181,44 +182,36 @@ static bool handle_board_edge_move(Bzzt_World *w, UI *ui, int new_x, int new_y)
         return false;
 
     Bzzt_Board *old_board = w->boards[w->boards_current];
-    Bzzt_Board *new_board;
     Bzzt_Stat *old_player = old_board->stats[0];
 
     uint8_t next_board_idx = 0;
-    int entry_x, entry_y;
-
     if (new_x < 0)
-    {
         next_board_idx = old_board->board_w;
-        new_board = w->boards[next_board_idx];
-        entry_x = new_board->width - 1;
-        entry_y = old_player->y;
-    }
     else if (new_x >= old_board->width)
-    {
         next_board_idx = old_board->board_e;
-        new_board = w->boards[next_board_idx];
-        entry_x = 0;
-        entry_y = old_player->y;
-    }
     else if (new_y < 0)
-    {
         next_board_idx = old_board->board_n;
-        new_board = w->boards[next_board_idx];
-        entry_x = old_player->x;
-        entry_y = new_board->height - 1;
-    }
     else if (new_y >= old_board->height)
-    {
         next_board_idx = old_board->board_s;
-        new_board = w->boards[next_board_idx];
-        entry_x = old_player->x;
-        entry_y = 0;
-    }
 
     if (next_board_idx <= 0 || next_board_idx >= w->boards_count)
         return false; // board idx invalid?
 
+    Bzzt_Board *new_board = Bzzt_World_Get_Board(w, next_board_idx);
+    if (!new_board)
+        return false;
+
+    int entry_x = old_player->x;
+    int entry_y = old_player->y;
+    if (new_x < 0)
+        entry_x = new_board->width - 1;
+    else if (new_x >= old_board->width)
+        entry_x = 0;
+    else if (new_y < 0)
+        entry_y = new_board->height - 1;
+    else
+        entry_y = 0;
+
     Bzzt_Board_Set_Tile(old_board, old_player->x, old_player->y, old_player->under);
 
     return Bzzt_World_Switch_Board_To(w, next_board_idx, entry_x, entry_y);
@@ -245,7 +238,9 @@ static uint8_t handle_passage_touch(Bzzt_World *w, int x, int y)
     if (target_board_idx <= 0 || target_board_idx >= w->boards_count)
         return 0;
 
-    Bzzt_Board *target_board = w->boards[target_board_idx];
+    Bzzt_Board *target_board = Bzzt_World_Get_Board(w, target_board_idx);
+    if (!target_board)
+        return 0;
 
     Bzzt_Tile passage_tile = Bzzt_Board_Get_Tile(current_board, passage->x, passage->y);
     Color_Bzzt passage_fg = passage_tile.fg;
@@ -632,7 +627,7 @@ static bool bomb_element_is_destructible(uint8_t elem)
     }
 }
 
-static void spawn_bomb_blast_tile(Bzzt_Board *b, int x, int y)
+static void spawn_bomb_blast_tile(Bzzt_World *w, Bzzt_Board *b, int x, int y)
 {
     const ZZT_Element_Defaults *breakable_def = zzt_get_element_defaults(ZZT_BREAKABLE);
     if (!b || !breakable_def)
@@ -641,7 +636,7 @@ static void spawn_bomb_blast_tile(Bzzt_Board *b, int x, int y)
     Bzzt_Tile blast_tile = Bzzt_Board_Get_Tile(b, x, y);
     blast_tile.element = ZZT_BREAKABLE;
     blast_tile.glyph = breakable_def->default_glyph;
-    blast_tile.fg = bzzt_get_color(9 + (rand() % 7));
+    blast_tile.fg = bzzt_get_color(9 + (int)Bzzt_World_Random(w, 7));
     blast_tile.bg = COLOR_BLACK;
     blast_tile.visible = true;
     blast_tile.blink = false;
@@ -1038,6 +1033,7 @@ static Bzzt_Stat *clone_stat_for_duplication(Bzzt_Stat *source, Bzzt_Tile under,
     clone->under = under;
     clone->leader = -1;
     clone->follower = -1;
+    clone->intent_slot = -1;
 
     if (source->program && source->program_length > 0)
     {
@@ -1429,7 +1425,7 @@ static void zzt_bomb_explode(UI *ui, Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *bo
                 }
 
                 if (spawn_blast)
-                    spawn_bomb_blast_tile(b, tx, ty);
+                    spawn_bomb_blast_tile(w, b, tx, ty);
                 continue;
             }
 
@@ -1444,7 +1440,7 @@ static void zzt_bomb_explode(UI *ui, Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *bo
             }
 
             if (spawn_blast)
-                spawn_bomb_blast_tile(b, tx, ty);
+                spawn_bomb_blast_tile(w, b, tx, ty);
         }
     }
 }
@@ -1503,40 +1499,27 @@ static void zzt_bomb_tick(UI *ui, Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat)
     Bzzt_Board_Set_Tile(b, stat->x, stat->y, tile);
 }
 
-// tbd
-static void zzt_pusher_tick(Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat)
+static Direction pusher_direction(Bzzt_Stat *stat)
 {
-    (void)w;
-
-    Direction dir;
-    int dx = 0;
-    int dy = 0;
-
     if (stat->step_x > 0)
-    {
-        dir = DIR_RIGHT;
-        dx = 1;
-    }
-    else if (stat->step_x < 0)
-    {
-        dir = DIR_LEFT;
-        dx = -1;
-    }
-    else if (stat->step_y > 0)
-    {
-        dir = DIR_DOWN;
-        dy = 1;
-    }
-    else if (stat->step_y < 0)
-    {
-        dir = DIR_UP;
-        dy = -1;
-    }
-    else
+        return DIR_RIGHT;
+    if (stat->step_x < 0)
+        return DIR_LEFT;
+    if (stat->step_y > 0)
+        return DIR_DOWN;
+    if (stat->step_y < 0)
+        return DIR_UP;
+    return DIR_NONE;
+}
+
+static void pusher_push(Bzzt_Board *b, Bzzt_Stat *stat, Direction dir)
+{
+    if (dir == DIR_NONE)
         return;
 
-    int next_x = stat->x + dx;
-    int next_y = stat->y + dy;
+    Vector2 vec = vector2_from_direction(dir);
+    int next_x = stat->x + (int)vec.x;
+    int next_y = stat->y + (int)vec.y;
 
     if (!Bzzt_Board_Is_In_Bounds(b, next_x, next_y))
         return;
@@ -1550,6 +1533,13 @@ static void zzt_pusher_tick(Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat)
         Bzzt_Board_Move_Stat_To(b, stat, next_x, next_y);
 }
 
+// tbd
+static void zzt_pusher_tick(Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat)
+{
+    (void)w;
+    pusher_push(b, stat, pusher_direction(stat));
+}
+
 static void stat_tick(UI *ui, Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat)
 {
     if (!w || !b || !stat)
@@ -1770,7 +1760,13 @@ void zzt_bullet_tick(UI *ui, Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat)
 
 static void zzt_star_tick(UI *ui, Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat)
 {
-    if (!ui || !w || !b || !stat)
+    star_tick_toward(ui, w, b, stat, DIR_NONE);
+}
+
+// planned_dir is the seek direction worked out during a two-phase plan, or DIR_NONE to seek now
+static void star_tick_toward(UI *ui, Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat, Direction planned_dir)
+{
+    if (!w || !b || !stat)
         return;
 
     update_star_appearance(w, b, stat);
@@ -1787,7 +1783,7 @@ static void zzt_star_tick(UI *ui, Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat)
     if (stat->data[1] == 0)
         return;
 
-    Direction seek_dir = Gameplay_Seek_Direction_To_Player(w, b, stat);
+    Direction seek_dir = planned_dir != DIR_NONE ? planned_dir : Gameplay_Seek_Direction_To_Player(w, b, stat);
     Vector2 vec = vector2_from_direction(seek_dir);
     stat->step_x = (int)vec.x;
     stat->step_y = (int)vec.y;
@@ -1839,30 +1835,33 @@ static void zzt_star_tick(UI *ui, Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat)
     }
 }
 
-void zzt_spinninggun_tick(Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat, Bzzt_Tile tile)
+static void spinninggun_animate(Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat, Bzzt_Tile tile)
 {
     int anim_phase = (w->timer->current_tick / 2) % 4;
     tile.glyph = (anim_phase == 0) ? 24 : (anim_phase == 1) ? 26
                                       : (anim_phase == 2)   ? 25
                                                             : 27;
     Bzzt_Board_Set_Tile(b, stat->x, stat->y, tile);
+}
 
+// Pick a firing direction for this tick, or DIR_NONE. Only reads the board.
+static Direction spinninggun_choose_fire(Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat, uint32_t *rng)
+{
     int fire_rate = stat->data[1] & 0x7F;
-    bool fires_stars = (stat->data[1] & 0x80) != 0;
     if (fire_rate > 8)
         fire_rate = 8;
 
     double chance_of_fire = (double)fire_rate / 9.0;
     double chance_of_smart_fire = (double)(stat->data[0] + 1) / 9.0;
-    double roll = ((double)rand()) / RAND_MAX;
-    double roll_smart = ((double)rand()) / RAND_MAX;
+    double roll = Bzzt_Random_Unit(rng);
+    double roll_smart = Bzzt_Random_Unit(rng);
 
     bool should_fire = roll < chance_of_fire;
     bool fire_intelligently = roll_smart < chance_of_smart_fire && should_fire;
+    Direction fire_dir = DIR_NONE;
 
     if (should_fire)
     {
-        Direction fire_dir = DIR_NONE;
         Bzzt_Stat *player = b->stats[0];
 
         if (player && fire_intelligently)
@@ -1893,27 +1892,39 @@ void zzt_spinninggun_tick(Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat, Bzzt_Ti
 
             if (fire_dir == DIR_NONE)
             {
-                int random_dir = rand() % 4;
+                int random_dir = (int)Bzzt_Random_Next(rng, 4);
                 fire_dir = (random_dir == 0) ? DIR_UP : (random_dir == 1) ? DIR_RIGHT
                                                     : (random_dir == 2)   ? DIR_DOWN
                                                                           : DIR_LEFT;
             }
         }
-        else if (should_fire)
+        else
         {
-            int random_dir = rand() % 4;
+            int random_dir = (int)Bzzt_Random_Next(rng, 4);
             fire_dir = (random_dir == 0) ? DIR_UP : (random_dir == 1) ? DIR_RIGHT
                                                 : (random_dir == 2)   ? DIR_DOWN
                                                                       : DIR_LEFT;
         }
-        if (fire_dir != DIR_NONE)
-        {
-            if (fires_stars)
-                Bzzt_Stat_Fire_Projectile(b, stat, fire_dir, ZZT_STAR, 100);
-            else
-                Bzzt_Stat_Shoot(b, stat, fire_dir);
-        }
     }
+
+    return fire_dir;
+}
+
+static void spinninggun_fire(Bzzt_Board *b, Bzzt_Stat *stat, Direction fire_dir)
+{
+    if (fire_dir == DIR_NONE)
+        return;
+
+    if (stat->data[1] & 0x80)
+        Bzzt_Stat_Fire_Projectile(b, stat, fire_dir, ZZT_STAR, 100);
+    else
+        Bzzt_Stat_Shoot(b, stat, fire_dir);
+}
+
+void zzt_spinninggun_tick(Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat, Bzzt_Tile tile)
+{
+    spinninggun_animate(w, b, stat, tile);
+    spinninggun_fire(b, stat, spinninggun_choose_fire(w, b, stat, &w->rng_state));
 }
 
 void zzt_player_tick(UI *ui, Bzzt_World *w, Bzzt_Stat *player_stat)
@@ -1943,6 +1954,7 @@ Bzzt_Stat *Bzzt_Stat_Create(Bzzt_Board *b, int x, int y)
     s->data_label[2] = 0;
     s->follower = -1;
     s->leader = -1;
+    s->intent_slot = -1;
     s->under = Bzzt_Board_Get_Tile(b, x, y);
     s->program = NULL;
     s->program_length = 0;
@@ -1972,6 +1984,129 @@ void Bzzt_Stat_Update(UI *ui, Bzzt_World *w, Bzzt_Stat *stat, int stat_idx)
         stat_tick(ui, w, current_board, stat);
 }
 
+static bool bullet_can_pass(uint8_t element)
+{
+    return element == ZZT_EMPTY || element == ZZT_FAKE || element == ZZT_WATER;
+}
+
+static void plan_move(Bzzt_Board *b, Bzzt_Stat *stat, Direction dir, Bzzt_Stat_Intent *out)
+{
+    Vector2 vec = vector2_from_direction(dir);
+    out->type = BZZT_INTENT_MOVE;
+    out->dir = dir;
+    out->to_x = stat->x + (int)vec.x;
+    out->to_y = stat->y + (int)vec.y;
+    out->seen_element = Bzzt_Board_Get_Tile(b, out->to_x, out->to_y).element;
+}
+
+void Bzzt_Stat_Plan(Bzzt_World *w, Bzzt_Board *b, Bzzt_Stat *stat, int stat_idx, Bzzt_Stat_Intent *out)
+{
+    memset(out, 0, sizeof(*out));
+    out->type = BZZT_INTENT_NONE;
+    if (!w || !b || !stat || !Bzzt_Board_Is_In_Bounds(b, stat->x, stat->y) || !stat_can_act(w, stat, stat_idx))
+        return;
+
+    out->from_x = stat->x;
+    out->from_y = stat->y;
+    out->player_x = b->stat_count > 0 && b->stats[0] ? b->stats[0]->x : -1;
+    out->player_y = b->stat_count > 0 && b->stats[0] ? b->stats[0]->y : -1;
+    out->type = BZZT_INTENT_SERIAL;
+
+    Bzzt_Tile tile = Bzzt_Board_Get_Tile(b, stat->x, stat->y);
+    switch (tile.element)
+    {
+    case ZZT_BULLET:
+    {
+        Direction dir = direction_from_stat_step(stat);
+        int next_x = stat->x + stat->step_x;
+        int next_y = stat->y + stat->step_y;
+        // Collisions, transporters and the board edge go through the normal tick
+        if (dir != DIR_NONE && Bzzt_Board_Is_In_Bounds(b, next_x, next_y) &&
+            bullet_can_pass(Bzzt_Board_Get_Tile(b, next_x, next_y).element))
+            plan_move(b, stat, dir, out);
+        break;
+    }
+
+    case ZZT_STAR:
+        /* Only the seek is planned; the star's own counters update during resolve.
+         * The serial tick seeks when the star outlives its lifetime decrement
+         * (data[0] > 1 before it) and data[1] ^= 1 leaves it non-zero, which
+         * is every value but 1 */
+        if (stat->data[0] > 1 && stat->data[1] != 1)
+            plan_move(b, stat, Gameplay_Seek_Direction_To_Player(w, b, stat), out);
+        break;
+
+    /* Spinning guns stay serial: their rolls come from the world RNG, and
+     * only drawing them in stat order gives the serial tick's shots */
+    case ZZT_PUSHER:
+        out->type = BZZT_INTENT_PUSH;
+        out->dir = pusher_direction(stat);
+        break;
+
+    default:
+        break;
+    }
+}
+
+void Bzzt_Stat_Resolve(UI *ui, Bzzt_World *w, Bzzt_Stat *stat, int stat_idx, const Bzzt_Stat_Intent *intent)
+{
+    if (!w || !stat || !intent)
+        return;
+
+    Bzzt_Board *b = w->boards[w->boards_current];
+    if (!b || !Bzzt_Board_Is_In_Bounds(b, stat->x, stat->y))
+        return;
+
+    // Whether it acts goes by where it sits now; a stat removed earlier in the tick shifts the rest down
+    if (!stat_can_act(w, stat, stat_idx))
+        return;
+
+    // Something moved this stat after it was planned, or it wasn't due to act at its planned index
+    bool stale = stat->x != intent->from_x || stat->y != intent->from_y;
+    if (intent->type == BZZT_INTENT_NONE || intent->type == BZZT_INTENT_SERIAL || stale)
+    {
+        stat_tick(ui, w, b, stat);
+        return;
+    }
+
+    Bzzt_Tile tile = Bzzt_Board_Get_Tile(b, stat->x, stat->y);
+    // Stars seek the player; a pusher may have moved it since
+    bool player_moved = b->stat_count <= 0 || !b->stats[0] || b->stats[0]->x != intent->player_x ||
+                        b->stats[0]->y != intent->player_y;
+
+    switch (intent->type)
+    {
+    case BZZT_INTENT_MOVE:
+        if (tile.element == ZZT_STAR)
+        {
+            star_tick_toward(ui, w, b, stat, player_moved ? DIR_NONE : intent->dir);
+            return;
+        }
+
+        // An earlier stat took or changed the target cell; redo this bullet against the live board
+        if (tile.element != ZZT_BULLET ||
+            Bzzt_Board_Get_Tile(b, intent->to_x, intent->to_y).element != intent->seen_element)
+        {
+            stat_tick(ui, w, b, stat);
+            return;
+        }
+        Bzzt_Board_Move_Stat_To(b, stat, intent->to_x, intent->to_y);
+        return;
+
+    case BZZT_INTENT_PUSH:
+        if (tile.element != ZZT_PUSHER)
+        {
+            stat_tick(ui, w, b, stat);
+            return;
+        }
+        pusher_push(b, stat, intent->dir);
+        return;
+
+    default:
+        return;
+    }
+}
+
 bool Bzzt_Tile_Is_Walkable(Bzzt_World *w, Bzzt_Tile tile)
 {
     switch (tile.element)
@@ -2218,6 +2353,7 @@ Bzzt_Stat *Bzzt_Stat_From_ZZT_Param(ZZTparam *param, ZZTtile tile, int x, int y)
 
     stat->follower = param->followerindex;
     stat->leader = param->leaderindex;
+    stat->intent_slot = -1;
 
     stat->under.element = param->utype;
     stat->under.glyph = zzt_type_to_cp437(param->utype, param->ucolor);
@@ -2257,36 +2393,3 @@ Bzzt_Stat *Bzzt_Stat_From_ZZT_Param(ZZTparam *param, ZZTtile tile, int x, int y)
 
     return stat;
 }
-
-// cursed and forbidden
-void Bzzt_Get_Interpolated_Position(Bzzt_World *w, Bzzt_Stat *stat, float *out_x, float *out_y)
-{
-    if (!w || !stat || !out_x || !out_y)
-        return;
-
-#if BZZT_ENABLE_INTERPOLATION
-    if (w->interpolation_enabled && w->timer)
-    {
-        // Calculate interpolation factor (0.0 to 1.0)
-        double t = w->timer->accumulator_ms / w->timer->tick_duration_ms;
-
-        // Clamp to valid range
-        if (t < 0.0)
-            t = 0.0;
-        if (t > 1.0)
-            t = 1.0;
-
-        // Linear interpolation between prev and current position
-        *out_x = (float)stat->prev_x + (float)(stat->x - stat->prev_x) *
-                                           (float)t;
-        *out_y = (float)stat->prev_y + (float)(stat->y - stat->prev_y) *
-                                           (float)t;
-    }
-    else
-#endif
-    {
-        // No interpolation - use exact position
-        *out_x = (float)stat->x;
-        *out_y = (float)stat->y;
-    }
-}
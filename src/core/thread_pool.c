@@ -0,0 +1,207 @@
+#include "thread_pool.h"
+
+#include <stdlib.h>
+#include "debugger.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define THREAD_POOL_MAX_THREADS 64
+
+typedef struct Bzzt_Job
+{
+    Bzzt_Job_Fn fn;
+    void *arg;
+    Bzzt_Job_Group *group;
+    struct Bzzt_Job *next;
+} Bzzt_Job;
+
+struct Bzzt_Thread_Pool
+{
+    pthread_t *threads;
+    int thread_count;
+
+    pthread_mutex_t lock;
+    pthread_cond_t has_work;
+    Bzzt_Job *head, *tail;
+    bool stopping;
+};
+
+int Bzzt_Cpu_Count(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int count = (int)info.dwNumberOfProcessors;
+#else
+    int count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return count > 0 ? count : 1;
+}
+
+static void job_group_finish(Bzzt_Job_Group *g)
+{
+    if (!g)
+        return;
+
+    pthread_mutex_lock(&g->lock);
+    if (--g->pending == 0)
+        pthread_cond_broadcast(&g->done);
+    pthread_mutex_unlock(&g->lock);
+}
+
+static void *worker_main(void *arg)
+{
+    Bzzt_Thread_Pool *p = (Bzzt_Thread_Pool *)arg;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&p->lock);
+        while (!p->head && !p->stopping)
+            pthread_cond_wait(&p->has_work, &p->lock);
+
+        Bzzt_Job *job = p->head;
+        if (!job)
+        {
+            // Stopping and the queue is drained
+            pthread_mutex_unlock(&p->lock);
+            return NULL;
+        }
+
+        p->head = job->next;
+        if (!p->head)
+            p->tail = NULL;
+        pthread_mutex_unlock(&p->lock);
+
+        job->fn(job->arg);
+        job_group_finish(job->group);
+        free(job);
+    }
+}
+
+Bzzt_Thread_Pool *Bzzt_Thread_Pool_Create(int threads)
+{
+    if (threads <= 0)
+        threads = Bzzt_Cpu_Count();
+    if (threads > THREAD_POOL_MAX_THREADS)
+        threads = THREAD_POOL_MAX_THREADS;
+
+    Bzzt_Thread_Pool *p = calloc(1, sizeof(Bzzt_Thread_Pool));
+    if (!p)
+        return NULL;
+
+    p->threads = calloc((size_t)threads, sizeof(pthread_t));
+    if (!p->threads)
+    {
+        free(p);
+        return NULL;
+    }
+
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->has_work, NULL);
+
+    for (int i = 0; i < threads; ++i)
+    {
+        if (pthread_create(&p->threads[i], NULL, worker_main, p) != 0)
+        {
+            Debug_Log(LOG_LEVEL_WARN, LOG_ENGINE, "Thread pool started %d of %d workers.", i, threads);
+            break;
+        }
+        p->thread_count++;
+    }
+
+    if (p->thread_count == 0)
+    {
+        Bzzt_Thread_Pool_Destroy(p);
+        return NULL;
+    }
+
+    return p;
+}
+
+void Bzzt_Thread_Pool_Destroy(Bzzt_Thread_Pool *p)
+{
+    if (!p)
+        return;
+
+    pthread_mutex_lock(&p->lock);
+    p->stopping = true;
+    pthread_cond_broadcast(&p->has_work);
+    pthread_mutex_unlock(&p->lock);
+
+    for (int i = 0; i < p->thread_count; ++i)
+        pthread_join(p->threads[i], NULL);
+
+    pthread_cond_destroy(&p->has_work);
+    pthread_mutex_destroy(&p->lock);
+    free(p->threads);
+    free(p);
+}
+
+int Bzzt_Thread_Pool_Size(const Bzzt_Thread_Pool *p)
+{
+    return p ? p->thread_count : 0;
+}
+
+bool Bzzt_Thread_Pool_Submit(Bzzt_Thread_Pool *p, Bzzt_Job_Group *group, Bzzt_Job_Fn fn, void *arg)
+{
+    if (!p || !fn)
+        return false;
+
+    Bzzt_Job *job = malloc(sizeof(Bzzt_Job));
+    if (!job)
+        return false;
+    job->fn = fn;
+    job->arg = arg;
+    job->group = group;
+    job->next = NULL;
+
+    if (group)
+    {
+        pthread_mutex_lock(&group->lock);
+        group->pending++;
+        pthread_mutex_unlock(&group->lock);
+    }
+
+    pthread_mutex_lock(&p->lock);
+    if (p->tail)
+        p->tail->next = job;
+    else
+        p->head = job;
+    p->tail = job;
+    pthread_cond_signal(&p->has_work);
+    pthread_mutex_unlock(&p->lock);
+
+    return true;
+}
+
+void Bzzt_Job_Group_Init(Bzzt_Job_Group *g)
+{
+    if (!g)
+        return;
+    pthread_mutex_init(&g->lock, NULL);
+    pthread_cond_init(&g->done, NULL);
+    g->pending = 0;
+}
+
+void Bzzt_Job_Group_Destroy(Bzzt_Job_Group *g)
+{
+    if (!g)
+        return;
+    pthread_cond_destroy(&g->done);
+    pthread_mutex_destroy(&g->lock);
+}
+
+void Bzzt_Job_Group_Wait(Bzzt_Job_Group *g)
+{
+    if (!g)
+        return;
+
+    pthread_mutex_lock(&g->lock);
+    while (g->pending > 0)
+        pthread_cond_wait(&g->done, &g->lock);
+    pthread_mutex_unlock(&g->lock);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <pthread.h>
+#include <stdbool.h>
+
+typedef void (*Bzzt_Job_Fn)(void *arg);
+
+// Tracks a batch of submitted jobs so the submitter can wait for just that batch
+typedef struct Bzzt_Job_Group
+{
+    pthread_mutex_t lock;
+    pthread_cond_t done;
+    int pending;
+} Bzzt_Job_Group;
+
+typedef struct Bzzt_Thread_Pool Bzzt_Thread_Pool;
+
+// Number of online CPUs, at least 1
+int Bzzt_Cpu_Count(void);
+
+// Start a pool with the given number of workers (<= 0 picks one per CPU)
+Bzzt_Thread_Pool *Bzzt_Thread_Pool_Create(int threads);
+// Finish queued jobs, then join all workers
+void Bzzt_Thread_Pool_Destroy(Bzzt_Thread_Pool *p);
+int Bzzt_Thread_Pool_Size(const Bzzt_Thread_Pool *p);
+
+// Queue fn(arg) on a worker. group may be NULL for fire-and-forget jobs.
+bool Bzzt_Thread_Pool_Submit(Bzzt_Thread_Pool *p, Bzzt_Job_Group *group, Bzzt_Job_Fn fn, void *arg);
+
+void Bzzt_Job_Group_Init(Bzzt_Job_Group *g);
+void Bzzt_Job_Group_Destroy(Bzzt_Job_Group *g);
+// Block until every job submitted with this group has finished
+void Bzzt_Job_Group_Wait(Bzzt_Job_Group *g);
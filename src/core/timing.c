@@ -1,7 +1,18 @@
 #include "timing.h"
 #include "bzzt.h"
-#include "engine.h"
 #include "ui.h"
+#include "clock.h"
+#include "debugger.h"
+#include "thread_pool.h"
+
+#include <math.h>
+#include <string.h>
+
+/* ZZT waits GameSpeed * 2 hundredths of a second between ticks, but it reads
+ * time from the 18.2 Hz BIOS timer, so the real period is that wait rounded up
+ * to whole timer ticks. Speed 0 is unthrottled in DOS; here it is capped at
+ * one timer tick so it stays watchable. Index is the normalized game speed. */
+static const int speed_pit_ticks[9] = {1, 1, 1, 2, 2, 2, 3, 3, 3};
 
 void Bzzt_Timer_Tick(Bzzt_Timer *t)
 {
@@ -14,30 +25,407 @@ void Bzzt_Timer_Tick(Bzzt_Timer *t)
         t->current_tick++;
 }
 
-void Bzzt_Timer_Run_Frame(Engine *e, Bzzt_World *w, double frame_ms)
+/* Fast-forward: ignore wall-clock pacing and run ticks back to back, either
+ * until the per-frame budget is spent or a fixed count has run. Only the state
+ * after the last tick is rendered. */
+static void run_turbo_frame(UI *ui, Bzzt_World *w)
+{
+    Bzzt_Timer *t = w->timer;
+    int ticks = 0;
+
+    if (t->turbo_mode == BZZT_TURBO_FIXED)
+    {
+        while (ticks < t->turbo_ticks_per_frame)
+        {
+            Bzzt_Timer_Run_Tick(ui, w);
+            ticks++;
+            if (w->paused)
+                break;
+        }
+    }
+    else
+    {
+        double start_ms = Bzzt_Clock_Now_Ms();
+        do
+        {
+            Bzzt_Timer_Run_Tick(ui, w);
+            ticks++;
+        } while (!w->paused && Bzzt_Clock_Now_Ms() - start_ms < t->turbo_budget_ms);
+    }
+
+    t->accumulator_ms = 0.0;
+    t->turbo_ticks_last_frame = ticks;
+    t->schedule_valid = false;
+}
+
+static double next_deadline_ms(const Bzzt_Timer *t)
+{
+    return t->epoch_ms + (double)(t->ticks_since_epoch + 1) * t->tick_duration_ms;
+}
+
+static void record_tick(Bzzt_Timer *t, double deadline_ms)
+{
+    double start_ms = Bzzt_Clock_Now_Ms();
+    Bzzt_Timer_Sample *sample = &t->history[t->history_head];
+
+    sample->start_ms = start_ms;
+    sample->late_ms = start_ms - deadline_ms;
+    t->history_head = (t->history_head + 1) % BZZT_TIMER_HISTORY;
+    if (t->history_count < BZZT_TIMER_HISTORY)
+        t->history_count++;
+}
+
+static void report_stats(Bzzt_Timer *t, double now_ms)
+{
+    if (now_ms - t->last_report_ms < BZZT_TIMER_REPORT_INTERVAL_MS)
+        return;
+    t->last_report_ms = now_ms;
+
+    Bzzt_Timer_Stats stats;
+    Bzzt_Timer_Get_Stats(t, &stats);
+    if (stats.samples < 2)
+        return;
+
+    Debug_Log(LOG_LEVEL_DEBUG, LOG_ENGINE,
+              "Tick rate %.2f Hz (target %.2f Hz), jitter %.2f ms, max late %.2f ms, %u dropped",
+              stats.actual_hz, stats.target_hz, stats.jitter_ms, stats.max_late_ms, stats.ticks_dropped);
+}
+
+void Bzzt_Timer_Run_Frame(UI *ui, Bzzt_World *w, double now_ms)
 {
     if (!w || !w->timer)
         return;
 
-    if (w->timer->paused)
+    Bzzt_Timer *t = w->timer;
+
+    if (t->paused)
     {
-        if (e->ui && e->ui->message_active)
-            UI_Update_Message_Timer(e->ui);
+        t->schedule_valid = false;
+        if (ui && ui->message_active)
+            UI_Update_Message_Timer(ui);
         return;
     }
 
-    w->timer->accumulator_ms += frame_ms;
-    while (w->timer->accumulator_ms >= w->timer->tick_duration_ms)
+    if (w->game_speed != t->game_speed)
+        Bzzt_Timer_Set_Speed(t, w->game_speed);
+
+    if (t->turbo_mode != BZZT_TURBO_OFF)
+    {
+        run_turbo_frame(ui, w);
+        return;
+    }
+
+    if (!t->schedule_valid)
+    {
+        t->epoch_ms = now_ms;
+        t->ticks_since_epoch = 0;
+        t->schedule_valid = true;
+    }
+
+    int ran = 0;
+    double deadline_ms = next_deadline_ms(t);
+    while (now_ms >= deadline_ms)
     {
-        w->timer->accumulator_ms -= Bzzt_Timer_Run_Tick(e, w);
+        // Catch-up policy: run a bounded burst, then drop whatever is still
+        // owed instead of fast-forwarding through it after a long stall.
+        if (ran >= BZZT_TIMER_MAX_CATCHUP_TICKS)
+        {
+            double owed = floor((now_ms - t->epoch_ms) / t->tick_duration_ms) - (double)t->ticks_since_epoch;
+            if (owed > 0.0)
+                t->ticks_dropped += (uint32_t)owed;
+            t->epoch_ms = now_ms;
+            t->ticks_since_epoch = 0;
+            break;
+        }
+
+        record_tick(t, deadline_ms);
+        Bzzt_Timer_Run_Tick(ui, w);
+        t->ticks_since_epoch++;
+        ran++;
         if (w->paused)
             break;
+        deadline_ms = next_deadline_ms(t);
+    }
+
+    t->accumulator_ms = now_ms - (t->epoch_ms + (double)t->ticks_since_epoch * t->tick_duration_ms);
+    if (t->accumulator_ms < 0.0)
+        t->accumulator_ms = 0.0;
+
+    report_stats(t, now_ms);
+}
+
+static void record_prev_positions(Bzzt_Board *board)
+{
+    for (int i = 0; i < board->stat_count; ++i)
+    {
+        Bzzt_Stat *stat = board->stats[i];
+        if (stat)
+        {
+            stat->prev_x = stat->x;
+            stat->prev_y = stat->y;
+        }
+    }
+}
+
+// Tick stat i and return the next index to tick: i again if the tick removed a stat
+static int tick_stat_serially(UI *ui, Bzzt_World *w, Bzzt_Board *board, int i)
+{
+    Bzzt_Stat *stat = board->stats[i];
+    if (!stat)
+        return i + 1;
+
+    int count_before = board->stat_count;
+    Bzzt_Stat_Update(ui, w, stat, i);
+    return board->stat_count < count_before ? i : i + 1;
+}
+
+static void tick_board_stats(UI *ui, Bzzt_World *w, Bzzt_Board *board)
+{
+    record_prev_positions(board);
+    for (int i = 0; i < board->stat_count;)
+        i = tick_stat_serially(ui, w, board, i);
+}
+
+typedef struct Plan_Job
+{
+    Bzzt_World *w;
+    Bzzt_Board *board;
+    int first, last; // Stat range [first, last)
+} Plan_Job;
+
+static void plan_stat_range(void *arg)
+{
+    Plan_Job *job = (Plan_Job *)arg;
+    Bzzt_World *w = job->w;
+
+    for (int i = job->first; i < job->last; ++i)
+        Bzzt_Stat_Plan(w, job->board, job->board->stats[i], i, &w->intents[i]);
+}
+
+static bool reserve_intents(Bzzt_World *w, int count)
+{
+    if (count <= w->intents_cap)
+        return true;
+
+    int cap = w->intents_cap > 0 ? w->intents_cap : 256;
+    while (cap < count)
+        cap *= 2;
+
+    Bzzt_Stat_Intent *grown = realloc(w->intents, sizeof(Bzzt_Stat_Intent) * (size_t)cap);
+    if (!grown)
+        return false;
+    w->intents = grown;
+    w->intents_cap = cap;
+    return true;
+}
+
+static void plan_board(Bzzt_World *w, Bzzt_Board *board, int count)
+{
+    int planned = count - 1; // Stat 0 has already ticked
+
+    if (!w->tick_pool || planned < BZZT_TWO_PHASE_MIN_PARALLEL_STATS)
+    {
+        Plan_Job all = {w, board, 1, count};
+        plan_stat_range(&all);
+        return;
+    }
+
+    int chunks = (planned + BZZT_TWO_PHASE_CHUNK - 1) / BZZT_TWO_PHASE_CHUNK;
+    Plan_Job *jobs = malloc(sizeof(Plan_Job) * (size_t)chunks);
+    if (!jobs)
+    {
+        Plan_Job all = {w, board, 1, count};
+        plan_stat_range(&all);
+        return;
+    }
+
+    Bzzt_Job_Group group;
+    Bzzt_Job_Group_Init(&group);
+    for (int c = 0; c < chunks; ++c)
+    {
+        int first = 1 + c * BZZT_TWO_PHASE_CHUNK;
+        int last = first + BZZT_TWO_PHASE_CHUNK < count ? first + BZZT_TWO_PHASE_CHUNK : count;
+        jobs[c] = (Plan_Job){w, board, first, last};
+        if (!Bzzt_Thread_Pool_Submit(w->tick_pool, &group, plan_stat_range, &jobs[c]))
+            plan_stat_range(&jobs[c]);
+    }
+    Bzzt_Job_Group_Wait(&group);
+    Bzzt_Job_Group_Destroy(&group);
+    free(jobs);
+}
+
+// Like tick_stat_serially, but stat i applies its plan if it still has one
+static int resolve_stat(UI *ui, Bzzt_World *w, Bzzt_Board *board, int i)
+{
+    Bzzt_Stat *stat = board->stats[i];
+    if (!stat)
+        return i + 1;
+
+    int slot = stat->intent_slot;
+    if (slot < 0)
+        return tick_stat_serially(ui, w, board, i); // Spawned this tick, or back for another turn
+
+    int count_before = board->stat_count;
+    stat->intent_slot = -1;
+    Bzzt_Stat_Resolve(ui, w, stat, i, &w->intents[slot]);
+    return board->stat_count < count_before ? i : i + 1;
+}
+
+/* Two-phase tick: the player moves first, then every other stat plans its
+ * move or push against the board as it stands, spread over the pool. Plans
+ * are then applied in stat order, walking the stats exactly as the serial
+ * loop does; a plan that an earlier stat invalidated falls back to that
+ * stat's normal tick. Anything random runs its normal tick in stat order, so
+ * the board ends the same as a serial tick, whatever the worker count. */
+static void tick_board_two_phase(UI *ui, Bzzt_World *w, Bzzt_Board *board)
+{
+    record_prev_positions(board);
+
+    int i = 0;
+    while (i == 0 && board->stat_count > 0)
+        i = tick_stat_serially(ui, w, board, 0);
+
+    int count = board->stat_count;
+    bool plannable = w->boards[w->boards_current] == board && count > 1; // Not if the player left the board
+    if (plannable && !reserve_intents(w, count))
+    {
+        Debug_Log(LOG_LEVEL_ERROR, LOG_ENGINE, "Out of memory for stat intents; ticking serially");
+        plannable = false;
     }
+    if (!plannable)
+    {
+        while (i < board->stat_count)
+            i = tick_stat_serially(ui, w, board, i);
+        return;
+    }
+
+    plan_board(w, board, count);
+    for (int s = 1; s < count; ++s)
+    {
+        if (board->stats[s])
+            board->stats[s]->intent_slot = s;
+    }
+
+    while (i < board->stat_count)
+        i = resolve_stat(ui, w, board, i);
+
+    for (int s = 0; s < board->stat_count; ++s)
+    {
+        if (board->stats[s])
+            board->stats[s]->intent_slot = -1;
+    }
+}
+
+static void tick_current_board(UI *ui, Bzzt_World *w, Bzzt_Board *board)
+{
+    if (w->two_phase_ticking)
+        tick_board_two_phase(ui, w, board);
+    else
+        tick_board_stats(ui, w, board);
+}
+
+// Seed for one background board on one tick, independent of which thread ticks it
+static uint32_t mix_seed(uint32_t world_seed, int idx, uint64_t tick)
+{
+    uint32_t h = world_seed ^ (uint32_t)tick ^ (uint32_t)(tick >> 32);
+    h ^= (uint32_t)idx * 0x9E3779B9u;
+    h = (h ^ (h >> 16)) * 0x7FEB352Du;
+    h = (h ^ (h >> 15)) * 0x846CA68Bu;
+    return h ^ (h >> 16);
+}
+
+/* One live background board. The worker ticks it against a private copy of
+ * the world, so counter changes and RNG draws stay its own until the merge.
+ * Only the board's own tiles and stats are written in place; no other job
+ * touches them. */
+typedef struct Board_Tick_Job
+{
+    Bzzt_World shadow;
+    Bzzt_World_Delta delta;
+} Board_Tick_Job;
+
+static void run_board_tick_job(void *arg)
+{
+    Board_Tick_Job *job = (Board_Tick_Job *)arg;
+    Bzzt_World *shadow = &job->shadow;
+    Bzzt_Board *board = shadow->boards[shadow->boards_current];
+
+    // Stat 0 is where the player last stood on this board; it doesn't act. No UI either, so nothing flashes.
+    record_prev_positions(board);
+    for (int i = 1; i < board->stat_count;)
+        i = tick_stat_serially(NULL, shadow, board, i);
 }
 
-double Bzzt_Timer_Run_Tick(Engine *e, Bzzt_World *w)
+/* The current board ticks first on this thread, since the player may switch
+ * boards from it. Every other live board then ticks on the pool at once, and
+ * their deltas are merged in board order, so the result is the same whatever
+ * the worker count. A board the player arrived on this tick waits for the
+ * next one, as it would without parallel ticking. */
+static void tick_live_boards(UI *ui, Bzzt_World *w, Bzzt_Board *current_board)
 {
-    if (!e || !e->ui || !w || !w->timer)
+    int ticked_idx = w->boards_current;
+    tick_current_board(ui, w, current_board);
+
+    int live_count = 0;
+    for (int i = 0; i < w->boards_count; ++i)
+    {
+        if (i != ticked_idx && i != w->boards_current && w->boards[i] && w->boards[i]->live)
+            live_count++;
+    }
+    if (live_count == 0)
+        return;
+
+    Board_Tick_Job *jobs = calloc((size_t)live_count, sizeof(Board_Tick_Job));
+    if (!jobs)
+    {
+        Debug_Log(LOG_LEVEL_ERROR, LOG_ENGINE, "Out of memory for live board ticks; skipping them this tick");
+        return;
+    }
+
+    int n = 0;
+    for (int i = 0; i < w->boards_count; ++i)
+    {
+        if (i == ticked_idx || i == w->boards_current || !w->boards[i] || !w->boards[i]->live)
+            continue;
+
+        Board_Tick_Job *job = &jobs[n++];
+        job->shadow = *w;
+        job->shadow.boards_current = i;
+        job->shadow.background = true;
+        job->shadow.current_input = NULL;
+        job->shadow.rng_state = mix_seed(w->rng_state, i, w->timer->ticks_total);
+        job->delta.board_idx = i;
+    }
+
+    Bzzt_Job_Group group;
+    Bzzt_Job_Group_Init(&group);
+    for (int i = 0; i < n; ++i)
+    {
+        if (!w->tick_pool || !Bzzt_Thread_Pool_Submit(w->tick_pool, &group, run_board_tick_job, &jobs[i]))
+            run_board_tick_job(&jobs[i]);
+    }
+    Bzzt_Job_Group_Wait(&group);
+    Bzzt_Job_Group_Destroy(&group);
+
+    for (int i = 0; i < n; ++i)
+    {
+        Bzzt_World_Delta *d = &jobs[i].delta;
+        const Bzzt_World *shadow = &jobs[i].shadow;
+        d->ammo = shadow->ammo - w->ammo;
+        d->gems = shadow->gems - w->gems;
+        d->torches = shadow->torches - w->torches;
+        d->score = shadow->score - w->score;
+    }
+    // Every shadow was copied from w as it is now; only merge once all the differences are taken
+    for (int i = 0; i < n; ++i)
+        Bzzt_World_Merge_Board_Delta(w, &jobs[i].delta);
+
+    free(jobs);
+}
+
+double Bzzt_Timer_Run_Tick(UI *ui, Bzzt_World *w)
+{
+    if (!w || !w->timer)
         return 0.0;
 
     if (w->timer->paused)
@@ -49,38 +437,105 @@ double Bzzt_Timer_Run_Tick(Engine *e, Bzzt_World *w)
 
     Bzzt_World_Begin_Tick(w);
 
-    for (int i = 0; i < current_board->stat_count; ++i)
+    if (w->parallel_ticking && !w->on_title)
+        tick_live_boards(ui, w, current_board);
+    else
+        tick_current_board(ui, w, current_board);
+
+    Bzzt_World_Advance_Status_Effects(w);
+
+    if (ui && ui->message_active)
     {
-        Bzzt_Stat *stat = current_board->stats[i];
-        if (stat)
-        {
-            stat->prev_x = stat->x;
-            stat->prev_y = stat->y;
-        }
+        UI_Update_Message_Timer(ui);
     }
 
-    for (int i = 0; i < current_board->stat_count; ++i)
-    {
-        Bzzt_Stat *stat = current_board->stats[i];
-        if (stat)
-        {
-            int count_before = current_board->stat_count;
-            Bzzt_Stat_Update(e->ui, w, stat, i);
+    Bzzt_Timer_Tick(w->timer);
+    w->timer->ticks_total++;
+    return w->timer->tick_duration_ms;
+}
 
-            if (current_board->stat_count < count_before)
-            {
-                i--;
-            }
-        }
-    }
+double Bzzt_Timer_Speed_To_Tick_Ms(int game_speed)
+{
+    int speed = Bzzt_World_Normalize_Game_Speed(game_speed);
+    return speed_pit_ticks[speed] * BZZT_PIT_TICK_MS;
+}
 
-    Bzzt_World_Advance_Status_Effects(w);
+void Bzzt_Timer_Set_Speed(Bzzt_Timer *t, int game_speed)
+{
+    if (!t)
+        return;
+
+    t->game_speed = game_speed;
+    t->tick_duration_ms = Bzzt_Timer_Speed_To_Tick_Ms(game_speed);
+    t->schedule_valid = false;
+    t->history_count = 0;
+    t->history_head = 0;
+}
+
+void Bzzt_Timer_Get_Stats(const Bzzt_Timer *t, Bzzt_Timer_Stats *out)
+{
+    if (!out)
+        return;
+    memset(out, 0, sizeof(*out));
+    if (!t)
+        return;
+
+    out->target_hz = t->tick_duration_ms > 0.0 ? 1000.0 / t->tick_duration_ms : 0.0;
+    out->ticks_dropped = t->ticks_dropped;
+    out->samples = t->history_count;
+    if (t->history_count < 2)
+        return;
+
+    // Oldest sample first
+    int first = (t->history_head - t->history_count + BZZT_TIMER_HISTORY) % BZZT_TIMER_HISTORY;
+    double sum = 0.0, sum_sq = 0.0;
+    double prev_ms = t->history[first].start_ms;
+    out->max_late_ms = t->history[first].late_ms;
 
-    if (e->ui && e->ui->message_active)
+    for (int n = 1; n < t->history_count; ++n)
     {
-        UI_Update_Message_Timer(e->ui);
+        const Bzzt_Timer_Sample *sample = &t->history[(first + n) % BZZT_TIMER_HISTORY];
+        double interval = sample->start_ms - prev_ms;
+        sum += interval;
+        sum_sq += interval * interval;
+        prev_ms = sample->start_ms;
+        if (sample->late_ms > out->max_late_ms)
+            out->max_late_ms = sample->late_ms;
     }
 
-    Bzzt_Timer_Tick(w->timer);
-    return w->timer->tick_duration_ms;
+    int intervals = t->history_count - 1;
+    double mean = sum / intervals;
+    double variance = sum_sq / intervals - mean * mean;
+    out->actual_hz = mean > 0.0 ? 1000.0 / mean : 0.0;
+    out->jitter_ms = variance > 0.0 ? sqrt(variance) : 0.0;
+}
+
+void Bzzt_Timer_Set_Turbo(Bzzt_Timer *t, Bzzt_Turbo_Mode mode)
+{
+    if (!t || mode < BZZT_TURBO_OFF || mode >= BZZT_TURBO_MODE_COUNT)
+        return;
+
+    t->turbo_mode = mode;
+    t->accumulator_ms = 0.0;
+    t->turbo_ticks_last_frame = 0;
+    t->schedule_valid = false;
+}
+
+void Bzzt_Timer_Set_Turbo_Budget(Bzzt_Timer *t, double budget_ms)
+{
+    if (!t || budget_ms <= 0.0)
+        return;
+    t->turbo_budget_ms = budget_ms;
+}
+
+void Bzzt_Timer_Set_Turbo_Ticks(Bzzt_Timer *t, int ticks_per_frame)
+{
+    if (!t || ticks_per_frame < 1)
+        return;
+    t->turbo_ticks_per_frame = ticks_per_frame;
+}
+
+bool Bzzt_Timer_Is_Turbo(const Bzzt_Timer *t)
+{
+    return t && t->turbo_mode != BZZT_TURBO_OFF;
 }
@@ -4,20 +4,83 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#define BZZT_TURBO_DEFAULT_BUDGET_MS 12.0   // Leaves headroom for rendering inside a 60 FPS frame
+#define BZZT_TURBO_DEFAULT_TICKS_PER_FRAME 10
+
+#define BZZT_PIT_TICK_MS (65536.0 * 1000.0 / 1193182.0) // One 18.2 Hz BIOS timer tick, ~54.925 ms
+#define BZZT_TIMER_MAX_CATCHUP_TICKS 4                   // Ticks run in one frame before the backlog is dropped
+#define BZZT_TIMER_HISTORY 64                            // Ticks kept for rate/jitter stats
+#define BZZT_TIMER_REPORT_INTERVAL_MS 5000.0
+
+#define BZZT_TWO_PHASE_MIN_PARALLEL_STATS 256 // Smaller boards plan on the tick thread
+#define BZZT_TWO_PHASE_CHUNK 128              // Stats planned per pool job
+
 typedef struct Bzzt_World Bzzt_World;
-typedef struct Engine Engine;
+typedef struct UI UI;
+
+typedef enum Bzzt_Turbo_Mode
+{
+    BZZT_TURBO_OFF = 0,
+    BZZT_TURBO_BUDGET, // Run as many ticks as fit in turbo_budget_ms each frame
+    BZZT_TURBO_FIXED,  // Run exactly turbo_ticks_per_frame ticks each frame
+    BZZT_TURBO_MODE_COUNT
+} Bzzt_Turbo_Mode;
+
+typedef struct Bzzt_Timer_Sample
+{
+    double start_ms; // Monotonic time the tick started
+    double late_ms;  // How far past its deadline the tick started
+} Bzzt_Timer_Sample;
+
+typedef struct Bzzt_Timer_Stats
+{
+    double target_hz;
+    double actual_hz;
+    double jitter_ms;   // Standard deviation of the interval between ticks
+    double max_late_ms; // Worst deadline miss in the sample window
+    uint32_t ticks_dropped;
+    int samples;
+} Bzzt_Timer_Stats;
 
 typedef struct Bzzt_Timer
 {
     double tick_duration_ms;
-    double accumulator_ms;
+    double accumulator_ms; // Time since the last tick's deadline, used for interpolation
     uint16_t current_tick;
     int current_stat_index;
     bool paused;
+    uint64_t ticks_total; // Ticks run since the world was created
+
+    /* Ticks are scheduled as epoch + n * period, so the schedule never
+     * accumulates rounding error. The epoch is reset on speed changes,
+     * after pauses and turbo, and when the backlog is dropped. */
+    int game_speed;
+    double epoch_ms;
+    uint64_t ticks_since_epoch;
+    bool schedule_valid;
+
+    Bzzt_Timer_Sample history[BZZT_TIMER_HISTORY];
+    int history_head, history_count;
+    uint32_t ticks_dropped;
+    double last_report_ms;
+
+    Bzzt_Turbo_Mode turbo_mode;
+    double turbo_budget_ms;
+    int turbo_ticks_per_frame;
+    int turbo_ticks_last_frame;
 } Bzzt_Timer;
 
 void Bzzt_Timer_Tick(Bzzt_Timer *t);
 
-void Bzzt_Timer_Run_Frame(Engine *e, Bzzt_World *w, double frame_ms);
+void Bzzt_Timer_Run_Frame(UI *ui, Bzzt_World *w, double now_ms);
+
+double Bzzt_Timer_Run_Tick(UI *ui, Bzzt_World *w);
+
+double Bzzt_Timer_Speed_To_Tick_Ms(int game_speed);
+void Bzzt_Timer_Set_Speed(Bzzt_Timer *t, int game_speed);
+void Bzzt_Timer_Get_Stats(const Bzzt_Timer *t, Bzzt_Timer_Stats *out);
 
-double Bzzt_Timer_Run_Tick(Engine *e, Bzzt_World *w);
\ No newline at end of file
+void Bzzt_Timer_Set_Turbo(Bzzt_Timer *t, Bzzt_Turbo_Mode mode);
+void Bzzt_Timer_Set_Turbo_Budget(Bzzt_Timer *t, double budget_ms);
+void Bzzt_Timer_Set_Turbo_Ticks(Bzzt_Timer *t, int ticks_per_frame);
+bool Bzzt_Timer_Is_Turbo(const Bzzt_Timer *t);
@@ -101,6 +101,14 @@ cleanup:
     return NULL;
 }
 
+UI *UI_Create_Headless(void)
+{
+    UI *ui = UI_Create(false, false);
+    if (ui)
+        ui->headless = true;
+    return ui;
+}
+
 void UI_Destroy(UI *ui)
 {
     if (!ui)
@@ -246,6 +246,7 @@ typedef struct UILayer
 typedef struct UI
 {
     bool visible, enabled;
+    bool headless; // Tracks message state only; never builds surfaces (simulation side)
     UILayer **layers;
     int layer_count, layer_cap;
 
@@ -258,6 +259,7 @@ typedef struct UI
 } UI;
 
 UI *UI_Create(bool visible, bool enabled);
+UI *UI_Create_Headless(void);
 void UI_Update(UI *ui);
 void UI_Destroy(UI *ui);
 
@@ -265,6 +267,7 @@ void UI_Flash_Message(UI *ui, Bzzt_World *w, zzt_message_t zzt_msg, ...);
 void UI_Flash_Message_String(UI *ui, Bzzt_World *w, const char *message);
 void UI_Clear_Message(UI *ui);
 void UI_Update_Message_Timer(UI *ui);
+void UI_Mirror_Message(UI *ui, const char *text, int16_t ticks_remaining, bool active);
 
 UILayer *UI_Add_New_Layer(UI *ui, bool visible, bool enabled);
 void UI_Add_Surface(UI *ui, int targetIndex, UISurface *s);
@@ -117,9 +117,9 @@ void UI_Flash_Message(UI *ui, Bzzt_World *w, zzt_message_t zzt_msg, ...)
         return;
 
     // Initialize the surface if needed
-    if (!ui->flashing_text_surface)
+    if (!ui->flashing_text_surface && !ui->headless)
         ui->flashing_text_surface = create_flashing_text_surface(ui);
-    if (!ui->flashing_text_surface)
+    if (!ui->flashing_text_surface && !ui->headless)
         return;
 
     // Check if this message should be shown
@@ -166,8 +166,11 @@ void UI_Flash_Message(UI *ui, Bzzt_World *w, zzt_message_t zzt_msg, ...)
     set_message_text_and_color(ui, ui->message_text, initial_color);
 
     // Make sure the surface is visible
-    UISurface_Set_Visible(ui->flashing_text_surface, true);
-    UISurface_Set_Enabled(ui->flashing_text_surface, true);
+    if (ui->flashing_text_surface)
+    {
+        UISurface_Set_Visible(ui->flashing_text_surface, true);
+        UISurface_Set_Enabled(ui->flashing_text_surface, true);
+    }
 }
 
 void UI_Flash_Message_String(UI *ui, Bzzt_World *w, const char *message)
@@ -176,9 +179,9 @@ void UI_Flash_Message_String(UI *ui, Bzzt_World *w, const char *message)
         return;
 
     // Initialize the surface if needed
-    if (!ui->flashing_text_surface)
+    if (!ui->flashing_text_surface && !ui->headless)
         ui->flashing_text_surface = create_flashing_text_surface(ui);
-    if (!ui->flashing_text_surface)
+    if (!ui->flashing_text_surface && !ui->headless)
         return;
 
     size_t source_len = strnlen(message, ZZT_MESSAGE_MAX_CHARS);
@@ -205,8 +208,11 @@ void UI_Flash_Message_String(UI *ui, Bzzt_World *w, const char *message)
     set_message_text_and_color(ui, ui->message_text, initial_color);
 
     // Make sure the surface is visible
-    UISurface_Set_Visible(ui->flashing_text_surface, true);
-    UISurface_Set_Enabled(ui->flashing_text_surface, true);
+    if (ui->flashing_text_surface)
+    {
+        UISurface_Set_Visible(ui->flashing_text_surface, true);
+        UISurface_Set_Enabled(ui->flashing_text_surface, true);
+    }
 }
 
 void UI_Update_Message_Timer(UI *ui)
@@ -230,6 +236,46 @@ void UI_Update_Message_Timer(UI *ui)
     set_message_text_and_color(ui, ui->message_text, new_color);
 }
 
+// Show message state produced by another UI (the simulation's headless one)
+void UI_Mirror_Message(UI *ui, const char *text, int16_t ticks_remaining, bool active)
+{
+    if (!ui)
+        return;
+
+    if (!active || !text || text[0] == '\0')
+    {
+        if (ui->message_active)
+            UI_Clear_Message(ui);
+        return;
+    }
+
+    if (!ui->flashing_text_surface)
+        ui->flashing_text_surface = create_flashing_text_surface(ui);
+    if (!ui->flashing_text_surface)
+        return;
+
+    if (!ui->message_text || strcmp(ui->message_text, text) != 0)
+    {
+        size_t len = strlen(text);
+        char *copy = malloc(len + 1);
+        if (!copy)
+            return;
+        memcpy(copy, text, len + 1);
+        if (ui->message_text)
+            free(ui->message_text);
+        ui->message_text = copy;
+    }
+
+    ui->message_ticks_remaining = ticks_remaining;
+    ui->message_active = true;
+
+    Color_Bzzt color = BZZT_PALETTE[9 + (ticks_remaining % 7)];
+    set_message_text_and_color(ui, ui->message_text, color);
+
+    UISurface_Set_Visible(ui->flashing_text_surface, true);
+    UISurface_Set_Enabled(ui->flashing_text_surface, true);
+}
+
 void UI_Clear_Message(UI *ui)
 {
     if (!ui)
@@ -2,6 +2,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
 #include "raylib.h"
 #include "bzzt.h"
 #include "input.h"
@@ -9,10 +11,15 @@
 #include "debugger.h"
 #include "zzt.h"
 #include "timing.h"
+#include "clock.h"
 #include "ui.h"
+#include "thread_pool.h"
+#include "file_map.h"
+#include "bz_world.h"
+#include "world_cache.h"
 
 #define BLINK_RATE_DEFAULT 269   // in ms
-#define TICK_DURATION_DEFAULT 109.89 // Original ZZT runs at roughly 9.1 logic cycles per second.
+#define WORLD_RNG_SEED 0x2545F491u // Fixed so replays and parallel ticks are reproducible
 
 static void initialize_loaded_world_state(Bzzt_World *bw)
 {
@@ -112,6 +119,16 @@ static bool grow_boards_array(Bzzt_World *w)
     return true;
 }
 
+static void release_board_source(Bzzt_World *w)
+{
+    if (w->zzt_source)
+        zztWorldFree(w->zzt_source);
+    BZW_Close(w->bzw_source);
+    w->zzt_source = NULL;
+    w->bzw_source = NULL;
+    w->boards_pending = 0;
+}
+
 static bool switch_board_to(Bzzt_World *w, int idx, int x, int y)
 {
     if (!w || idx < 0 || idx >= w->boards_count || w->boards_current == idx)
@@ -122,7 +139,9 @@ static bool switch_board_to(Bzzt_World *w, int idx, int x, int y)
 
     Debug_Log(LOG_LEVEL_DEBUG, LOG_WORLD, "Switching to board %d at %d, %d.", idx, x, y);
 
-    Bzzt_Board *new_board = w->boards[idx];
+    Bzzt_Board *new_board = Bzzt_World_Get_Board(w, idx);
+    if (!new_board)
+        return false;
 
     Bzzt_Board *old_board = w->boards[w->boards_current];
     Bzzt_Stat *old_player = old_board->stats[0];
@@ -136,6 +155,8 @@ static bool switch_board_to(Bzzt_World *w, int idx, int x, int y)
         Bzzt_Board_Set_Tile(old_board, old_player->x, old_player->y, old_player->under);
     Bzzt_Board_Rebuild_Stat_Index(old_board);
 
+    Bzzt_World_Prefetch_Neighbors(w);
+
     if (w->on_title)
     {
         hide_title_monitor(w, new_board, new_player, false);
@@ -157,7 +178,8 @@ static bool switch_board_to(Bzzt_World *w, int idx, int x, int y)
 
 Bzzt_World *Bzzt_World_Create(char *title)
 {
-    Bzzt_World *w = malloc(sizeof(Bzzt_World));
+    // Zeroed so fields nothing below sets (author, flags, keys, ...) don't carry garbage into saves
+    Bzzt_World *w = calloc(1, sizeof(Bzzt_World));
     if (!w)
         return NULL;
     strncpy(w->title, title, sizeof(w->title) - 1);
@@ -194,14 +216,17 @@ Bzzt_World *Bzzt_World_Create(char *title)
     w->allow_blink = true; // blink on by default
     w->blink_state = false;
 
-    w->timer = malloc(sizeof(Bzzt_Timer));
+    w->timer = calloc(1, sizeof(Bzzt_Timer));
     w->timer->accumulator_ms = 0;
     w->timer->current_stat_index = 0;
     w->timer->current_tick = 1;
     w->timer->paused = false;
-    w->timer->tick_duration_ms = TICK_DURATION_DEFAULT;
+    w->timer->turbo_mode = BZZT_TURBO_OFF;
+    w->timer->turbo_budget_ms = BZZT_TURBO_DEFAULT_BUDGET_MS;
+    w->timer->turbo_ticks_per_frame = BZZT_TURBO_DEFAULT_TICKS_PER_FRAME;
+    w->timer->turbo_ticks_last_frame = 0;
 
-    w->last_frame_time_ms = GetTime() * 1000.0;
+    w->last_frame_time_ms = Bzzt_Clock_Now_Ms();
 
 #if BZZT_ENABLE_INTERPOLATION
     w->interpolation_enabled = true;
@@ -210,9 +235,22 @@ Bzzt_World *Bzzt_World_Create(char *title)
 #endif
 
     w->game_speed = 4;
+    Bzzt_Timer_Set_Speed(w->timer, w->game_speed);
     w->player_hurt_flash_ticks = 0;
     w->energizer_cycles = 0;
 
+    w->rng_state = WORLD_RNG_SEED;
+    w->parallel_ticking = false;
+    w->background = false;
+    w->tick_pool = NULL;
+    w->two_phase_ticking = false;
+    w->intents = NULL;
+    w->intents_cap = 0;
+    w->zzt_source = NULL;
+    w->bzw_source = NULL;
+    w->boards_pending = 0;
+    w->prefetch = NULL;
+
     return w;
 }
 
@@ -220,6 +258,7 @@ void Bzzt_World_Destroy(Bzzt_World *w)
 {
     if (!w)
         return;
+    Bzzt_World_Set_Prefetch(w, false);
     for (int i = 0; i < w->boards_count; ++i)
     {
         if (w->boards[i])
@@ -232,19 +271,23 @@ void Bzzt_World_Destroy(Bzzt_World *w)
     w->boards_current = 0;
     w->loaded = false;
     free(w->boards);
+    release_board_source(w);
     if (w->timer)
         free(w->timer);
+    Bzzt_Thread_Pool_Destroy(w->tick_pool);
+    free(w->intents);
     free(w);
 }
 
-void Bzzt_World_Update(Engine *e, Bzzt_World *w, InputState *in)
+void Bzzt_World_Update(UI *ui, Bzzt_World *w, InputState *in)
 {
     if (!w || !in)
         return;
 
-    double current_time_ms = GetTime() * 1000.0;
+    double current_time_ms = Bzzt_Clock_Now_Ms();
     double delta_time = current_time_ms - w->last_frame_time_ms;
     w->last_frame_time_ms = current_time_ms;
+    // Only the blink animation uses the frame delta; tick catch-up is handled by the timer
     if (delta_time > 250.0)
         delta_time = 250.0;
     if (delta_time < 0.0)
@@ -273,7 +316,7 @@ void Bzzt_World_Update(Engine *e, Bzzt_World *w, InputState *in)
         Bzzt_World_Set_Pause(w, false);
     }
 
-    Bzzt_Timer_Run_Frame(e, w, delta_time);
+    Bzzt_Timer_Run_Frame(ui, w, current_time_ms);
 }
 
 void Bzzt_World_Add_Board(Bzzt_World *w, Bzzt_Board *b)
@@ -290,7 +333,8 @@ void Bzzt_World_Add_Board(Bzzt_World *w, Bzzt_Board *b)
 // TODO: handle landing on a forest tile (clear it)
 bool Bzzt_World_Switch_Board_To(Bzzt_World *w, int board_idx, int x, int y)
 {
-    if (!w || board_idx < 0 || board_idx >= w->boards_count || w->boards_current == board_idx)
+    // Only the player switches boards, and it never acts on a background board
+    if (!w || w->background || board_idx < 0 || board_idx >= w->boards_count || w->boards_current == board_idx)
         return false;
 
     return switch_board_to(w, board_idx, x, y);
@@ -298,7 +342,7 @@ bool Bzzt_World_Switch_Board_To(Bzzt_World *w, int board_idx, int x, int y)
 
 void Bzzt_World_Set_Pause(Bzzt_World *w, bool pause)
 {
-    if (!w)
+    if (!w || w->background)
         return;
 
     Bzzt_Board *current_board = w->boards[w->boards_current];
@@ -314,7 +358,10 @@ void Bzzt_World_Set_Pause(Bzzt_World *w, bool pause)
 
     w->paused = pause;
     if (w->timer)
+    {
         w->timer->paused = pause;
+        w->timer->schedule_valid = false; // Restart the tick schedule instead of catching up on the pause
+    }
 }
 
 void Bzzt_World_Inc_Score(Bzzt_World *w, int amount)
@@ -340,6 +387,131 @@ int Bzzt_World_Message_Ticks(Bzzt_World *w)
     return ticks > 0 ? ticks : 1;
 }
 
+uint32_t Bzzt_Random_Next(uint32_t *state, uint32_t range)
+{
+    if (!state || range == 0)
+        return 0;
+
+    // Weyl step plus a murmur-style finalizer; never gets stuck at zero
+    *state += 0x9E3779B9u;
+    uint32_t z = *state;
+    z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+    z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+    z ^= z >> 16;
+    return (uint32_t)(((uint64_t)z * range) >> 32);
+}
+
+double Bzzt_Random_Unit(uint32_t *state)
+{
+    return (double)Bzzt_Random_Next(state, 1u << 24) / (double)(1u << 24);
+}
+
+uint32_t Bzzt_World_Random(Bzzt_World *w, uint32_t range)
+{
+    return w ? Bzzt_Random_Next(&w->rng_state, range) : 0;
+}
+
+static bool acquire_tick_pool(Bzzt_World *w, int threads)
+{
+    if (w->tick_pool)
+        return true;
+
+    w->tick_pool = Bzzt_Thread_Pool_Create(threads);
+    if (!w->tick_pool)
+    {
+        Debug_Log(LOG_LEVEL_ERROR, LOG_WORLD, "Could not start the tick worker pool");
+        return false;
+    }
+    return true;
+}
+
+// Parallel and two-phase ticking share one pool; it goes once neither wants it
+static void release_tick_pool(Bzzt_World *w)
+{
+    if (w->parallel_ticking || w->two_phase_ticking)
+        return;
+
+    Bzzt_Thread_Pool_Destroy(w->tick_pool);
+    w->tick_pool = NULL;
+}
+
+bool Bzzt_World_Set_Two_Phase_Ticking(Bzzt_World *w, bool enabled, int threads)
+{
+    if (!w)
+        return false;
+
+    if (!enabled || threads == 0)
+    {
+        // Two-phase with no pool plans on the tick thread
+        w->two_phase_ticking = false;
+        release_tick_pool(w);
+        w->two_phase_ticking = enabled;
+        return true;
+    }
+
+    if (!acquire_tick_pool(w, threads))
+    {
+        w->two_phase_ticking = false;
+        return false;
+    }
+
+    w->two_phase_ticking = true;
+    Debug_Printf(LOG_WORLD, "Two-phase ticking ON with %d workers", Bzzt_Thread_Pool_Size(w->tick_pool));
+    return true;
+}
+
+bool Bzzt_World_Set_Parallel_Ticking(Bzzt_World *w, bool enabled, int threads)
+{
+    if (!w)
+        return false;
+
+    if (!enabled)
+    {
+        w->parallel_ticking = false;
+        release_tick_pool(w);
+        return true;
+    }
+
+    // Background boards must not convert boards themselves, so every live flag has to be known up front
+    if (!Bzzt_World_Convert_All_Boards(w, NULL))
+        Debug_Log(LOG_LEVEL_WARN, LOG_WORLD, "Some boards could not be converted; they won't tick in parallel");
+
+    if (!acquire_tick_pool(w, threads))
+        return false;
+
+    w->parallel_ticking = true;
+    Debug_Printf(LOG_WORLD, "Parallel ticking ON with %d workers", Bzzt_Thread_Pool_Size(w->tick_pool));
+    return true;
+}
+
+void Bzzt_World_Set_Board_Live(Bzzt_World *w, int board_idx, bool live)
+{
+    Bzzt_Board *b = Bzzt_World_Get_Board(w, board_idx);
+    if (b)
+        b->live = live;
+}
+
+static int16_t merge_counter(int16_t current, int change)
+{
+    int sum = (int)current + change;
+    if (sum > INT16_MAX)
+        return INT16_MAX;
+    if (sum < INT16_MIN)
+        return INT16_MIN;
+    return (int16_t)sum;
+}
+
+void Bzzt_World_Merge_Board_Delta(Bzzt_World *w, const Bzzt_World_Delta *delta)
+{
+    if (!w || !delta)
+        return;
+
+    w->ammo = merge_counter(w->ammo, delta->ammo);
+    w->gems = merge_counter(w->gems, delta->gems);
+    w->torches = merge_counter(w->torches, delta->torches);
+    w->score = merge_counter(w->score, delta->score);
+}
+
 bool Bzzt_World_Is_Energized(Bzzt_World *w)
 {
     return w && w->energizer_cycles > 0;
@@ -368,7 +540,8 @@ void Bzzt_World_Advance_Status_Effects(Bzzt_World *w)
 
 bool Bzzt_World_Damage_Player(UI *ui, Bzzt_World *w, int amount, Bzzt_DamageSource source)
 {
-    if (!w)
+    // Stat 0 of a background board is where the player last stood, not the player
+    if (!w || w->background)
         return false;
 
     if (source != BZZT_DAMAGE_SOURCE_BOMB &&
@@ -419,23 +592,387 @@ Bzzt_Tile Bzzt_World_Get_Player_Render_Tile(Bzzt_World *w, Bzzt_Tile tile)
     return tile;
 }
 
-Bzzt_World *Bzzt_World_From_ZZT_World(char *file)
+// Touches only this one ZZTboard, so several boards can be unpacked at once
+static Bzzt_Board *unpack_board(ZZTboard *zb, int idx)
 {
-    if (!file)
+    // Packed boards decode straight from their RLE data; zztBoardSelect would also repack the previous board
+    Bzzt_Board *b = Bzzt_Board_From_ZZT_Board_Ptr(zb);
+
+    // The Bzzt board is the copy that matters from here on
+    if (zb->bigboard)
     {
-        Debug_Printf(LOG_ENGINE, "Invalid ZZT world.");
+        zztBlockFree(zb->bigboard);
+        zb->bigboard = NULL;
+    }
+
+    if (!b)
+    {
+        Debug_Log(LOG_LEVEL_ERROR, LOG_WORLD, "Could not convert board %d.", idx);
         return NULL;
     }
 
-    ZZTworld *zw = zztWorldLoad(file);
-    if (!zw)
+    b->idx = idx;
+    return b;
+}
+
+static void adopt_board(Bzzt_World *w, int idx, Bzzt_Board *b)
+{
+    w->boards[idx] = b;
+    if (--w->boards_pending == 0)
+        release_board_source(w);
+}
+
+static Bzzt_Board *convert_pending_board(Bzzt_World *w, int idx)
+{
+    Bzzt_Board *b = w->zzt_source ? unpack_board(&w->zzt_source->boards[idx], idx)
+                                  : BZW_Read_Board(w->bzw_source, idx);
+    if (b)
+        adopt_board(w, idx, b);
+    return b;
+}
+
+typedef struct Unpack_Job
+{
+    ZZTboard *source;     // NULL when the board comes from bzw_source
+    const BZWFile *bzw_source;
+    int idx;
+    Bzzt_Board *result;
+} Unpack_Job;
+
+static void run_unpack_job(void *arg)
+{
+    Unpack_Job *job = (Unpack_Job *)arg;
+    job->result = job->source ? unpack_board(job->source, job->idx)
+                              : BZW_Read_Board(job->bzw_source, job->idx);
+}
+
+typedef enum Prefetch_State
+{
+    PREFETCH_IDLE,
+    PREFETCH_RUNNING,
+    PREFETCH_READY
+} Prefetch_State;
+
+typedef struct Prefetch_Job
+{
+    Bzzt_Board_Prefetch *owner;
+    Unpack_Job unpack;
+    Prefetch_State state; // Guarded by owner->lock
+} Prefetch_Job;
+
+struct Bzzt_Board_Prefetch
+{
+    Bzzt_Thread_Pool *pool;
+    Bzzt_Job_Group group; // Every job ever queued, so teardown can wait them out
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    Prefetch_Job *jobs; // One per board
+    int job_count;
+    uint64_t hits, waits, misses;
+};
+
+static void run_prefetch_job(void *arg)
+{
+    Prefetch_Job *job = (Prefetch_Job *)arg;
+    run_unpack_job(&job->unpack);
+
+    pthread_mutex_lock(&job->owner->lock);
+    job->state = PREFETCH_READY;
+    pthread_cond_broadcast(&job->owner->ready);
+    pthread_mutex_unlock(&job->owner->lock);
+}
+
+// Wait out every queued job and adopt what it made, after which the board
+// sources are safe to touch from this thread again
+static void prefetch_settle(Bzzt_World *w)
+{
+    Bzzt_Board_Prefetch *p = w->prefetch;
+    if (!p)
+        return;
+
+    Bzzt_Job_Group_Wait(&p->group);
+    for (int i = 0; i < p->job_count; ++i)
     {
-        Debug_Printf(LOG_ENGINE, "Error loading ZZT world %s", file);
+        Prefetch_Job *job = &p->jobs[i];
+        if (job->state != PREFETCH_READY)
+            continue;
+
+        job->state = PREFETCH_IDLE;
+        if (job->unpack.result && i < w->boards_count && !w->boards[i])
+            adopt_board(w, i, job->unpack.result);
+        else
+            Bzzt_Board_Destroy(job->unpack.result);
+        job->unpack.result = NULL;
+    }
+}
+
+// The prefetched board for idx, waiting for it if it is still being made. NULL if it was never queued.
+static Bzzt_Board *prefetch_take(Bzzt_World *w, int idx)
+{
+    Bzzt_Board_Prefetch *p = w->prefetch;
+    if (!p)
+        return NULL;
+
+    Bzzt_Board *b = NULL;
+    pthread_mutex_lock(&p->lock);
+    Prefetch_Job *job = idx < p->job_count ? &p->jobs[idx] : NULL;
+    if (!job || job->state == PREFETCH_IDLE)
+    {
+        p->misses++;
+    }
+    else
+    {
+        if (job->state == PREFETCH_RUNNING)
+            p->waits++;
+        else
+            p->hits++;
+        while (job->state == PREFETCH_RUNNING)
+            pthread_cond_wait(&p->ready, &p->lock);
+        b = job->unpack.result;
+        job->unpack.result = NULL;
+        job->state = PREFETCH_IDLE;
+    }
+    pthread_mutex_unlock(&p->lock);
+    return b;
+}
+
+static void prefetch_queue(Bzzt_World *w, int idx)
+{
+    Bzzt_Board_Prefetch *p = w->prefetch;
+    if (idx <= 0 || idx >= w->boards_count || w->boards[idx])
+        return;
+
+    if (p->job_count < w->boards_count)
+    {
+        // Jobs point into this array, so nothing may be in flight while it moves
+        prefetch_settle(w);
+        if (w->boards[idx])
+            return;
+        Prefetch_Job *grown = realloc(p->jobs, (size_t)w->boards_count * sizeof(Prefetch_Job));
+        if (!grown)
+            return;
+        memset(grown + p->job_count, 0, (size_t)(w->boards_count - p->job_count) * sizeof(Prefetch_Job));
+        p->jobs = grown;
+        p->job_count = w->boards_count;
+    }
+
+    Prefetch_Job *job = &p->jobs[idx];
+    pthread_mutex_lock(&p->lock);
+    bool idle = job->state == PREFETCH_IDLE;
+    if (idle)
+        job->state = PREFETCH_RUNNING;
+    pthread_mutex_unlock(&p->lock);
+    if (!idle)
+        return;
+
+    job->owner = p;
+    job->unpack = (Unpack_Job){w->zzt_source ? &w->zzt_source->boards[idx] : NULL, w->bzw_source, idx, NULL};
+    if (!Bzzt_Thread_Pool_Submit(p->pool, &p->group, run_prefetch_job, job))
+    {
+        pthread_mutex_lock(&p->lock);
+        job->state = PREFETCH_IDLE;
+        pthread_mutex_unlock(&p->lock);
+    }
+}
+
+void Bzzt_World_Prefetch_Neighbors(Bzzt_World *w)
+{
+    if (!w || !w->prefetch || (!w->zzt_source && !w->bzw_source))
+        return;
+
+    Bzzt_Board *b = w->boards[w->boards_current];
+    if (!b)
+        return;
+
+    prefetch_queue(w, b->board_n);
+    prefetch_queue(w, b->board_s);
+    prefetch_queue(w, b->board_w);
+    prefetch_queue(w, b->board_e);
+    for (int i = 0; i < b->stat_count && w->boards_pending > 0; ++i)
+    {
+        Bzzt_Stat *s = b->stats[i];
+        if (Bzzt_Board_Get_Tile(b, s->x, s->y).element == ZZT_PASSAGE)
+            prefetch_queue(w, s->data[2]);
+    }
+}
+
+bool Bzzt_World_Set_Prefetch(Bzzt_World *w, bool enabled)
+{
+    if (!w)
+        return false;
+
+    if (!enabled)
+    {
+        Bzzt_Board_Prefetch *p = w->prefetch;
+        if (!p)
+            return true;
+        prefetch_settle(w);
+        Debug_Log(LOG_LEVEL_DEBUG, LOG_WORLD, "Board prefetch: %llu hits, %llu waits, %llu misses.",
+                  (unsigned long long)p->hits, (unsigned long long)p->waits, (unsigned long long)p->misses);
+        w->prefetch = NULL;
+        Bzzt_Thread_Pool_Destroy(p->pool);
+        Bzzt_Job_Group_Destroy(&p->group);
+        pthread_cond_destroy(&p->ready);
+        pthread_mutex_destroy(&p->lock);
+        free(p->jobs);
+        free(p);
+        return true;
+    }
+
+    if (w->prefetch)
+        return true;
+
+    Bzzt_Board_Prefetch *p = calloc(1, sizeof(Bzzt_Board_Prefetch));
+    if (!p)
+        return false;
+    // One worker is plenty for a handful of boards, and leaves the rest of the CPUs to the tick
+    p->pool = Bzzt_Thread_Pool_Create(1);
+    if (!p->pool)
+    {
+        free(p);
+        return false;
+    }
+    Bzzt_Job_Group_Init(&p->group);
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->ready, NULL);
+    w->prefetch = p;
+
+    Bzzt_World_Prefetch_Neighbors(w);
+    return true;
+}
+
+void Bzzt_World_Get_Prefetch_Stats(Bzzt_World *w, uint64_t *hits, uint64_t *waits, uint64_t *misses)
+{
+    uint64_t h = 0, wt = 0, m = 0;
+    if (w && w->prefetch)
+    {
+        pthread_mutex_lock(&w->prefetch->lock);
+        h = w->prefetch->hits;
+        wt = w->prefetch->waits;
+        m = w->prefetch->misses;
+        pthread_mutex_unlock(&w->prefetch->lock);
+    }
+    if (hits)
+        *hits = h;
+    if (waits)
+        *waits = wt;
+    if (misses)
+        *misses = m;
+}
+
+static size_t board_memory_estimate(const Bzzt_Board *b)
+{
+    size_t bytes = sizeof(Bzzt_Board) + (b->name ? strlen(b->name) + 1 : 0);
+    bytes += (size_t)b->width * b->height * (sizeof(Bzzt_Tile) + sizeof(int));
+    bytes += (size_t)b->stat_cap * sizeof(Bzzt_Stat *);
+    for (int i = 0; i < b->stat_count; ++i)
+        bytes += sizeof(Bzzt_Stat) + (b->stats[i] ? b->stats[i]->program_length : 0);
+    return bytes;
+}
+
+size_t Bzzt_World_Memory_Estimate(const Bzzt_World *w)
+{
+    if (!w)
+        return 0;
+
+    size_t bytes = sizeof(Bzzt_World) + (size_t)w->boards_cap * sizeof(Bzzt_Board *);
+    for (int i = 0; i < w->boards_count; ++i)
+    {
+        if (w->boards[i])
+            bytes += board_memory_estimate(w->boards[i]);
+        else // Pending: a full-size board with no stats
+            bytes += sizeof(Bzzt_Board) + (size_t)ZZT_BOARD_X_SIZE * ZZT_BOARD_Y_SIZE * (sizeof(Bzzt_Tile) + sizeof(int));
+    }
+    return bytes;
+}
+
+bool Bzzt_World_Convert_All_Boards(Bzzt_World *w, Bzzt_Thread_Pool *pool)
+{
+    if (!w)
+        return false;
+    prefetch_settle(w);
+
+    int pending = 0;
+    for (int i = 0; i < w->boards_count; ++i)
+    {
+        if (!w->boards[i])
+            pending++;
+    }
+
+    if (!w->zzt_source && !w->bzw_source)
+        return true;
+
+    Unpack_Job *jobs = calloc((size_t)pending, sizeof(Unpack_Job));
+    if (!jobs)
+    {
+        Debug_Log(LOG_LEVEL_ERROR, LOG_WORLD, "Out of memory converting boards.");
+        return false;
+    }
+
+    int n = 0;
+    for (int i = 0; i < w->boards_count; ++i)
+    {
+        if (!w->boards[i])
+        {
+            ZZTboard *source = w->zzt_source ? &w->zzt_source->boards[i] : NULL;
+            jobs[n++] = (Unpack_Job){source, w->bzw_source, i, NULL};
+        }
+    }
+
+    Bzzt_Job_Group group;
+    Bzzt_Job_Group_Init(&group);
+    for (int i = 0; i < n; ++i)
+    {
+        if (!pool || !Bzzt_Thread_Pool_Submit(pool, &group, run_unpack_job, &jobs[i]))
+            run_unpack_job(&jobs[i]);
+    }
+    Bzzt_Job_Group_Wait(&group);
+    Bzzt_Job_Group_Destroy(&group);
+
+    // Boards go in by index, so the world is the same whichever job finished first
+    bool ok = true;
+    for (int i = 0; i < n; ++i)
+    {
+        if (jobs[i].result)
+            adopt_board(w, jobs[i].idx, jobs[i].result);
+        else
+            ok = false;
+    }
+
+    free(jobs);
+    return ok;
+}
+
+Bzzt_Board *Bzzt_World_Get_Board(Bzzt_World *w, int idx)
+{
+    if (!w || idx < 0 || idx >= w->boards_count)
         return NULL;
+
+    // A background board's copy of the world shares boards[] with the real one; only the real one fills it
+    if (w->boards[idx] || w->background || (!w->zzt_source && !w->bzw_source))
+        return w->boards[idx];
+
+    Bzzt_Board *b = prefetch_take(w, idx);
+    if (b)
+    {
+        adopt_board(w, idx, b);
+        return b;
     }
+    return convert_pending_board(w, idx);
+}
 
+/* Boards stay packed inside the ZZT world until something asks for them.
+ * Only the title board and the start board are converted up front, so the
+ * title screen comes up in the same time whatever the board count. */
+static Bzzt_World *world_from_zzt(ZZTworld *zw, const char *path)
+{
     Bzzt_World *bw = Bzzt_World_Create((char *)zztWorldGetTitle(zw));
-    strncpy(bw->file_path, file, sizeof(bw->file_path) - 1);
+    if (!bw)
+    {
+        zztWorldFree(zw);
+        return NULL;
+    }
+    strncpy(bw->file_path, path, sizeof(bw->file_path) - 1);
     strncpy(bw->author, "Blank", sizeof(bw->author) - 1);
 
     // Remove default title screen created by Bzzt_World_Create
@@ -448,31 +985,32 @@ Bzzt_World *Bzzt_World_From_ZZT_World(char *file)
     }
 
     int boardCount = zztWorldGetBoardcount(zw);
-
-    for (int i = 0; i < boardCount; ++i)
+    while (bw->boards_cap < boardCount)
     {
-        zztBoardSelect(zw, i);
-        Bzzt_Board *b = Bzzt_Board_From_ZZT_Board(zw);
-        if (!b)
+        if (!grow_boards_array(bw))
+        {
+            zztWorldFree(zw);
+            Bzzt_World_Destroy(bw);
             return NULL;
-        b->idx = i;
-        Bzzt_World_Add_Board(bw, b);
+        }
     }
 
-    bw->boards_current = 0;
+    bw->boards_count = boardCount;
+    bw->boards_pending = boardCount;
+    bw->zzt_source = zw;
+
     bw->start_board_idx = zztWorldGetStartboard(zw);
-    bw->start_board = bw->boards[bw->start_board_idx];
+    if (bw->start_board_idx >= boardCount)
+        bw->start_board_idx = 0;
 
-    bw->ammo = 0;
-    bw->gems = 0;
-    bw->energizer_cycles = 0;
-    bw->health = 100;
-    bw->score = 0;
-    bw->torch_cycles = 0;
-    bw->torches = 0;
+    if (!Bzzt_World_Get_Board(bw, 0) || !Bzzt_World_Get_Board(bw, bw->start_board_idx))
+    {
+        Bzzt_World_Destroy(bw);
+        return NULL;
+    }
 
-    for (int i = 0; i < 7; ++i)
-        bw->keys[i] = 0;
+    bw->start_board = bw->boards[bw->start_board_idx];
+    initialize_loaded_world_state(bw);
 
     // verify player exists
     if (bw->start_board->stat_count > 0)
@@ -489,7 +1027,7 @@ Bzzt_World *Bzzt_World_From_ZZT_World(char *file)
         Debug_Log(LOG_LEVEL_WARN, LOG_WORLD, "Found no stats on start board.");
     }
 
-    if (bw->boards_count > 0 && bw->boards[0] && bw->boards[0]->stat_count > 0)
+    if (bw->boards[0]->stat_count > 0)
     {
         bw->title_monitor_x = bw->boards[0]->stats[0]->x;
         bw->title_monitor_y = bw->boards[0]->stats[0]->y;
@@ -498,85 +1036,301 @@ Bzzt_World *Bzzt_World_From_ZZT_World(char *file)
 
     bw->on_title = true;
 
-    zztWorldFree(zw);
-
     return bw;
 }
 
-Bzzt_World *Bzzt_World_From_ZZT_Stream(FILE *fp, const char *display_name)
+Bzzt_World *Bzzt_World_From_ZZT_World_Parallel(char *file, Bzzt_Thread_Pool *pool)
 {
-    if (!fp)
+    Bzzt_World *w = Bzzt_World_From_ZZT_World(file);
+    if (w && !Bzzt_World_Convert_All_Boards(w, pool))
+        Debug_Log(LOG_LEVEL_WARN, LOG_WORLD, "Some boards of %s could not be converted.", file);
+    return w;
+}
+
+// Pending stores wait here for the one worker; past this many, new ones are dropped
+#define CACHE_STORE_QUEUE_MAX 4
+
+typedef struct Cache_Store_Job
+{
+    uint8_t *data; // Private copy of the source world
+    size_t size;
+    Bzzt_World_Cache_Key key;
+    char name[BZZT_MAX_PATH_LENGTH];
+} Cache_Store_Job;
+
+static pthread_mutex_t cache_store_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cache_store_wake = PTHREAD_COND_INITIALIZER;
+static Cache_Store_Job *cache_store_queue[CACHE_STORE_QUEUE_MAX]; // Oldest first
+static int cache_store_queued;
+static Bzzt_World_Cache_Key cache_store_running_key;
+static bool cache_store_running;
+static bool cache_store_worker_started;
+
+static void cache_store_run(Cache_Store_Job *job)
+{
+    // Converts its own copy of the world, so the one being played is never touched
+    ZZTworld *zw = zztWorldReadMem(job->data, job->size);
+    Bzzt_World *w = zw ? world_from_zzt(zw, job->name) : NULL;
+    if (w && Bzzt_World_Convert_All_Boards(w, NULL))
+        Bzzt_World_Cache_Store(w, job->key);
+    else
+        Debug_Log(LOG_LEVEL_WARN, LOG_WORLD, "Some boards of %s could not be converted; not caching it.", job->name);
+
+    Bzzt_World_Destroy(w);
+    free(job->data);
+    free(job);
+}
+
+// Runs for the life of the process, one store at a time
+static void *cache_store_main(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&cache_store_lock);
+    for (;;)
     {
-        Debug_Printf(LOG_ENGINE, "Invalid ZZT stream.");
-        return NULL;
+        while (cache_store_queued == 0)
+            pthread_cond_wait(&cache_store_wake, &cache_store_lock);
+
+        Cache_Store_Job *job = cache_store_queue[0];
+        memmove(cache_store_queue, cache_store_queue + 1, sizeof(cache_store_queue[0]) * (size_t)--cache_store_queued);
+        cache_store_running_key = job->key;
+        cache_store_running = true;
+        pthread_mutex_unlock(&cache_store_lock);
+
+        cache_store_run(job);
+
+        pthread_mutex_lock(&cache_store_lock);
+        cache_store_running = false;
     }
+    return NULL;
+}
 
-    ZZTworld *zw = zztWorldRead(fp);
-    if (!zw)
+static bool cache_store_key_equal(Bzzt_World_Cache_Key a, Bzzt_World_Cache_Key b)
+{
+    return a.hash == b.hash && a.size == b.size;
+}
+
+// Called with cache_store_lock held
+static bool cache_store_pending(Bzzt_World_Cache_Key key)
+{
+    if (cache_store_running && cache_store_key_equal(cache_store_running_key, key))
+        return true;
+    for (int i = 0; i < cache_store_queued; ++i)
     {
-        Debug_Printf(LOG_ENGINE, "Error loading ZZT world from stream.");
-        return NULL;
+        if (cache_store_key_equal(cache_store_queue[i]->key, key))
+            return true;
     }
+    return false;
+}
 
-    Bzzt_World *bw = Bzzt_World_Create((char *)zztWorldGetTitle(zw));
-    strncpy(bw->file_path,
-            display_name ? display_name : "<zip world>",
-            sizeof(bw->file_path) - 1);
-    strncpy(bw->author, "Blank", sizeof(bw->author) - 1);
+/* Queue the cache entry to be filled in the background, after the caller has
+ * its world. One worker takes the queue in order. A store is dropped if the
+ * same world is already queued or being stored, or if the queue is full:
+ * caching is only an optimisation, and the next load of a dropped world
+ * simply queues it again. */
+static void cache_store_in_background(const uint8_t *data, size_t size, Bzzt_World_Cache_Key key, const char *name)
+{
+    pthread_mutex_lock(&cache_store_lock);
+    if (cache_store_pending(key))
+    {
+        pthread_mutex_unlock(&cache_store_lock);
+        return;
+    }
+    if (cache_store_queued == CACHE_STORE_QUEUE_MAX)
+    {
+        pthread_mutex_unlock(&cache_store_lock);
+        Debug_Log(LOG_LEVEL_DEBUG, LOG_WORLD, "World cache queue is full; not caching %s.", name);
+        return;
+    }
+    if (!cache_store_worker_started)
+    {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, cache_store_main, NULL) != 0)
+        {
+            pthread_mutex_unlock(&cache_store_lock);
+            Debug_Log(LOG_LEVEL_WARN, LOG_WORLD, "No thread to cache %s; skipping it.", name);
+            return;
+        }
+        pthread_detach(thread);
+        cache_store_worker_started = true;
+    }
 
-    // Remove default title screen created by Bzzt_World_Create
-    if (bw->boards_count > 0 && bw->boards[0])
+    Cache_Store_Job *job = calloc(1, sizeof(Cache_Store_Job));
+    if (job)
+        job->data = malloc(size ? size : 1);
+    if (!job || !job->data)
     {
-        Bzzt_Board_Destroy(bw->boards[0]);
-        bw->boards[0] = NULL;
-        bw->boards_count = 0;
-        bw->boards_current = 0;
+        pthread_mutex_unlock(&cache_store_lock);
+        free(job);
+        return;
     }
+    memcpy(job->data, data, size);
+    job->size = size;
+    job->key = key;
+    snprintf(job->name, sizeof(job->name), "%s", name);
+
+    cache_store_queue[cache_store_queued++] = job;
+    pthread_cond_signal(&cache_store_wake);
+    pthread_mutex_unlock(&cache_store_lock);
+}
 
-    int boardCount = zztWorldGetBoardcount(zw);
+/* Shared by the ZZT loaders. A world the cache already holds skips libzzt2
+ * and conversion entirely. Otherwise boards are converted lazily as usual,
+ * and with the cache on a background thread converts a copy of the source
+ * and stores it, so a miss costs the title screen nothing. */
+static Bzzt_World *world_from_zzt_data(const uint8_t *data, size_t size, const char *name)
+{
+    Bzzt_World_Cache_Key key = {0};
+    bool caching = Bzzt_World_Cache_Enabled();
+    if (caching)
+    {
+        key = Bzzt_World_Cache_Key_For(data, size);
+        Bzzt_World *cached = Bzzt_World_Cache_Load(key, name);
+        if (cached)
+            return cached;
+    }
 
-    for (int i = 0; i < boardCount; ++i)
+    ZZTworld *zw = zztWorldReadMem(data, size);
+    if (!zw)
     {
-        zztBoardSelect(zw, i);
-        Bzzt_Board *b = Bzzt_Board_From_ZZT_Board(zw);
-        if (!b)
-            return NULL;
-        b->idx = i;
-        Bzzt_World_Add_Board(bw, b);
+        Debug_Printf(LOG_ENGINE, "Error loading ZZT world %s", name);
+        return NULL;
     }
 
-    bw->start_board_idx = zztWorldGetStartboard(zw);
-    bw->start_board = bw->boards[bw->start_board_idx];
-    initialize_loaded_world_state(bw);
+    Bzzt_World *w = world_from_zzt(zw, name);
+    if (w && caching)
+        cache_store_in_background(data, size, key, name);
+    return w;
+}
 
-    if (bw->start_board->stat_count > 0)
+Bzzt_World *Bzzt_World_From_ZZT_World(char *file)
+{
+    if (!file)
     {
-        Bzzt_Stat *player_stat = bw->start_board->stats[0];
-        Bzzt_Tile player_tile = Bzzt_Board_Get_Tile(bw->start_board, player_stat->x, player_stat->y);
-        if (player_tile.element != ZZT_PLAYER)
-        {
-            Debug_Log(LOG_LEVEL_WARN, LOG_WORLD, "Stat[0] is not a player.");
-        }
+        Debug_Printf(LOG_ENGINE, "Invalid ZZT world.");
+        return NULL;
     }
-    else
+
+    // Parse straight from the mapped file instead of a byte at a time through stdio
+    Bzzt_File_Map map;
+    if (!Bzzt_File_Map_Open(file, &map))
     {
-        Debug_Log(LOG_LEVEL_WARN, LOG_WORLD, "Found no stats on start board.");
+        Debug_Printf(LOG_ENGINE, "Error loading ZZT world %s", file);
+        return NULL;
     }
 
-    if (bw->boards_count > 0 && bw->boards[0] && bw->boards[0]->stat_count > 0)
+    Bzzt_World *w = world_from_zzt_data(map.data, map.size, file);
+    Bzzt_File_Map_Close(&map);
+    return w;
+}
+
+Bzzt_World *Bzzt_World_From_ZZT_Memory(const uint8_t *data, size_t size, const char *display_name)
+{
+    if (!data)
     {
-        bw->title_monitor_x = bw->boards[0]->stats[0]->x;
-        bw->title_monitor_y = bw->boards[0]->stats[0]->y;
-        hide_title_monitor(bw, bw->boards[0], bw->boards[0]->stats[0], true);
+        Debug_Printf(LOG_ENGINE, "Invalid ZZT world data.");
+        return NULL;
     }
 
-    bw->on_title = true;
+    return world_from_zzt_data(data, size, display_name ? display_name : "<zip world>");
+}
 
-    zztWorldFree(zw);
+Bzzt_World *Bzzt_World_From_ZZT_Stream(FILE *fp, const char *display_name)
+{
+    if (!fp)
+    {
+        Debug_Printf(LOG_ENGINE, "Invalid ZZT stream.");
+        return NULL;
+    }
 
-    return bw;
+    Bzzt_File_Map map;
+    if (!Bzzt_File_Map_From_Stream(fp, &map))
+    {
+        Debug_Printf(LOG_ENGINE, "Error loading ZZT world from stream.");
+        return NULL;
+    }
+
+    Bzzt_World *w = Bzzt_World_From_ZZT_Memory(map.data, map.size, display_name);
+    Bzzt_File_Map_Close(&map);
+    return w;
 }
 
+/* Like a ZZT world, a .bzzt world keeps its boards in the mapped file until
+ * they are asked for; only the title, start and current boards are read now. */
+int Bzzt_World_Load(Bzzt_World *w, const char *path)
+{
+    if (!w || !path)
+        return -1;
+
+    BZWFile *f = BZW_Open(path);
+    if (!f)
+        return -1;
+
+    prefetch_settle(w);
+
+    int board_count = BZW_Board_Count(f);
+    while (w->boards_cap < board_count)
+    {
+        if (!grow_boards_array(w))
+        {
+            BZW_Close(f);
+            return -1;
+        }
+    }
+
+    // Read the boards play needs before dropping anything, so a bad file
+    // leaves the world that was loaded untouched
+    int start_idx, current_idx;
+    BZW_Start_Boards(f, &start_idx, &current_idx);
+    int first_idx[3] = {0, start_idx, current_idx};
+    Bzzt_Board *first[3] = {NULL, NULL, NULL};
+    bool ok = true;
+    for (int k = 0; k < 3 && ok; ++k)
+    {
+        bool seen = false;
+        for (int j = 0; j < k; ++j)
+            seen |= first_idx[j] == first_idx[k];
+        if (!seen)
+            ok = (first[k] = BZW_Read_Board(f, first_idx[k])) != NULL;
+    }
+    if (!ok || !BZW_Read_World(f, w))
+    {
+        for (int k = 0; k < 3; ++k)
+            Bzzt_Board_Destroy(first[k]);
+        BZW_Close(f);
+        return -1;
+    }
+
+    for (int i = 0; i < w->boards_count; ++i)
+    {
+        Bzzt_Board_Destroy(w->boards[i]);
+        w->boards[i] = NULL;
+    }
+    release_board_source(w);
+
+    snprintf(w->file_path, sizeof(w->file_path), "%s", path);
+    w->boards_count = board_count;
+    w->boards_pending = board_count;
+    w->bzw_source = f;
+    for (int k = 0; k < 3; ++k)
+    {
+        if (first[k])
+            adopt_board(w, first_idx[k], first[k]);
+    }
+
+    w->start_board = w->boards[w->start_board_idx];
+    w->paused = false;
+    w->player_hurt_flash_ticks = 0;
+    Bzzt_Timer_Set_Speed(w->timer, w->game_speed);
+    w->loaded = true;
+    return 0;
+}
+
+int Bzzt_World_Save(Bzzt_World *w, const char *path)
+{
+    return BZW_Save(path, w) ? 0 : -1;
+}
+
 void Bzzt_World_Toggle_Interpolation(Bzzt_World *w)
 {
     if (!w)
@@ -590,3 +1344,53 @@ void Bzzt_World_Toggle_Interpolation(Bzzt_World *w)
     Debug_Printf(LOG_ENGINE, "Interpolation disabled at compile time");
 #endif
 }
+
+void Bzzt_World_Toggle_Two_Phase_Ticking(Bzzt_World *w)
+{
+    if (!w)
+        return;
+
+    if (w->two_phase_ticking)
+    {
+        Bzzt_World_Set_Two_Phase_Ticking(w, false, 0);
+        Debug_Printf(LOG_ENGINE, "Two-phase ticking OFF");
+    }
+    else if (!Bzzt_World_Set_Two_Phase_Ticking(w, true, -1))
+        Debug_Printf(LOG_ENGINE, "Two-phase ticking unavailable; staying serial");
+}
+
+void Bzzt_World_Toggle_Parallel_Ticking(Bzzt_World *w)
+{
+    if (!w)
+        return;
+
+    if (w->parallel_ticking)
+    {
+        Bzzt_World_Set_Parallel_Ticking(w, false, 0);
+        Debug_Printf(LOG_ENGINE, "Parallel ticking OFF");
+    }
+    else if (!Bzzt_World_Set_Parallel_Ticking(w, true, -1))
+        Debug_Printf(LOG_ENGINE, "Parallel ticking unavailable; ticking the current board only");
+}
+
+void Bzzt_World_Cycle_Turbo(Bzzt_World *w)
+{
+    if (!w || !w->timer)
+        return;
+
+    Bzzt_Turbo_Mode next = (Bzzt_Turbo_Mode)((w->timer->turbo_mode + 1) % BZZT_TURBO_MODE_COUNT);
+    Bzzt_Timer_Set_Turbo(w->timer, next);
+
+    switch (next)
+    {
+    case BZZT_TURBO_BUDGET:
+        Debug_Printf(LOG_ENGINE, "Turbo ON: %.1f ms tick budget per frame", w->timer->turbo_budget_ms);
+        break;
+    case BZZT_TURBO_FIXED:
+        Debug_Printf(LOG_ENGINE, "Turbo ON: %d ticks per frame", w->timer->turbo_ticks_per_frame);
+        break;
+    default:
+        Debug_Printf(LOG_ENGINE, "Turbo OFF");
+        break;
+    }
+}
@@ -0,0 +1,309 @@
+#include "world_cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "bzzt.h"
+#include "bz_world.h"
+#include "debugger.h"
+
+#if defined(_WIN32)
+#include <direct.h>
+#include <io.h>
+#include <sys/utime.h>
+#define world_cache_mkdir(path) _mkdir(path)
+#define world_cache_touch(path) _utime(path, NULL)
+#else
+#include <dirent.h>
+#include <utime.h>
+#define world_cache_mkdir(path) mkdir(path, 0755)
+#define world_cache_touch(path) utime(path, NULL)
+#endif
+
+// Entries are named w<converter>-<format>-<hash>-<size>.bzzt; the first two
+// numbers are what invalidates them when conversion or the file format changes
+#define WORLD_CACHE_PREFIX_FMT "w%u-%u-"
+#define WORLD_CACHE_SUFFIX ".bzzt"
+
+typedef struct World_Cache_Entry
+{
+    char name[96];
+    uint64_t size;
+    time_t mtime;
+} World_Cache_Entry;
+
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static char cache_dir[BZZT_MAX_PATH_LENGTH];
+static uint64_t cache_max_bytes;
+
+// Copy the settings out so file work happens without the lock held
+static bool world_cache_settings(char *dir, size_t dir_size, uint64_t *max_bytes)
+{
+    pthread_mutex_lock(&cache_lock);
+    bool enabled = cache_dir[0] != '\0' && cache_max_bytes > 0;
+    snprintf(dir, dir_size, "%s", cache_dir);
+    if (max_bytes)
+        *max_bytes = cache_max_bytes;
+    pthread_mutex_unlock(&cache_lock);
+    return enabled;
+}
+
+static void world_cache_prefix(char *out, size_t out_size)
+{
+    snprintf(out, out_size, WORLD_CACHE_PREFIX_FMT, (unsigned)BZZT_ZZT_CONVERTER_VERSION, (unsigned)BZW_FORMAT_VERSION);
+}
+
+static bool world_cache_entry_path(const char *dir, Bzzt_World_Cache_Key key, char *out, size_t out_size)
+{
+    char prefix[32];
+    world_cache_prefix(prefix, sizeof(prefix));
+    int n = snprintf(out, out_size, "%s/%s%016llx-%llx" WORLD_CACHE_SUFFIX, dir, prefix,
+                     (unsigned long long)key.hash, (unsigned long long)key.size);
+    return n > 0 && (size_t)n < out_size;
+}
+
+// mkdir -p
+static bool world_cache_make_dirs(const char *dir)
+{
+    char path[BZZT_MAX_PATH_LENGTH];
+    if (snprintf(path, sizeof(path), "%s", dir) >= (int)sizeof(path))
+        return false;
+
+    for (char *p = path + 1; *p; ++p)
+    {
+        if (*p != '/' && *p != '\\')
+            continue;
+        // Parents that can't be made (a drive root, say) show up as a failure of the last mkdir
+        char saved = *p;
+        *p = '\0';
+        world_cache_mkdir(path);
+        *p = saved;
+    }
+    return world_cache_mkdir(path) == 0 || errno == EEXIST;
+}
+
+void Bzzt_World_Cache_Configure(const char *dir, uint64_t max_bytes)
+{
+    pthread_mutex_lock(&cache_lock);
+    snprintf(cache_dir, sizeof(cache_dir), "%s", dir ? dir : "");
+    cache_max_bytes = dir ? max_bytes : 0;
+    pthread_mutex_unlock(&cache_lock);
+}
+
+bool Bzzt_World_Cache_Enabled(void)
+{
+    char dir[BZZT_MAX_PATH_LENGTH];
+    return world_cache_settings(dir, sizeof(dir), NULL);
+}
+
+Bzzt_World_Cache_Key Bzzt_World_Cache_Key_For(const uint8_t *data, size_t size)
+{
+    // FNV-1a over 8-byte words; the size goes in the key as well
+    uint64_t h = 1469598103934665603ull;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        h = (h ^ word) * 1099511628211ull;
+    }
+    for (; i < size; ++i)
+        h = (h ^ data[i]) * 1099511628211ull;
+
+    return (Bzzt_World_Cache_Key){h, (uint64_t)size};
+}
+
+Bzzt_World *Bzzt_World_Cache_Load(Bzzt_World_Cache_Key key, const char *display_name)
+{
+    char dir[BZZT_MAX_PATH_LENGTH];
+    char path[BZZT_MAX_PATH_LENGTH + 96];
+    if (!world_cache_settings(dir, sizeof(dir), NULL) || !world_cache_entry_path(dir, key, path, sizeof(path)))
+        return NULL;
+
+    struct stat st;
+    if (stat(path, &st) != 0)
+        return NULL;
+
+    Bzzt_World *w = Bzzt_World_Create("");
+    if (!w)
+        return NULL;
+
+    if (Bzzt_World_Load(w, path) != 0)
+    {
+        // Damaged, or written by a build with another board layout; convert afresh and replace it
+        Debug_Log(LOG_LEVEL_WARN, LOG_WORLD, "Dropping unreadable world cache entry %s.", path);
+        Bzzt_World_Destroy(w);
+        remove(path);
+        return NULL;
+    }
+
+    if (display_name)
+        snprintf(w->file_path, sizeof(w->file_path), "%s", display_name);
+    world_cache_touch(path); // Most recently used now
+    Debug_Log(LOG_LEVEL_DEBUG, LOG_WORLD, "Loaded %s from the world cache.", display_name ? display_name : path);
+    return w;
+}
+
+void Bzzt_World_Cache_Store(Bzzt_World *w, Bzzt_World_Cache_Key key)
+{
+    char dir[BZZT_MAX_PATH_LENGTH];
+    char path[BZZT_MAX_PATH_LENGTH + 96];
+    if (!w || !world_cache_settings(dir, sizeof(dir), NULL) || !world_cache_entry_path(dir, key, path, sizeof(path)))
+        return;
+
+    if (!world_cache_make_dirs(dir))
+    {
+        Debug_Log(LOG_LEVEL_WARN, LOG_WORLD, "Could not create world cache directory %s.", dir);
+        return;
+    }
+
+    if (Bzzt_World_Save(w, path) != 0)
+    {
+        Debug_Log(LOG_LEVEL_WARN, LOG_WORLD, "Could not cache %s.", w->file_path);
+        return;
+    }
+
+    Bzzt_World_Cache_Trim();
+}
+
+static int world_cache_compare_age(const void *a, const void *b)
+{
+    const World_Cache_Entry *ea = a, *eb = b;
+    if (ea->mtime != eb->mtime)
+        return ea->mtime < eb->mtime ? -1 : 1;
+    return strcmp(ea->name, eb->name);
+}
+
+// Half-written entries left by a save that never finished (a crash, or the
+// game closing while a background store ran); anything this old is abandoned
+#define WORLD_CACHE_STALE_TEMP_SECONDS (60 * 60)
+
+static bool world_cache_is_stale_temp(const char *name, time_t mtime, time_t now)
+{
+    size_t len = strlen(name);
+    return name[0] == 'w' && len > 4 && strcmp(name + len - 4, ".tmp") == 0 &&
+           strstr(name, WORLD_CACHE_SUFFIX ".") != NULL && now - mtime > WORLD_CACHE_STALE_TEMP_SECONDS;
+}
+
+// Our entries are the w*.bzzt files; anything else in the directory is left alone
+static bool world_cache_is_entry(const char *name)
+{
+    size_t len = strlen(name);
+    size_t suffix_len = strlen(WORLD_CACHE_SUFFIX);
+    return name[0] == 'w' && len > suffix_len && len < sizeof(((World_Cache_Entry *)0)->name) &&
+           strcmp(name + len - suffix_len, WORLD_CACHE_SUFFIX) == 0;
+}
+
+static bool world_cache_add_entry(World_Cache_Entry **entries, size_t *count, size_t *cap,
+                                  const char *name, uint64_t size, time_t mtime)
+{
+    if (*count == *cap)
+    {
+        size_t new_cap = *cap ? *cap * 2 : 64;
+        World_Cache_Entry *tmp = realloc(*entries, new_cap * sizeof(World_Cache_Entry));
+        if (!tmp)
+            return false;
+        *entries = tmp;
+        *cap = new_cap;
+    }
+
+    World_Cache_Entry *e = &(*entries)[(*count)++];
+    snprintf(e->name, sizeof(e->name), "%s", name);
+    e->size = size;
+    e->mtime = mtime;
+    return true;
+}
+
+void Bzzt_World_Cache_Trim(void)
+{
+    char dir[BZZT_MAX_PATH_LENGTH];
+    uint64_t max_bytes = 0;
+    if (!world_cache_settings(dir, sizeof(dir), &max_bytes))
+        return;
+
+    World_Cache_Entry *entries = NULL;
+    size_t count = 0, cap = 0;
+    char path[BZZT_MAX_PATH_LENGTH + 256];
+    time_t now = time(NULL);
+
+#if defined(_WIN32)
+    struct _finddata_t f;
+    intptr_t h;
+    snprintf(path, sizeof(path), "%s/*", dir);
+    if ((h = _findfirst(path, &f)) != -1)
+    {
+        do
+        {
+            if (world_cache_is_stale_temp(f.name, f.time_write, now))
+            {
+                snprintf(path, sizeof(path), "%s/%s", dir, f.name);
+                remove(path);
+                continue;
+            }
+            if (world_cache_is_entry(f.name) &&
+                !world_cache_add_entry(&entries, &count, &cap, f.name, (uint64_t)f.size, f.time_write))
+                break;
+        } while (_findnext(h, &f) == 0);
+        _findclose(h);
+    }
+#else
+    DIR *dp = opendir(dir);
+    if (dp)
+    {
+        struct dirent *de;
+        while ((de = readdir(dp)) != NULL)
+        {
+            if (de->d_name[0] != 'w')
+                continue;
+
+            struct stat st;
+            snprintf(path, sizeof(path), "%s/%s", dir, de->d_name);
+            if (stat(path, &st) != 0)
+                continue;
+            if (world_cache_is_stale_temp(de->d_name, st.st_mtime, now))
+            {
+                remove(path);
+                continue;
+            }
+            if (!world_cache_is_entry(de->d_name))
+                continue;
+            if (!world_cache_add_entry(&entries, &count, &cap, de->d_name, (uint64_t)st.st_size, st.st_mtime))
+                break;
+        }
+        closedir(dp);
+    }
+#endif
+
+    char prefix[32];
+    world_cache_prefix(prefix, sizeof(prefix));
+    size_t prefix_len = strlen(prefix);
+
+    // Entries from another converter or format version can never hit again
+    uint64_t total = 0;
+    size_t kept = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (strncmp(entries[i].name, prefix, prefix_len) != 0)
+        {
+            snprintf(path, sizeof(path), "%s/%s", dir, entries[i].name);
+            remove(path);
+            continue;
+        }
+        total += entries[i].size;
+        entries[kept++] = entries[i];
+    }
+
+    qsort(entries, kept, sizeof(World_Cache_Entry), world_cache_compare_age);
+    for (size_t i = 0; i < kept && total > max_bytes; ++i)
+    {
+        snprintf(path, sizeof(path), "%s/%s", dir, entries[i].name);
+        if (remove(path) == 0)
+            total -= entries[i].size;
+    }
+
+    free(entries);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct Bzzt_World Bzzt_World;
+
+#define BZZT_WORLD_CACHE_DEFAULT_DIR "cache/worlds"
+#define BZZT_WORLD_CACHE_DEFAULT_MAX_BYTES (256ull * 1024 * 1024)
+
+// Identifies a source world by its bytes, so the same .zzt reached through a
+// different path or zip is still a hit
+typedef struct Bzzt_World_Cache_Key
+{
+    uint64_t hash;
+    uint64_t size;
+} Bzzt_World_Cache_Key;
+
+// Keep converted worlds as .bzzt files in dir, using at most max_bytes of disk.
+// The cache is off until this is called; a NULL dir or a max_bytes of 0 turns it off again.
+void Bzzt_World_Cache_Configure(const char *dir, uint64_t max_bytes);
+bool Bzzt_World_Cache_Enabled(void);
+Bzzt_World_Cache_Key Bzzt_World_Cache_Key_For(const uint8_t *data, size_t size);
+// The world converted from the source with this key, or NULL on a miss
+Bzzt_World *Bzzt_World_Cache_Load(Bzzt_World_Cache_Key key, const char *display_name);
+// Save a freshly converted world under key. Its boards should all be converted
+// already; any that aren't are converted one at a time by the save.
+void Bzzt_World_Cache_Store(Bzzt_World *w, Bzzt_World_Cache_Key key);
+// Drop entries from other converter versions, then the least recently used ones until under the cap
+void Bzzt_World_Cache_Trim(void);
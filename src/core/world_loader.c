@@ -0,0 +1,181 @@
+#include "world_loader.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include "bzzt.h"
+#include "debugger.h"
+#include "file_map.h"
+#include "zip_archive.h"
+
+struct Bzzt_World_Loader
+{
+    pthread_t thread;
+    char path[BZZT_MAX_PATH_LENGTH];
+    char member[BZZT_MAX_PATH_LENGTH];
+    int cancel;         // Set by the watcher, read with __atomic builtins
+    int finished;       // Set by the worker once world and error are final
+    Bzzt_World *world;  // Belongs to the worker until finished
+    size_t source_size; // Bytes of .zzt or .bzzt data read, set with world
+    char error[192];
+};
+
+static bool is_bzzt_world_path(const char *path)
+{
+    const char *ext = strrchr(path, '.');
+    return ext && strcasecmp(ext, ".bzzt") == 0;
+}
+
+static bool loader_cancelled(Bzzt_World_Loader *l)
+{
+    return __atomic_load_n(&l->cancel, __ATOMIC_RELAXED) != 0;
+}
+
+// "archive!/member", the name a zipped world goes by once loaded
+static void zipped_display_name(const Bzzt_World_Loader *l, char *out, size_t out_size)
+{
+    size_t written = strnlen(l->path, out_size - 1);
+    memcpy(out, l->path, written);
+    if (written < out_size - 1)
+        out[written++] = '!';
+    if (written < out_size - 1)
+        out[written++] = '/';
+    size_t member_len = strnlen(l->member, out_size - 1 - written);
+    memcpy(out + written, l->member, member_len);
+    out[written + member_len] = '\0';
+}
+
+static Bzzt_World *load_zipped_world(Bzzt_World_Loader *l)
+{
+    uint8_t *data = NULL;
+    size_t data_size = 0;
+    char error[192] = {0};
+    if (!ZipArchive_Extract_World_To_Memory(l->path, l->member, &data, &data_size, error, sizeof(error)))
+    {
+        Debug_Printf(LOG_ENGINE, "Error extracting zipped ZZT world %s!/%s: %s", l->path, l->member, error);
+        snprintf(l->error, sizeof(l->error), "%s", error[0] ? error : "Could not extract the world.");
+        return NULL;
+    }
+
+    l->source_size = data_size;
+    Bzzt_World *world = NULL;
+    if (!loader_cancelled(l))
+    {
+        char display_name[BZZT_MAX_PATH_LENGTH];
+        zipped_display_name(l, display_name, sizeof(display_name));
+        world = Bzzt_World_From_ZZT_Memory(data, data_size, display_name);
+    }
+    free(data);
+    return world;
+}
+
+static Bzzt_World *load_world_file(Bzzt_World_Loader *l)
+{
+    if (is_bzzt_world_path(l->path))
+    {
+        // Native worlds read their boards lazily, so there is nothing to convert up front
+        struct stat st;
+        if (stat(l->path, &st) == 0)
+            l->source_size = (size_t)st.st_size;
+        Bzzt_World *world = Bzzt_World_Create("");
+        if (world && Bzzt_World_Load(world, l->path) != 0)
+        {
+            Bzzt_World_Destroy(world);
+            world = NULL;
+        }
+        return world;
+    }
+
+    Bzzt_File_Map map;
+    if (!Bzzt_File_Map_Open(l->path, &map))
+    {
+        Debug_Printf(LOG_ENGINE, "Error loading ZZT world %s", l->path);
+        return NULL;
+    }
+
+    l->source_size = map.size;
+    Bzzt_World *world = NULL;
+    if (!loader_cancelled(l))
+        world = Bzzt_World_From_ZZT_Memory(map.data, map.size, l->path);
+    Bzzt_File_Map_Close(&map);
+    return world;
+}
+
+static void *world_loader_main(void *arg)
+{
+    Bzzt_World_Loader *l = (Bzzt_World_Loader *)arg;
+
+    Bzzt_World *world = l->member[0] ? load_zipped_world(l) : load_world_file(l);
+
+    if (world && loader_cancelled(l))
+    {
+        Bzzt_World_Destroy(world);
+        world = NULL;
+    }
+
+    if (!world && loader_cancelled(l))
+        snprintf(l->error, sizeof(l->error), "Load cancelled.");
+    else if (!world && !l->error[0])
+        snprintf(l->error, sizeof(l->error), "Failed to load selected world.");
+
+    l->world = world;
+    __atomic_store_n(&l->finished, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+Bzzt_World_Loader *Bzzt_World_Loader_Start(const char *path, const char *member)
+{
+    if (!path)
+        return NULL;
+
+    Bzzt_World_Loader *l = calloc(1, sizeof(Bzzt_World_Loader));
+    if (!l)
+        return NULL;
+
+    snprintf(l->path, sizeof(l->path), "%s", path);
+    snprintf(l->member, sizeof(l->member), "%s", member ? member : "");
+
+    if (pthread_create(&l->thread, NULL, world_loader_main, l) != 0)
+    {
+        Debug_Log(LOG_LEVEL_ERROR, LOG_ENGINE, "Failed to create world loader thread.");
+        free(l);
+        return NULL;
+    }
+
+    Debug_Log(LOG_LEVEL_DEBUG, LOG_ENGINE, "Loading %s%s%s in the background.", path,
+              l->member[0] ? "!/" : "", l->member);
+    return l;
+}
+
+bool Bzzt_World_Loader_Poll(Bzzt_World_Loader *l)
+{
+    return !l || __atomic_load_n(&l->finished, __ATOMIC_ACQUIRE) != 0;
+}
+
+size_t Bzzt_World_Loader_Source_Size(Bzzt_World_Loader *l)
+{
+    return l && __atomic_load_n(&l->finished, __ATOMIC_ACQUIRE) ? l->source_size : 0;
+}
+
+void Bzzt_World_Loader_Cancel(Bzzt_World_Loader *l)
+{
+    if (l)
+        __atomic_store_n(&l->cancel, 1, __ATOMIC_RELAXED);
+}
+
+Bzzt_World *Bzzt_World_Loader_Finish(Bzzt_World_Loader *l, char *error, size_t error_size)
+{
+    if (!l)
+        return NULL;
+
+    pthread_join(l->thread, NULL);
+    Bzzt_World *world = l->world;
+    if (error && error_size > 0)
+        snprintf(error, error_size, "%s", l->error);
+    free(l);
+    return world;
+}
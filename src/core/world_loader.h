@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct Bzzt_World Bzzt_World;
+
+/* Loads a world on its own thread: reading the file or inflating it out of a
+ * zip, parsing, and converting the boards play starts on (the rest are
+ * converted when first entered). The world belongs to the loader until
+ * Bzzt_World_Loader_Finish hands it over. */
+typedef struct Bzzt_World_Loader Bzzt_World_Loader;
+
+// Start loading path, or member inside the zip at path when member is non-empty.
+// Both .zzt and .bzzt worlds are accepted.
+Bzzt_World_Loader *Bzzt_World_Loader_Start(const char *path, const char *member);
+// True once the load has finished, failed or been cancelled
+bool Bzzt_World_Loader_Poll(Bzzt_World_Loader *l);
+// Size of the world's file, or of the member inflated out of the zip; 0 until the loader has finished
+size_t Bzzt_World_Loader_Source_Size(Bzzt_World_Loader *l);
+// Drop the world once the worker is done with it. Finish still has to be called.
+void Bzzt_World_Loader_Cancel(Bzzt_World_Loader *l);
+// Wait for the load, free the loader and return the world, or NULL with the reason in error
+Bzzt_World *Bzzt_World_Loader_Finish(Bzzt_World_Loader *l, char *error, size_t error_size);
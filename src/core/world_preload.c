@@ -0,0 +1,388 @@
+#include "world_preload.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bzzt.h"
+#include "debugger.h"
+#include "mem_cache.h"
+#include "world_loader.h"
+
+typedef enum Preload_State
+{
+    PRELOAD_LOADING,
+    PRELOAD_READY,
+    PRELOAD_FAILED,
+    PRELOAD_DROPPING, // Cancelled; waiting for the loader to wind down before it is freed
+} Preload_State;
+
+typedef struct Preload_Entry
+{
+    char path[BZZT_MAX_PATH_LENGTH];
+    char member[BZZT_MAX_PATH_LENGTH];
+    Preload_State state;
+    Bzzt_World_Loader *loader; // Set while LOADING or DROPPING
+    Bzzt_World *world;         // Set once READY
+    Bzzt_World_Preview preview;
+    uint64_t last_used;
+} Preload_Entry;
+
+struct Bzzt_World_Preload
+{
+    // Guards entries and doomed against the memory budget's evict callback, which can run on any thread.
+    // Never held while calling Bzzt_Mem_Cache_Remove/Trim or waiting on a loader.
+    pthread_mutex_t lock;
+    Preload_Entry *entries;
+    int entries_count, entries_cap;
+    int capacity; // Entries kept besides the DROPPING ones
+    double settle_ms;
+
+    // The selection the cursor is resting on, and for how long
+    char selected_path[BZZT_MAX_PATH_LENGTH];
+    char selected_member[BZZT_MAX_PATH_LENGTH];
+    bool has_selection;
+    double rest_ms;
+    uint64_t tick;
+
+    // Ready worlds dropped under the lock, freed once it is released
+    Bzzt_World **doomed;
+    int doomed_count, doomed_cap;
+};
+
+static bool entry_matches(const Preload_Entry *entry, const char *path, const char *member)
+{
+    return entry->state != PRELOAD_DROPPING && strcmp(entry->path, path) == 0 &&
+           strcmp(entry->member, member ? member : "") == 0;
+}
+
+static Preload_Entry *find_entry(Bzzt_World_Preload *p, const char *path, const char *member)
+{
+    if (!path)
+        return NULL;
+
+    for (int i = 0; i < p->entries_count; ++i)
+    {
+        if (entry_matches(&p->entries[i], path, member))
+            return &p->entries[i];
+    }
+    return NULL;
+}
+
+static void remove_entry(Bzzt_World_Preload *p, Preload_Entry *entry)
+{
+    int idx = (int)(entry - p->entries);
+    memmove(&p->entries[idx], &p->entries[idx + 1], sizeof(Preload_Entry) * (p->entries_count - idx - 1));
+    p->entries_count--;
+}
+
+// Caller holds p->lock. The world goes once the lock is released (flush_doomed).
+static void doom_world(Bzzt_World_Preload *p, Bzzt_World *world)
+{
+    if (p->doomed_count == p->doomed_cap)
+    {
+        int new_cap = p->doomed_cap ? p->doomed_cap * 2 : 4;
+        Bzzt_World **grown = realloc(p->doomed, sizeof(Bzzt_World *) * new_cap);
+        if (!grown)
+        {
+            // Rather leak the bookkeeping than free a world the budget still tracks
+            Debug_Log(LOG_LEVEL_ERROR, LOG_ENGINE, "Out of memory dropping a preloaded world.");
+            return;
+        }
+        p->doomed = grown;
+        p->doomed_cap = new_cap;
+    }
+    p->doomed[p->doomed_count++] = world;
+}
+
+static void flush_doomed(Bzzt_World_Preload *p)
+{
+    pthread_mutex_lock(&p->lock);
+    Bzzt_World **doomed = p->doomed;
+    int count = p->doomed_count;
+    p->doomed = NULL;
+    p->doomed_count = p->doomed_cap = 0;
+    pthread_mutex_unlock(&p->lock);
+
+    for (int i = 0; i < count; ++i)
+    {
+        Bzzt_Mem_Cache_Remove(doomed[i]);
+        Bzzt_World_Destroy(doomed[i]);
+    }
+    free(doomed);
+}
+
+// Memory budget evict callback: item is a ready world
+static bool evict_world(void *ctx, void *item)
+{
+    Bzzt_World_Preload *p = (Bzzt_World_Preload *)ctx;
+    Bzzt_World *world = NULL;
+    pthread_mutex_lock(&p->lock);
+    for (int i = 0; i < p->entries_count; ++i)
+    {
+        if (p->entries[i].state == PRELOAD_READY && p->entries[i].world == item)
+        {
+            world = p->entries[i].world;
+            remove_entry(p, &p->entries[i]);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&p->lock);
+
+    if (world)
+    {
+        Debug_Log(LOG_LEVEL_DEBUG, LOG_ENGINE, "Dropped preloaded %s to stay within the memory budget.",
+                  world->file_path);
+        Bzzt_World_Destroy(world);
+    }
+    return true;
+}
+
+// Caller holds p->lock. Let go of an entry: a running load is cancelled and reaped later, a world is doomed.
+static void drop_entry(Bzzt_World_Preload *p, Preload_Entry *entry)
+{
+    if (entry->state == PRELOAD_LOADING)
+    {
+        Bzzt_World_Loader_Cancel(entry->loader);
+        entry->state = PRELOAD_DROPPING;
+        return;
+    }
+
+    if (entry->world)
+        doom_world(p, entry->world);
+    remove_entry(p, entry);
+}
+
+// Caller holds p->lock. Collect loads that have finished, without waiting on any that haven't.
+static void reap_finished(Bzzt_World_Preload *p)
+{
+    for (int i = p->entries_count - 1; i >= 0; --i)
+    {
+        Preload_Entry *entry = &p->entries[i];
+        if (!entry->loader || !Bzzt_World_Loader_Poll(entry->loader))
+            continue;
+
+        size_t size = Bzzt_World_Loader_Source_Size(entry->loader);
+        char error[192] = {0};
+        Bzzt_World *world = Bzzt_World_Loader_Finish(entry->loader, error, sizeof(error));
+        entry->loader = NULL;
+
+        if (entry->state == PRELOAD_DROPPING)
+        {
+            if (world)
+                doom_world(p, world);
+            remove_entry(p, entry);
+            continue;
+        }
+
+        if (!world)
+        {
+            Debug_Log(LOG_LEVEL_DEBUG, LOG_ENGINE, "Preloading %s failed: %s", entry->path, error);
+            entry->state = PRELOAD_FAILED;
+            continue;
+        }
+
+        entry->world = world;
+        entry->state = PRELOAD_READY;
+        snprintf(entry->preview.title, sizeof(entry->preview.title), "%s", world->title);
+        entry->preview.board_count = world->boards_count;
+        entry->preview.size = size;
+        Bzzt_Mem_Cache_Insert(BZZT_MEM_CACHE_WORLDS, world, Bzzt_World_Memory_Estimate(world), evict_world, p);
+    }
+}
+
+static int kept_entries(const Bzzt_World_Preload *p)
+{
+    int kept = 0;
+    for (int i = 0; i < p->entries_count; ++i)
+        kept += p->entries[i].state != PRELOAD_DROPPING;
+    return kept;
+}
+
+// Make room for one more entry by dropping the least recently selected ones
+static void evict_for_new_entry(Bzzt_World_Preload *p)
+{
+    while (kept_entries(p) >= p->capacity)
+    {
+        Preload_Entry *oldest = NULL;
+        for (int i = 0; i < p->entries_count; ++i)
+        {
+            Preload_Entry *entry = &p->entries[i];
+            if (entry->state != PRELOAD_DROPPING && (!oldest || entry->last_used < oldest->last_used))
+                oldest = entry;
+        }
+        if (!oldest)
+            return;
+        drop_entry(p, oldest);
+    }
+}
+
+static void start_preload(Bzzt_World_Preload *p)
+{
+    // Only the selection is worth loading; stop whatever an earlier one started
+    for (int i = 0; i < p->entries_count; ++i)
+    {
+        if (p->entries[i].state == PRELOAD_LOADING)
+            drop_entry(p, &p->entries[i]);
+    }
+
+    evict_for_new_entry(p);
+
+    if (p->entries_count == p->entries_cap)
+    {
+        int new_cap = p->entries_cap ? p->entries_cap * 2 : 4;
+        Preload_Entry *grown = realloc(p->entries, sizeof(Preload_Entry) * new_cap);
+        if (!grown)
+            return;
+        p->entries = grown;
+        p->entries_cap = new_cap;
+    }
+
+    Preload_Entry *entry = &p->entries[p->entries_count];
+    memset(entry, 0, sizeof(*entry));
+    snprintf(entry->path, sizeof(entry->path), "%s", p->selected_path);
+    snprintf(entry->member, sizeof(entry->member), "%s", p->selected_member);
+    entry->last_used = p->tick;
+    entry->loader = Bzzt_World_Loader_Start(entry->path, entry->member);
+    entry->state = entry->loader ? PRELOAD_LOADING : PRELOAD_FAILED;
+    p->entries_count++;
+}
+
+Bzzt_World_Preload *Bzzt_World_Preload_Create(int capacity, double settle_ms)
+{
+    Bzzt_World_Preload *p = calloc(1, sizeof(Bzzt_World_Preload));
+    if (!p)
+        return NULL;
+
+    p->capacity = capacity > 0 ? capacity : 1;
+    p->settle_ms = settle_ms;
+    pthread_mutex_init(&p->lock, NULL);
+    return p;
+}
+
+void Bzzt_World_Preload_Destroy(Bzzt_World_Preload *p)
+{
+    if (!p)
+        return;
+
+    Bzzt_World_Preload_Clear(p);
+    pthread_mutex_destroy(&p->lock);
+    free(p->entries);
+    free(p);
+}
+
+void Bzzt_World_Preload_Update(Bzzt_World_Preload *p, const char *path, const char *member, double elapsed_ms)
+{
+    if (!p)
+        return;
+
+    pthread_mutex_lock(&p->lock);
+    reap_finished(p);
+    p->tick++;
+
+    if (!member)
+        member = "";
+    if (!path)
+    {
+        p->has_selection = false;
+    }
+    else if (!p->has_selection || strcmp(p->selected_path, path) != 0 || strcmp(p->selected_member, member) != 0)
+    {
+        snprintf(p->selected_path, sizeof(p->selected_path), "%s", path);
+        snprintf(p->selected_member, sizeof(p->selected_member), "%s", member);
+        p->has_selection = true;
+        p->rest_ms = 0.0;
+    }
+    else
+    {
+        p->rest_ms += elapsed_ms;
+    }
+
+    Preload_Entry *entry = path ? find_entry(p, path, member) : NULL;
+    if (entry)
+    {
+        entry->last_used = p->tick;
+        if (entry->world)
+            Bzzt_Mem_Cache_Touch(entry->world);
+    }
+    else if (path && p->rest_ms >= p->settle_ms)
+    {
+        start_preload(p);
+    }
+    pthread_mutex_unlock(&p->lock);
+
+    flush_doomed(p);
+    Bzzt_Mem_Cache_Trim(); // Worlds that just finished loading count against the budget now
+}
+
+bool Bzzt_World_Preload_Preview(Bzzt_World_Preload *p, const char *path, const char *member, Bzzt_World_Preview *out)
+{
+    if (!p || !out)
+        return false;
+
+    pthread_mutex_lock(&p->lock);
+    Preload_Entry *entry = find_entry(p, path, member);
+    bool ready = entry && entry->state == PRELOAD_READY;
+    if (ready)
+        *out = entry->preview;
+    pthread_mutex_unlock(&p->lock);
+    return ready;
+}
+
+Bzzt_World *Bzzt_World_Preload_Take(Bzzt_World_Preload *p,
+                                    const char *path,
+                                    const char *member,
+                                    Bzzt_World_Loader **running)
+{
+    if (running)
+        *running = NULL;
+    if (!p)
+        return NULL;
+
+    pthread_mutex_lock(&p->lock);
+    Preload_Entry *entry = find_entry(p, path, member);
+    Bzzt_World *world = entry ? entry->world : NULL;
+    Bzzt_World_Loader *loader = entry && entry->state == PRELOAD_LOADING ? entry->loader : NULL;
+    if (entry)
+        remove_entry(p, entry);
+    pthread_mutex_unlock(&p->lock);
+
+    if (world)
+        Bzzt_Mem_Cache_Remove(world); // The caller's now, not a cache entry
+    if (running)
+        *running = loader;
+    else if (loader)
+        Bzzt_World_Destroy(Bzzt_World_Loader_Finish(loader, NULL, 0));
+    return world;
+}
+
+void Bzzt_World_Preload_Clear(Bzzt_World_Preload *p)
+{
+    if (!p)
+        return;
+
+    // Take everything out under the lock, then wait on loaders and free worlds without it
+    pthread_mutex_lock(&p->lock);
+    Preload_Entry *entries = p->entries;
+    int count = p->entries_count;
+    p->entries = NULL;
+    p->entries_count = p->entries_cap = 0;
+    p->has_selection = false;
+    pthread_mutex_unlock(&p->lock);
+
+    for (int i = 0; i < count; ++i)
+        Bzzt_World_Loader_Cancel(entries[i].loader);
+    for (int i = 0; i < count; ++i)
+    {
+        if (entries[i].loader)
+            Bzzt_World_Destroy(Bzzt_World_Loader_Finish(entries[i].loader, NULL, 0));
+        if (entries[i].world)
+        {
+            Bzzt_Mem_Cache_Remove(entries[i].world);
+            Bzzt_World_Destroy(entries[i].world);
+        }
+    }
+    free(entries);
+    flush_doomed(p);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct Bzzt_World Bzzt_World;
+typedef struct Bzzt_World_Loader Bzzt_World_Loader;
+
+#define BZZT_WORLD_PRELOAD_CAPACITY 3      // Worlds kept loaded ahead of Enter
+#define BZZT_WORLD_PRELOAD_SETTLE_MS 250.0 // How long the cursor rests on a world before it is loaded
+
+// What the file browser shows about a preloaded world
+typedef struct Bzzt_World_Preview
+{
+    char title[64];
+    int board_count;
+    size_t size; // Bytes of .zzt or .bzzt data
+} Bzzt_World_Preview;
+
+/* Loads the world under the file browser cursor in the background once the
+ * cursor has rested on it, and keeps the last few around so opening one is
+ * immediate. Call it from the main thread; the loading itself is done by
+ * Bzzt_World_Loader. Ready worlds count against the shared memory budget
+ * (mem_cache.h), which may drop them from another thread. */
+typedef struct Bzzt_World_Preload Bzzt_World_Preload;
+
+Bzzt_World_Preload *Bzzt_World_Preload_Create(int capacity, double settle_ms);
+// Cancels running loads and frees every preloaded world
+void Bzzt_World_Preload_Destroy(Bzzt_World_Preload *p);
+// Call every frame with the selected world (path NULL when the selection is not a world).
+// Collects finished loads and starts one for the selection once it has settled.
+void Bzzt_World_Preload_Update(Bzzt_World_Preload *p, const char *path, const char *member, double elapsed_ms);
+// Fill out with the selected world's details; false until it has finished loading
+bool Bzzt_World_Preload_Preview(Bzzt_World_Preload *p, const char *path, const char *member, Bzzt_World_Preview *out);
+// Hand over the preloaded world, or its still running loader in *running (NULL if neither).
+// Either way the entry leaves the preload.
+Bzzt_World *Bzzt_World_Preload_Take(Bzzt_World_Preload *p,
+                                    const char *path,
+                                    const char *member,
+                                    Bzzt_World_Loader **running);
+// Drop every preloaded world, e.g. when the file browser closes
+void Bzzt_World_Preload_Clear(Bzzt_World_Preload *p);
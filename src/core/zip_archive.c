@@ -2,24 +2,53 @@
 
 #include <ctype.h>
 #include <limits.h>
+#include <pthread.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
 #include <sys/stat.h>
-#include <unistd.h>
 
+#include "file_map.h"
+#include "mem_cache.h"
 #include "miniz.h"
 
 #ifndef PATH_MAX
 #define PATH_MAX 4096
 #endif
 
-#define ZIP_ARCHIVE_MAX_BYTES (64 * 1024 * 1024)
-#define ZIP_ARCHIVE_MAX_ENTRIES 4096
+#define ZIP_ARCHIVE_MAX_NESTED_BYTES (64 * 1024 * 1024)
 #define ZIP_ARCHIVE_MAX_WORLD_BYTES (8 * 1024 * 1024)
 #define ZIP_ARCHIVE_MAX_MEMBER_PATH 512
+#define ZIP_ARCHIVE_NESTED_SEPARATOR "!/"
+#define ZIP_ARCHIVE_INDEX_CACHE_COUNT 16
+
+#define ZIP_SIG_LOCAL 0x04034b50u
+#define ZIP_SIG_CENTRAL 0x02014b50u
+#define ZIP_SIG_END 0x06054b50u
+#define ZIP_SIG_END64 0x06064b50u
+#define ZIP_SIG_END64_LOCATOR 0x07064b50u
+#define ZIP_LOCAL_HEADER_SIZE 30
+#define ZIP_CENTRAL_HEADER_SIZE 46
+#define ZIP_END_SIZE 22
+#define ZIP_END64_SIZE 56
+#define ZIP_END64_LOCATOR_SIZE 20
+#define ZIP_MAX_COMMENT 65535
+#define ZIP_EXTRA_ZIP64 0x0001
+#define ZIP_METHOD_STORED 0
+#define ZIP_METHOD_DEFLATED 8
+#define ZIP_DOS_DIRECTORY_ATTR 0x10
+// Encrypted, patch data, or strongly encrypted
+#define ZIP_FLAG_UNSUPPORTED 0x0061
+
+// Size and mtime of the file on disk an archive path is read from
+typedef struct ZipArchiveSource
+{
+    long long size;
+    long long mtime;
+} ZipArchiveSource;
 
 static void zip_archive_set_error(char *out_error, size_t out_error_size, const char *fmt, ...)
 {
@@ -32,24 +61,14 @@ static void zip_archive_set_error(char *out_error, size_t out_error_size, const
     va_end(args);
 }
 
-static bool zip_archive_check_file_size(const char *archive_path, char *out_error, size_t out_error_size)
+static char *zip_archive_strndup(const char *text, size_t len)
 {
-    struct stat st = {0};
-    if (!archive_path || stat(archive_path, &st) != 0)
-    {
-        zip_archive_set_error(out_error, out_error_size, "Unable to open that zip archive.");
-        return false;
-    }
-
-    if ((mz_uint64)st.st_size > ZIP_ARCHIVE_MAX_BYTES)
-    {
-        zip_archive_set_error(out_error,
-                              out_error_size,
-                              "Zip archive is too large to inspect safely.");
-        return false;
-    }
-
-    return true;
+    char *copy = malloc(len + 1);
+    if (!copy)
+        return NULL;
+    memcpy(copy, text, len);
+    copy[len] = '\0';
+    return copy;
 }
 
 static bool zip_archive_normalize_path(const char *in_path, char *out_path, size_t out_path_size)
@@ -127,26 +146,6 @@ static int zip_archive_member_type(const char *path)
     return zip_archive_world_type(path);
 }
 
-static bool zip_archive_entry_matches_dir(const char *member_path,
-                                          const char *current_dir,
-                                          char *out_remainder,
-                                          size_t out_remainder_size)
-{
-    if (!member_path || !current_dir || !out_remainder || out_remainder_size == 0)
-        return false;
-
-    if (current_dir[0] == '\0')
-        return snprintf(out_remainder, out_remainder_size, "%s", member_path) < (int)out_remainder_size;
-
-    size_t dir_len = strlen(current_dir);
-    if (strncmp(member_path, current_dir, dir_len) != 0)
-        return false;
-    if (member_path[dir_len] != '/')
-        return false;
-
-    return snprintf(out_remainder, out_remainder_size, "%s", member_path + dir_len + 1) < (int)out_remainder_size;
-}
-
 static bool zip_archive_reserve_entries(ZipArchiveEntry **entries, int *cap, int needed)
 {
     if (!entries || !cap)
@@ -167,23 +166,6 @@ static bool zip_archive_reserve_entries(ZipArchiveEntry **entries, int *cap, int
     return true;
 }
 
-static bool zip_archive_has_entry(const ZipArchiveEntry *entries,
-                                  int count,
-                                  const char *path,
-                                  ZipArchiveEntryType type)
-{
-    if (!entries || !path)
-        return false;
-
-    for (int i = 0; i < count; ++i)
-    {
-        if (entries[i].type == type && strcmp(entries[i].path, path) == 0)
-            return true;
-    }
-
-    return false;
-}
-
 static bool zip_archive_add_entry(ZipArchiveEntry **entries,
                                   int *count,
                                   int *cap,
@@ -244,144 +226,1114 @@ static int zip_archive_compare_entries(const void *lhs, const void *rhs)
     return strcasecmp(a->name, b->name);
 }
 
-bool ZipArchive_List(const char *archive_path,
-                     const char *current_dir,
-                     ZipArchiveEntry **out_entries,
-                     int *out_count,
-                     char *out_error,
-                     size_t out_error_size)
+// Follow a possibly nested path down to the real file that holds it
+static bool zip_archive_identify_source(const char *archive_path, ZipArchiveSource *out_source)
 {
-    if (!archive_path || !current_dir || !out_entries || !out_count)
+    char path[PATH_MAX] = {0};
+    if (!archive_path || snprintf(path, sizeof(path), "%s", archive_path) >= (int)sizeof(path))
         return false;
 
-    *out_entries = NULL;
-    *out_count = 0;
+    for (;;)
+    {
+        struct stat st = {0};
+        if (stat(path, &st) == 0 && S_ISREG(st.st_mode))
+        {
+            out_source->size = (long long)st.st_size;
+            out_source->mtime = (long long)st.st_mtime;
+            return true;
+        }
+
+        char *sep = NULL;
+        for (char *p = strstr(path, ZIP_ARCHIVE_NESTED_SEPARATOR); p; p = strstr(p + 1, ZIP_ARCHIVE_NESTED_SEPARATOR))
+            sep = p;
+        if (!sep || sep == path)
+            return false;
+        *sep = '\0';
+    }
+}
+
+static bool zip_archive_same_source(const ZipArchiveSource *a, const ZipArchiveSource *b)
+{
+    return a->size == b->size && a->mtime == b->mtime;
+}
+
+/*
+ * Nested archives are named by joining the outer archive path and the
+ * member path with "!/", e.g. "worlds.zip!/packs/extra.zip". Their bytes
+ * are inflated once into a shared cache and opened straight from memory, so
+ * browsing zip-in-zip collections never touches the disk. The cache is held
+ * to the shared memory budget (mem_cache.h), which evicts unused buffers.
+ */
+typedef struct ZipNestedBuffer
+{
+    char *key;
+    ZipArchiveSource source;
+    uint8_t *data;
+    size_t size;
+    int refs;
+    struct ZipNestedBuffer *next;
+} ZipNestedBuffer;
+
+static pthread_mutex_t nested_lock = PTHREAD_MUTEX_INITIALIZER;
+static ZipNestedBuffer *nested_buffers = NULL;
+
+static void zip_nested_free(ZipNestedBuffer *buf)
+{
+    free(buf->key);
+    free(buf->data);
+    free(buf);
+}
+
+// Memory budget evict callback; buffers still open stay
+static bool zip_nested_evict(void *ctx, void *item)
+{
+    (void)ctx;
+    pthread_mutex_lock(&nested_lock);
+    for (ZipNestedBuffer **it = &nested_buffers; *it; it = &(*it)->next)
+    {
+        ZipNestedBuffer *buf = *it;
+        if (buf != item)
+            continue;
+        if (buf->refs > 0)
+        {
+            pthread_mutex_unlock(&nested_lock);
+            return false;
+        }
+        *it = buf->next;
+        pthread_mutex_unlock(&nested_lock);
+        zip_nested_free(buf);
+        return true;
+    }
+    pthread_mutex_unlock(&nested_lock);
+    return true;
+}
+
+static ZipNestedBuffer *zip_nested_acquire(const char *key, const ZipArchiveSource *source)
+{
+    pthread_mutex_lock(&nested_lock);
+    ZipNestedBuffer *found = NULL;
+    for (ZipNestedBuffer *it = nested_buffers; it; it = it->next)
+    {
+        if (strcmp(it->key, key) == 0 && zip_archive_same_source(&it->source, source))
+        {
+            found = it;
+            found->refs++;
+            Bzzt_Mem_Cache_Touch(found);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&nested_lock);
+    return found;
+}
+
+// Takes ownership of data. Returns the cached buffer, acquired, or NULL on failure.
+static ZipNestedBuffer *zip_nested_insert(const char *key,
+                                          const ZipArchiveSource *source,
+                                          uint8_t *data,
+                                          size_t size)
+{
+    ZipNestedBuffer *buf = calloc(1, sizeof(ZipNestedBuffer));
+    char *key_copy = strdup(key);
+    if (!buf || !key_copy)
+    {
+        free(buf);
+        free(key_copy);
+        free(data);
+        return NULL;
+    }
+    buf->key = key_copy;
+    buf->source = *source;
+    buf->data = data;
+    buf->size = size;
+    buf->refs = 1;
+
+    pthread_mutex_lock(&nested_lock);
+    // Another caller may have inflated the same member meanwhile; keep theirs
+    for (ZipNestedBuffer *it = nested_buffers; it; it = it->next)
+    {
+        if (strcmp(it->key, key) == 0 && zip_archive_same_source(&it->source, source))
+        {
+            it->refs++;
+            Bzzt_Mem_Cache_Touch(it);
+            pthread_mutex_unlock(&nested_lock);
+            zip_nested_free(buf);
+            return it;
+        }
+    }
+
+    buf->next = nested_buffers;
+    nested_buffers = buf;
+    Bzzt_Mem_Cache_Insert(BZZT_MEM_CACHE_ZIP_MEMBERS, buf, sizeof(*buf) + strlen(key) + 1 + size, zip_nested_evict,
+                          NULL);
+    pthread_mutex_unlock(&nested_lock);
+
+    // Make room for it among the other unused buffers and caches
+    Bzzt_Mem_Cache_Trim();
+    return buf;
+}
+
+static void zip_nested_release(ZipNestedBuffer *buf)
+{
+    if (!buf)
+        return;
 
-    if (!zip_archive_check_file_size(archive_path, out_error, out_error_size))
+    pthread_mutex_lock(&nested_lock);
+    bool unused = --buf->refs == 0;
+    pthread_mutex_unlock(&nested_lock);
+
+    // It may be what has to go to get back under budget
+    if (unused)
+        Bzzt_Mem_Cache_Trim();
+}
+
+// Split "outer!/member" at its last separator, unless the whole thing names a real file
+static bool zip_archive_split_nested(const char *archive_path, char *out_parent, size_t out_parent_size, const char **out_member)
+{
+    struct stat st = {0};
+    if (stat(archive_path, &st) == 0 && S_ISREG(st.st_mode))
         return false;
 
-    char normalized_dir[ZIP_ARCHIVE_MAX_MEMBER_PATH] = {0};
-    if (!zip_archive_normalize_path(current_dir, normalized_dir, sizeof(normalized_dir)))
+    const char *sep = NULL;
+    for (const char *p = strstr(archive_path, ZIP_ARCHIVE_NESTED_SEPARATOR); p; p = strstr(p + 1, ZIP_ARCHIVE_NESTED_SEPARATOR))
+        sep = p;
+    if (!sep || sep == archive_path)
+        return false;
+
+    size_t parent_len = (size_t)(sep - archive_path);
+    if (parent_len >= out_parent_size)
+        return false;
+
+    memcpy(out_parent, archive_path, parent_len);
+    out_parent[parent_len] = '\0';
+    *out_member = sep + strlen(ZIP_ARCHIVE_NESTED_SEPARATOR);
+    return true;
+}
+
+/*
+ * Archives are read in place from a file mapping (or a nested archive's
+ * buffer) rather than through miniz's reader, which copies the whole
+ * central directory to the heap up front. Only the end records are parsed
+ * on open. The central directory is still read in full, once per archive,
+ * when zip_index_build walks it into the cached index (O(entries) heap);
+ * what the mapping saves is the copy of the raw directory, not the reading
+ * of it. Neither archive size nor entry count needs a cap. Zip64 end
+ * records and extra fields are understood.
+ */
+typedef struct ZipReader
+{
+    Bzzt_File_Map map;
+    ZipNestedBuffer *nested;
+    const uint8_t *data;
+    uint64_t size;
+    uint64_t dir_offset;
+    uint64_t dir_size;
+    uint64_t entry_count;
+} ZipReader;
+
+// One central directory record, pointing into the reader's bytes
+typedef struct ZipMember
+{
+    const char *name; // not NUL-terminated
+    size_t name_len;
+    uint64_t comp_size;
+    uint64_t uncomp_size;
+    uint64_t local_offset;
+    uint64_t next_record;
+    uint32_t crc32;
+    uint16_t method;
+    bool is_directory;
+    bool is_supported; // stored or deflated, and not encrypted
+} ZipMember;
+
+static uint16_t zip_read_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t zip_read_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t zip_read_u64(const uint8_t *p)
+{
+    return (uint64_t)zip_read_u32(p) | ((uint64_t)zip_read_u32(p + 4) << 32);
+}
+
+static bool zip_reader_locate_directory(ZipReader *reader)
+{
+    const uint8_t *data = reader->data;
+    uint64_t size = reader->size;
+    if (size < ZIP_END_SIZE)
+        return false;
+
+    // The end record is followed by a comment of at most 64 KB
+    uint64_t lowest = size > ZIP_END_SIZE + ZIP_MAX_COMMENT ? size - ZIP_END_SIZE - ZIP_MAX_COMMENT : 0;
+    uint64_t end = size - ZIP_END_SIZE;
+    while (zip_read_u32(data + end) != ZIP_SIG_END)
     {
-        zip_archive_set_error(out_error, out_error_size, "Zip path is too long.");
+        if (end == lowest)
+            return false;
+        end--;
+    }
+
+    uint16_t disk = zip_read_u16(data + end + 4);
+    uint16_t dir_disk = zip_read_u16(data + end + 6);
+    uint64_t entry_count = zip_read_u16(data + end + 10);
+    uint64_t dir_size = zip_read_u32(data + end + 12);
+    uint64_t dir_offset = zip_read_u32(data + end + 16);
+
+    // Zip64 archives keep the real values in a second end record found through a locator
+    if (end >= ZIP_END64_LOCATOR_SIZE &&
+        zip_read_u32(data + end - ZIP_END64_LOCATOR_SIZE) == ZIP_SIG_END64_LOCATOR)
+    {
+        uint64_t end64 = zip_read_u64(data + end - ZIP_END64_LOCATOR_SIZE + 8);
+        if (size < ZIP_END64_SIZE || end64 > size - ZIP_END64_SIZE ||
+            zip_read_u32(data + end64) != ZIP_SIG_END64)
+            return false;
+
+        disk = (uint16_t)zip_read_u32(data + end64 + 16);
+        dir_disk = (uint16_t)zip_read_u32(data + end64 + 20);
+        entry_count = zip_read_u64(data + end64 + 32);
+        dir_size = zip_read_u64(data + end64 + 40);
+        dir_offset = zip_read_u64(data + end64 + 48);
+    }
+
+    // Spanned archives are not supported
+    if (disk != 0 || dir_disk != 0)
+        return false;
+    if (dir_offset > size || dir_size > size - dir_offset)
         return false;
+    if (entry_count > dir_size / ZIP_CENTRAL_HEADER_SIZE)
+        return false;
+
+    reader->dir_offset = dir_offset;
+    reader->dir_size = dir_size;
+    reader->entry_count = entry_count;
+    return true;
+}
+
+static bool zip_reader_member(const ZipReader *reader, uint64_t record, ZipMember *out)
+{
+    uint64_t dir_end = reader->dir_offset + reader->dir_size;
+    if (record < reader->dir_offset || record > dir_end || dir_end - record < ZIP_CENTRAL_HEADER_SIZE)
+        return false;
+
+    const uint8_t *p = reader->data + record;
+    if (zip_read_u32(p) != ZIP_SIG_CENTRAL)
+        return false;
+
+    uint16_t flags = zip_read_u16(p + 8);
+    size_t name_len = zip_read_u16(p + 28);
+    size_t extra_len = zip_read_u16(p + 30);
+    size_t comment_len = zip_read_u16(p + 32);
+    uint64_t record_len = ZIP_CENTRAL_HEADER_SIZE + name_len + extra_len + comment_len;
+    if (dir_end - record < record_len)
+        return false;
+
+    out->name = (const char *)p + ZIP_CENTRAL_HEADER_SIZE;
+    out->name_len = name_len;
+    out->method = zip_read_u16(p + 10);
+    out->crc32 = zip_read_u32(p + 16);
+    out->comp_size = zip_read_u32(p + 20);
+    out->uncomp_size = zip_read_u32(p + 24);
+    out->local_offset = zip_read_u32(p + 42);
+    out->next_record = record + record_len;
+
+    // Sizes and offsets that overflowed 32 bits are stored, in order, in the zip64 extra field
+    const uint8_t *extra = p + ZIP_CENTRAL_HEADER_SIZE + name_len;
+    const uint8_t *extra_end = extra + extra_len;
+    while (extra_end - extra >= 4)
+    {
+        uint16_t id = zip_read_u16(extra);
+        const uint8_t *field = extra + 4;
+        const uint8_t *field_end = field + zip_read_u16(extra + 2);
+        if (field_end > extra_end)
+            break;
+
+        if (id == ZIP_EXTRA_ZIP64)
+        {
+            if (out->uncomp_size == UINT32_MAX && field_end - field >= 8)
+            {
+                out->uncomp_size = zip_read_u64(field);
+                field += 8;
+            }
+            if (out->comp_size == UINT32_MAX && field_end - field >= 8)
+            {
+                out->comp_size = zip_read_u64(field);
+                field += 8;
+            }
+            if (out->local_offset == UINT32_MAX && field_end - field >= 8)
+                out->local_offset = zip_read_u64(field);
+            break;
+        }
+        extra = field_end;
     }
 
-    mz_zip_archive archive;
-    MZ_CLEAR_OBJ(archive);
-    if (!mz_zip_reader_init_file(&archive, archive_path, 0))
+    uint32_t external_attr = zip_read_u32(p + 38);
+    out->is_directory = (name_len > 0 && out->name[name_len - 1] == '/') ||
+                        (external_attr & ZIP_DOS_DIRECTORY_ATTR) != 0;
+    out->is_supported = (flags & ZIP_FLAG_UNSUPPORTED) == 0 &&
+                        (out->method == ZIP_METHOD_STORED || out->method == ZIP_METHOD_DEFLATED);
+    return true;
+}
+
+// Inflate a member into out, which must be exactly uncomp_size bytes, and check its CRC
+static bool zip_reader_extract(const ZipReader *reader, const ZipMember *member, uint8_t *out, size_t out_size)
+{
+    if (!member->is_supported || member->uncomp_size != out_size)
+        return false;
+    if (!Bzzt_File_Map_Covers(&reader->map, reader->size))
+        return false;
+
+    uint64_t local = member->local_offset;
+    if (local > reader->size || reader->size - local < ZIP_LOCAL_HEADER_SIZE)
+        return false;
+    if (zip_read_u32(reader->data + local) != ZIP_SIG_LOCAL)
+        return false;
+
+    uint64_t data_offset = local + ZIP_LOCAL_HEADER_SIZE +
+                           zip_read_u16(reader->data + local + 26) +
+                           zip_read_u16(reader->data + local + 28);
+    if (data_offset > reader->size || reader->size - data_offset < member->comp_size)
+        return false;
+
+    const uint8_t *src = reader->data + data_offset;
+    if (member->method == ZIP_METHOD_STORED)
+    {
+        if (member->comp_size != out_size)
+            return false;
+        memcpy(out, src, out_size);
+    }
+    else if (tinfl_decompress_mem_to_mem(out, out_size, src, (size_t)member->comp_size, 0) != out_size)
     {
+        return false;
+    }
+
+    return mz_crc32(MZ_CRC32_INIT, out, out_size) == member->crc32;
+}
+
+/*
+ * Parsed directory trees, one per archive, so moving between folders inside
+ * a zip is a lookup rather than a central directory scan. An index is keyed
+ * by the archive path plus the size and mtime of the file on disk that the
+ * path lives in (the outermost archive for nested paths); touching that file
+ * makes the next lookup rebuild it. Members and folders are found through
+ * open-addressed hash tables, and each folder's listing is kept sorted.
+ * Besides the cap on their number, indexes count against the shared memory
+ * budget (mem_cache.h).
+ */
+typedef struct ZipIndexMember
+{
+    char *path; // normalized
+    uint64_t record; // offset of its central directory record
+} ZipIndexMember;
+
+// Entry names point into their paths; only the paths are allocated
+typedef struct ZipIndexDir
+{
+    char *path; // normalized, "" for the root
+    ZipArchiveEntry *entries;
+    int count;
+    int cap;
+} ZipIndexDir;
+
+typedef struct ZipIndex
+{
+    char *key;
+    ZipArchiveSource source;
+    ZipIndexMember *members; // in archive order
+    int member_count;
+    int *member_slots; // member index + 1, 0 for empty
+    size_t member_slot_count;
+    ZipIndexDir *dirs; // dirs[0] is the root
+    int dir_count;
+    int dir_cap;
+    int *dir_slots; // dir index + 1, 0 for empty
+    size_t dir_slot_count;
+    bool has_supported_entry;
+    int refs;
+    unsigned long last_used;
+    struct ZipIndex *next;
+} ZipIndex;
+
+static pthread_mutex_t index_lock = PTHREAD_MUTEX_INITIALIZER;
+static ZipIndex *indexes = NULL;
+static int index_count = 0;
+static unsigned long index_clock = 0;
+
+static bool zip_reader_open(const char *archive_path, ZipReader *reader, char *out_error, size_t out_error_size);
+static void zip_reader_close(ZipReader *reader);
+static ZipIndex *zip_index_acquire(const char *archive_path,
+                                   ZipReader *open_reader,
+                                   char *out_error,
+                                   size_t out_error_size);
+static void zip_index_release(ZipIndex *index);
+static bool zip_index_find_member(const ZipIndex *index, const char *normalized_member, uint64_t *out_record);
+
+// Look a member up through the archive's index and read its central directory record
+static bool zip_reader_find_member(ZipReader *reader,
+                                   const char *archive_path,
+                                   const char *normalized_member,
+                                   ZipMember *out_member,
+                                   char *out_error,
+                                   size_t out_error_size)
+{
+    ZipIndex *index = zip_index_acquire(archive_path, reader, out_error, out_error_size);
+    if (!index)
+        return false;
+
+    uint64_t record = 0;
+    bool found = zip_index_find_member(index, normalized_member, &record);
+    zip_index_release(index);
+    return found && zip_reader_member(reader, record, out_member);
+}
+
+static ZipNestedBuffer *zip_archive_load_nested(const char *archive_path,
+                                                const ZipArchiveSource *source,
+                                                const char *parent_path,
+                                                const char *member_path,
+                                                char *out_error,
+                                                size_t out_error_size)
+{
+    ZipNestedBuffer *cached = zip_nested_acquire(archive_path, source);
+    if (cached)
+        return cached;
+
+    char normalized_member[ZIP_ARCHIVE_MAX_MEMBER_PATH] = {0};
+    if (!zip_archive_normalize_path(member_path, normalized_member, sizeof(normalized_member)))
+    {
+        zip_archive_set_error(out_error, out_error_size, "Zip member path is too long.");
+        return NULL;
+    }
+
+    ZipReader parent;
+    if (!zip_reader_open(parent_path, &parent, out_error, out_error_size))
+        return NULL;
+
+    ZipMember member;
+    uint8_t *data = NULL;
+    size_t size = 0;
+    if (!zip_reader_find_member(&parent, parent_path, normalized_member, &member, out_error, out_error_size) ||
+        zip_archive_member_type(normalized_member) != ZIP_ARCHIVE_ENTRY_ZIP ||
+        member.is_directory || !member.is_supported)
+    {
+        zip_archive_set_error(out_error, out_error_size, "Unable to open nested zip archive.");
+    }
+    else if (member.uncomp_size > ZIP_ARCHIVE_MAX_NESTED_BYTES)
+    {
+        zip_archive_set_error(out_error, out_error_size, "Selected zip inside archive is too large.");
+    }
+    else
+    {
+        size = (size_t)member.uncomp_size;
+        data = malloc(size > 0 ? size : 1);
+        if (!data)
+            zip_archive_set_error(out_error, out_error_size, "Out of memory while opening nested zip.");
+        else if (!zip_reader_extract(&parent, &member, data, size))
+        {
+            free(data);
+            data = NULL;
+            zip_archive_set_error(out_error, out_error_size, "Failed to extract selected zip from archive.");
+        }
+    }
+    zip_reader_close(&parent);
+
+    if (!data)
+        return NULL;
+
+    ZipNestedBuffer *buf = zip_nested_insert(archive_path, source, data, size);
+    if (!buf)
+        zip_archive_set_error(out_error, out_error_size, "Out of memory while opening nested zip.");
+    return buf;
+}
+
+// Open a real or nested archive for reading; pair with zip_reader_close
+static bool zip_reader_open(const char *archive_path, ZipReader *reader, char *out_error, size_t out_error_size)
+{
+    memset(reader, 0, sizeof(*reader));
+
+    char parent_path[PATH_MAX] = {0};
+    const char *member_path = NULL;
+    if (zip_archive_split_nested(archive_path, parent_path, sizeof(parent_path), &member_path))
+    {
+        ZipArchiveSource source;
+        if (!zip_archive_identify_source(archive_path, &source))
+        {
+            zip_archive_set_error(out_error, out_error_size, "Unable to open that zip archive.");
+            return false;
+        }
+
+        reader->nested = zip_archive_load_nested(archive_path,
+                                                 &source,
+                                                 parent_path,
+                                                 member_path,
+                                                 out_error,
+                                                 out_error_size);
+        if (!reader->nested)
+            return false;
+
+        reader->data = reader->nested->data;
+        reader->size = reader->nested->size;
+    }
+    else
+    {
+        if (!Bzzt_File_Map_Open(archive_path, &reader->map))
+        {
+            zip_archive_set_error(out_error, out_error_size, "Unable to open that zip archive.");
+            return false;
+        }
+
+        reader->data = reader->map.data;
+        reader->size = reader->map.size;
+    }
+
+    if (!zip_reader_locate_directory(reader))
+    {
+        zip_reader_close(reader);
         zip_archive_set_error(out_error, out_error_size, "Unable to read that zip archive.");
         return false;
     }
 
-    ZipArchiveEntry *entries = NULL;
-    int count = 0;
-    int cap = 0;
-    bool found_supported_entry = false;
+    return true;
+}
+
+static void zip_reader_close(ZipReader *reader)
+{
+    Bzzt_File_Map_Close(&reader->map);
+    zip_nested_release(reader->nested);
+    memset(reader, 0, sizeof(*reader));
+}
 
-    mz_uint file_count = mz_zip_reader_get_num_files(&archive);
-    if (file_count > ZIP_ARCHIVE_MAX_ENTRIES)
+static void zip_index_free(ZipIndex *index)
+{
+    if (!index)
+        return;
+
+    for (int i = 0; i < index->member_count; ++i)
+        free(index->members[i].path);
+    for (int i = 0; i < index->dir_count; ++i)
     {
-        mz_zip_reader_end(&archive);
-        zip_archive_set_error(out_error,
-                              out_error_size,
-                              "Zip archive has too many entries to inspect safely.");
+        for (int e = 0; e < index->dirs[i].count; ++e)
+            free(index->dirs[i].entries[e].path);
+        free(index->dirs[i].entries);
+        free(index->dirs[i].path);
+    }
+    free(index->members);
+    free(index->member_slots);
+    free(index->dirs);
+    free(index->dir_slots);
+    free(index->key);
+    free(index);
+}
+
+static uint64_t zip_index_hash(const char *text, size_t len)
+{
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < len; ++i)
+        h = (h ^ (uint8_t)text[i]) * 1099511628211ull;
+    return h;
+}
+
+// Power of two with room for n at no more than half load
+static size_t zip_index_slot_count(size_t n)
+{
+    size_t slots = 16;
+    while (slots < n * 2)
+        slots *= 2;
+    return slots;
+}
+
+static bool zip_index_path_equals(const char *stored, const char *path, size_t len)
+{
+    return strncmp(stored, path, len) == 0 && stored[len] == '\0';
+}
+
+static int zip_index_lookup_dir(const ZipIndex *index, const char *path, size_t len)
+{
+    size_t mask = index->dir_slot_count - 1;
+    for (size_t slot = (size_t)zip_index_hash(path, len) & mask; index->dir_slots[slot]; slot = (slot + 1) & mask)
+    {
+        int dir = index->dir_slots[slot] - 1;
+        if (zip_index_path_equals(index->dirs[dir].path, path, len))
+            return dir;
+    }
+    return -1;
+}
+
+static void zip_index_place_dir(ZipIndex *index, int dir)
+{
+    const char *path = index->dirs[dir].path;
+    size_t mask = index->dir_slot_count - 1;
+    size_t slot = (size_t)zip_index_hash(path, strlen(path)) & mask;
+    while (index->dir_slots[slot])
+        slot = (slot + 1) & mask;
+    index->dir_slots[slot] = dir + 1;
+}
+
+static bool zip_index_append(ZipIndexDir *dir, const char *path, size_t path_len, size_t parent_len, ZipArchiveEntryType type)
+{
+    if (dir->count >= dir->cap)
+    {
+        int new_cap = dir->cap == 0 ? 8 : dir->cap * 2;
+        ZipArchiveEntry *grown = realloc(dir->entries, sizeof(ZipArchiveEntry) * (size_t)new_cap);
+        if (!grown)
+            return false;
+        dir->entries = grown;
+        dir->cap = new_cap;
+    }
+
+    ZipArchiveEntry *entry = &dir->entries[dir->count];
+    entry->path = zip_archive_strndup(path, path_len);
+    if (!entry->path)
         return false;
+    entry->name = entry->path + (parent_len > 0 ? parent_len + 1 : 0);
+    entry->type = type;
+    dir->count++;
+    return true;
+}
+
+// Find or create the folder named by the first len bytes of path, listing it in its parent. Returns -1 when out of memory.
+static int zip_index_ensure_dir(ZipIndex *index, const char *path, size_t len)
+{
+    int found = zip_index_lookup_dir(index, path, len);
+    if (found >= 0)
+        return found;
+
+    size_t parent_len = len;
+    while (parent_len > 0 && path[parent_len - 1] != '/')
+        parent_len--;
+    if (parent_len > 0)
+        parent_len--;
+    int parent = zip_index_ensure_dir(index, path, parent_len);
+    if (parent < 0)
+        return -1;
+
+    if (index->dir_count >= index->dir_cap)
+    {
+        int new_cap = index->dir_cap * 2;
+        ZipIndexDir *grown = realloc(index->dirs, sizeof(ZipIndexDir) * (size_t)new_cap);
+        if (!grown)
+            return -1;
+        index->dirs = grown;
+        index->dir_cap = new_cap;
     }
 
-    for (mz_uint i = 0; i < file_count; ++i)
+    if ((size_t)(index->dir_count + 1) * 2 > index->dir_slot_count)
     {
-        mz_zip_archive_file_stat st;
-        if (!mz_zip_reader_file_stat(&archive, i, &st))
-            continue;
+        size_t slot_count = index->dir_slot_count * 2;
+        int *slots = calloc(slot_count, sizeof(int));
+        if (!slots)
+            return -1;
+        free(index->dir_slots);
+        index->dir_slots = slots;
+        index->dir_slot_count = slot_count;
+        for (int i = 0; i < index->dir_count; ++i)
+            zip_index_place_dir(index, i);
+    }
+
+    int dir = index->dir_count;
+    ZipIndexDir *created = &index->dirs[dir];
+    memset(created, 0, sizeof(*created));
+    created->path = zip_archive_strndup(path, len);
+    if (!created->path || !zip_index_append(&index->dirs[parent], path, len, parent_len, ZIP_ARCHIVE_ENTRY_DIRECTORY))
+    {
+        free(created->path);
+        return -1;
+    }
+    index->dir_count++;
+    zip_index_place_dir(index, dir);
+    return dir;
+}
 
-        if (st.m_is_directory || st.m_is_encrypted || !st.m_is_supported)
+// Returns false when out of memory. A repeated name keeps the first record, as a linear scan would find.
+static bool zip_index_add_member(ZipIndex *index, const char *path, uint64_t record)
+{
+    size_t mask = index->member_slot_count - 1;
+    size_t slot = (size_t)zip_index_hash(path, strlen(path)) & mask;
+    for (; index->member_slots[slot]; slot = (slot + 1) & mask)
+    {
+        if (strcmp(index->members[index->member_slots[slot] - 1].path, path) == 0)
+            return true;
+    }
+
+    ZipIndexMember *member = &index->members[index->member_count];
+    member->path = strdup(path);
+    if (!member->path)
+        return false;
+    member->record = record;
+    index->member_slots[slot] = ++index->member_count;
+    return true;
+}
+
+static int zip_index_compare_listed(const void *lhs, const void *rhs)
+{
+    int cmp = zip_archive_compare_entries(lhs, rhs);
+    if (cmp != 0)
+        return cmp;
+    return strcmp(((const ZipArchiveEntry *)lhs)->path, ((const ZipArchiveEntry *)rhs)->path);
+}
+
+static ZipIndex *zip_index_build(const ZipReader *reader, char *out_error, size_t out_error_size)
+{
+    // The walk touches the whole central directory and the local headers, so make sure they're all still there
+    if (!Bzzt_File_Map_Covers(&reader->map, reader->size))
+    {
+        zip_archive_set_error(out_error, out_error_size, "That zip archive changed on disk.");
+        return NULL;
+    }
+
+    ZipIndex *index = calloc(1, sizeof(ZipIndex));
+    if (!index || reader->entry_count > INT_MAX / 2)
+    {
+        free(index);
+        zip_archive_set_error(out_error, out_error_size, "Out of memory while reading zip archive.");
+        return NULL;
+    }
+
+    index->member_slot_count = zip_index_slot_count((size_t)reader->entry_count);
+    index->member_slots = calloc(index->member_slot_count, sizeof(int));
+    index->members = calloc(reader->entry_count > 0 ? (size_t)reader->entry_count : 1, sizeof(ZipIndexMember));
+    index->dir_cap = 16;
+    index->dirs = calloc((size_t)index->dir_cap, sizeof(ZipIndexDir));
+    index->dir_slot_count = zip_index_slot_count((size_t)index->dir_cap);
+    index->dir_slots = calloc(index->dir_slot_count, sizeof(int));
+    bool ok = index->member_slots && index->members && index->dirs && index->dir_slots;
+    if (ok)
+    {
+        index->dirs[0].path = strdup("");
+        ok = index->dirs[0].path != NULL;
+    }
+    if (ok)
+    {
+        index->dir_count = 1;
+        zip_index_place_dir(index, 0);
+    }
+
+    bool corrupt = false;
+    uint64_t record = reader->dir_offset;
+    for (uint64_t i = 0; ok && i < reader->entry_count; ++i)
+    {
+        ZipMember member;
+        if (!zip_reader_member(reader, record, &member))
+        {
+            corrupt = true;
+            break;
+        }
+        uint64_t this_record = record;
+        record = member.next_record;
+
+        if (member.is_directory || !member.is_supported)
             continue;
 
+        char raw_path[ZIP_ARCHIVE_MAX_MEMBER_PATH] = {0};
         char member_path[ZIP_ARCHIVE_MAX_MEMBER_PATH] = {0};
-        if (!zip_archive_normalize_path(st.m_filename, member_path, sizeof(member_path)))
+        if (member.name_len >= sizeof(raw_path))
+            continue;
+        memcpy(raw_path, member.name, member.name_len);
+        if (!zip_archive_normalize_path(raw_path, member_path, sizeof(member_path)))
             continue;
 
+        ok = zip_index_add_member(index, member_path, this_record);
+        if (!ok)
+            break;
+
         int type = zip_archive_member_type(member_path);
-        if ((int)type < 0)
+        if (type < 0)
             continue;
 
         if ((type == ZIP_ARCHIVE_ENTRY_ZZT || type == ZIP_ARCHIVE_ENTRY_BZZT) &&
-            st.m_uncomp_size > ZIP_ARCHIVE_MAX_WORLD_BYTES)
+            member.uncomp_size > ZIP_ARCHIVE_MAX_WORLD_BYTES)
             continue;
 
-        if (type == ZIP_ARCHIVE_ENTRY_ZIP && st.m_uncomp_size > ZIP_ARCHIVE_MAX_BYTES)
+        if (type == ZIP_ARCHIVE_ENTRY_ZIP && member.uncomp_size > ZIP_ARCHIVE_MAX_NESTED_BYTES)
             continue;
 
-        found_supported_entry = true;
+        index->has_supported_entry = true;
+
+        const char *slash = strrchr(member_path, '/');
+        size_t parent_len = slash ? (size_t)(slash - member_path) : 0;
+        int dir = zip_index_ensure_dir(index, member_path, parent_len);
+        ok = dir >= 0 &&
+             zip_index_append(&index->dirs[dir], member_path, strlen(member_path), parent_len, (ZipArchiveEntryType)type);
+    }
+
+    if (corrupt || !ok)
+    {
+        zip_index_free(index);
+        zip_archive_set_error(out_error,
+                              out_error_size,
+                              corrupt ? "Unable to read that zip archive." : "Out of memory while reading zip archive.");
+        return NULL;
+    }
+
+    for (int i = 0; i < index->dir_count; ++i)
+    {
+        ZipIndexDir *dir = &index->dirs[i];
+        if (dir->count > 1)
+            qsort(dir->entries, (size_t)dir->count, sizeof(ZipArchiveEntry), zip_index_compare_listed);
+    }
+    return index;
+}
 
-        char remainder[ZIP_ARCHIVE_MAX_MEMBER_PATH] = {0};
-        if (!zip_archive_entry_matches_dir(member_path,
-                                           normalized_dir,
-                                           remainder,
-                                           sizeof(remainder)))
+static ZipIndex *zip_index_acquire_cached(const char *key, const ZipArchiveSource *source)
+{
+    pthread_mutex_lock(&index_lock);
+    ZipIndex *found = NULL;
+    for (ZipIndex *it = indexes; it; it = it->next)
+    {
+        if (strcmp(it->key, key) == 0 && zip_archive_same_source(&it->source, source))
         {
+            found = it;
+            found->refs++;
+            found->last_used = ++index_clock;
+            Bzzt_Mem_Cache_Touch(found);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&index_lock);
+    return found;
+}
+
+// Bytes an index holds, for the memory budget
+static size_t zip_index_bytes(const ZipIndex *index)
+{
+    size_t bytes = sizeof(ZipIndex) + strlen(index->key) + 1;
+    bytes += (size_t)index->member_count * sizeof(ZipIndexMember) + index->member_slot_count * sizeof(int);
+    bytes += (size_t)index->dir_cap * sizeof(ZipIndexDir) + index->dir_slot_count * sizeof(int);
+    for (int i = 0; i < index->member_count; ++i)
+        bytes += strlen(index->members[i].path) + 1;
+    for (int i = 0; i < index->dir_count; ++i)
+    {
+        bytes += strlen(index->dirs[i].path) + 1 + (size_t)index->dirs[i].cap * sizeof(ZipArchiveEntry);
+        for (int e = 0; e < index->dirs[i].count; ++e)
+            bytes += strlen(index->dirs[i].entries[e].path) + 1;
+    }
+    return bytes;
+}
+
+// Free indexes taken out of the cache. Called without index_lock, which the budget's evict callback takes.
+static void zip_index_free_unlinked(ZipIndex *unlinked)
+{
+    while (unlinked)
+    {
+        ZipIndex *index = unlinked;
+        unlinked = index->next;
+        Bzzt_Mem_Cache_Remove(index);
+        zip_index_free(index);
+    }
+}
+
+// Memory budget evict callback; indexes in use stay
+static bool zip_index_evict(void *ctx, void *item)
+{
+    (void)ctx;
+    pthread_mutex_lock(&index_lock);
+    for (ZipIndex **it = &indexes; *it; it = &(*it)->next)
+    {
+        ZipIndex *index = *it;
+        if (index != item)
             continue;
+        if (index->refs > 0)
+        {
+            pthread_mutex_unlock(&index_lock);
+            return false;
         }
+        *it = index->next;
+        index_count--;
+        pthread_mutex_unlock(&index_lock);
+        zip_index_free(index);
+        return true;
+    }
+    pthread_mutex_unlock(&index_lock);
+    return true;
+}
 
-        char *slash = strchr(remainder, '/');
-        if (slash)
+// Caller holds index_lock. Unlinks unused indexes, oldest first, until there
+// is room for one more, and adds them to *unlinked for zip_index_free_unlinked.
+static void zip_index_evict_locked(ZipIndex **unlinked)
+{
+    while (index_count >= ZIP_ARCHIVE_INDEX_CACHE_COUNT)
+    {
+        ZipIndex **victim = NULL;
+        for (ZipIndex **it = &indexes; *it; it = &(*it)->next)
         {
-            size_t name_len = (size_t)(slash - remainder);
-            if (name_len == 0 || name_len >= ZIP_ARCHIVE_MAX_MEMBER_PATH)
-                continue;
+            if ((*it)->refs == 0 && (!victim || (*it)->last_used < (*victim)->last_used))
+                victim = it;
+        }
+        if (!victim)
+            return;
+
+        ZipIndex *index = *victim;
+        *victim = index->next;
+        index_count--;
+        index->next = *unlinked;
+        *unlinked = index;
+    }
+}
 
-            char dir_name[ZIP_ARCHIVE_MAX_MEMBER_PATH] = {0};
-            char dir_path[ZIP_ARCHIVE_MAX_MEMBER_PATH] = {0};
-            memcpy(dir_name, remainder, name_len);
-            dir_name[name_len] = '\0';
+static void zip_index_release(ZipIndex *index)
+{
+    if (!index)
+        return;
 
-            if (normalized_dir[0] == '\0')
-                snprintf(dir_path, sizeof(dir_path), "%s", dir_name);
-            else
-                snprintf(dir_path, sizeof(dir_path), "%s/%s", normalized_dir, dir_name);
+    pthread_mutex_lock(&index_lock);
+    bool unused = --index->refs == 0;
+    pthread_mutex_unlock(&index_lock);
 
-            if (zip_archive_has_entry(entries, count, dir_path, ZIP_ARCHIVE_ENTRY_DIRECTORY))
-                continue;
+    if (unused)
+        Bzzt_Mem_Cache_Trim();
+}
 
-            if (!zip_archive_add_entry(&entries, &count, &cap, dir_name, dir_path, ZIP_ARCHIVE_ENTRY_DIRECTORY))
-            {
-                mz_zip_reader_end(&archive);
-                ZipArchive_FreeEntries(entries, count);
-                zip_archive_set_error(out_error, out_error_size, "Out of memory while reading zip archive.");
-                return false;
-            }
-            continue;
+/*
+ * Returns the index for archive_path, acquired, building it on a miss.
+ * open_reader may be an already open reader for the same path; otherwise
+ * one is opened just for the build.
+ */
+static ZipIndex *zip_index_acquire(const char *archive_path,
+                                   ZipReader *open_reader,
+                                   char *out_error,
+                                   size_t out_error_size)
+{
+    ZipArchiveSource source;
+    if (!zip_archive_identify_source(archive_path, &source))
+    {
+        zip_archive_set_error(out_error, out_error_size, "Unable to open that zip archive.");
+        return NULL;
+    }
+
+    ZipIndex *index = zip_index_acquire_cached(archive_path, &source);
+    if (index)
+        return index;
+
+    ZipReader own_reader;
+    ZipReader *reader = open_reader;
+    if (!reader)
+    {
+        if (!zip_reader_open(archive_path, &own_reader, out_error, out_error_size))
+            return NULL;
+        reader = &own_reader;
+    }
+
+    index = zip_index_build(reader, out_error, out_error_size);
+    if (reader == &own_reader)
+        zip_reader_close(&own_reader);
+    if (!index)
+        return NULL;
+
+    index->key = strdup(archive_path);
+    if (!index->key)
+    {
+        zip_index_free(index);
+        zip_archive_set_error(out_error, out_error_size, "Out of memory while reading zip archive.");
+        return NULL;
+    }
+    index->source = source;
+    index->refs = 1;
+    size_t bytes = zip_index_bytes(index);
+
+    ZipIndex *unlinked = NULL;
+    pthread_mutex_lock(&index_lock);
+    // Replace any index built for an older copy of the same archive
+    for (ZipIndex **it = &indexes; *it; it = &(*it)->next)
+    {
+        if (strcmp((*it)->key, archive_path) == 0 && (*it)->refs == 0)
+        {
+            ZipIndex *stale = *it;
+            *it = stale->next;
+            index_count--;
+            stale->next = unlinked;
+            unlinked = stale;
+            break;
         }
+    }
+    zip_index_evict_locked(&unlinked);
+    index->last_used = ++index_clock;
+    index->next = indexes;
+    indexes = index;
+    index_count++;
+    Bzzt_Mem_Cache_Insert(BZZT_MEM_CACHE_ZIP_INDEXES, index, bytes, zip_index_evict, NULL);
+    pthread_mutex_unlock(&index_lock);
+
+    zip_index_free_unlinked(unlinked);
+    Bzzt_Mem_Cache_Trim();
+    return index;
+}
 
-        if (!zip_archive_add_entry(&entries,
-                                   &count,
-                                   &cap,
-                                   remainder,
-                                   member_path,
-                                   (ZipArchiveEntryType)type))
+static bool zip_index_find_member(const ZipIndex *index, const char *normalized_member, uint64_t *out_record)
+{
+    size_t mask = index->member_slot_count - 1;
+    size_t slot = (size_t)zip_index_hash(normalized_member, strlen(normalized_member)) & mask;
+    for (; index->member_slots[slot]; slot = (slot + 1) & mask)
+    {
+        const ZipIndexMember *member = &index->members[index->member_slots[slot] - 1];
+        if (strcmp(member->path, normalized_member) == 0)
         {
-            mz_zip_reader_end(&archive);
-            ZipArchive_FreeEntries(entries, count);
-            zip_archive_set_error(out_error, out_error_size, "Out of memory while reading zip archive.");
-            return false;
+            *out_record = member->record;
+            return true;
         }
     }
+    return false;
+}
+
+static const ZipIndexDir *zip_index_find_dir(const ZipIndex *index, const char *normalized_dir)
+{
+    int dir = zip_index_lookup_dir(index, normalized_dir, strlen(normalized_dir));
+    return dir >= 0 ? &index->dirs[dir] : NULL;
+}
+
+bool ZipArchive_List(const char *archive_path,
+                     const char *current_dir,
+                     ZipArchiveEntry **out_entries,
+                     int *out_count,
+                     char *out_error,
+                     size_t out_error_size)
+{
+    if (!archive_path || !current_dir || !out_entries || !out_count)
+        return false;
+
+    *out_entries = NULL;
+    *out_count = 0;
+
+    char normalized_dir[ZIP_ARCHIVE_MAX_MEMBER_PATH] = {0};
+    if (!zip_archive_normalize_path(current_dir, normalized_dir, sizeof(normalized_dir)))
+    {
+        zip_archive_set_error(out_error, out_error_size, "Zip path is too long.");
+        return false;
+    }
 
-    mz_zip_reader_end(&archive);
+    ZipIndex *index = zip_index_acquire(archive_path, NULL, out_error, out_error_size);
+    if (!index)
+        return false;
 
-    if (!found_supported_entry)
+    if (!index->has_supported_entry)
     {
-        ZipArchive_FreeEntries(entries, count);
+        zip_index_release(index);
         zip_archive_set_error(out_error, out_error_size, "Zip contains no .zzt, .bzzt, or .zip files.");
         return false;
     }
 
-    if (count > 1)
+    // Listings are stored sorted; the caller gets its own copy
+    ZipArchiveEntry *entries = NULL;
+    int count = 0;
+    int cap = 0;
+    const ZipIndexDir *dir = zip_index_find_dir(index, normalized_dir);
+    for (int i = 0; dir && i < dir->count; ++i)
     {
-        qsort(entries, (size_t)count, sizeof(ZipArchiveEntry), zip_archive_compare_entries);
+        if (!zip_archive_add_entry(&entries,
+                                   &count,
+                                   &cap,
+                                   dir->entries[i].name,
+                                   dir->entries[i].path,
+                                   dir->entries[i].type))
+        {
+            zip_index_release(index);
+            ZipArchive_FreeEntries(entries, count);
+            zip_archive_set_error(out_error, out_error_size, "Out of memory while reading zip archive.");
+            return false;
+        }
     }
+    zip_index_release(index);
 
     *out_entries = entries;
     *out_count = count;
@@ -404,19 +1356,18 @@ void ZipArchive_FreeEntries(ZipArchiveEntry *entries, int count)
     free(entries);
 }
 
-bool ZipArchive_Extract_World_To_Stream(const char *archive_path,
+bool ZipArchive_Extract_World_To_Memory(const char *archive_path,
                                         const char *member_path,
-                                        FILE **out_stream,
+                                        uint8_t **out_data,
+                                        size_t *out_size,
                                         char *out_error,
                                         size_t out_error_size)
 {
-    if (!archive_path || !member_path || !out_stream)
+    if (!archive_path || !member_path || !out_data || !out_size)
         return false;
 
-    *out_stream = NULL;
-
-    if (!zip_archive_check_file_size(archive_path, out_error, out_error_size))
-        return false;
+    *out_data = NULL;
+    *out_size = 0;
 
     char normalized_member[ZIP_ARCHIVE_MAX_MEMBER_PATH] = {0};
     if (!zip_archive_normalize_path(member_path, normalized_member, sizeof(normalized_member)))
@@ -425,99 +1376,65 @@ bool ZipArchive_Extract_World_To_Stream(const char *archive_path,
         return false;
     }
 
-    mz_zip_archive archive;
-    MZ_CLEAR_OBJ(archive);
-    if (!mz_zip_reader_init_file(&archive, archive_path, 0))
-    {
-        zip_archive_set_error(out_error, out_error_size, "Unable to read that zip archive.");
+    ZipReader reader;
+    if (!zip_reader_open(archive_path, &reader, out_error, out_error_size))
         return false;
-    }
 
-    FILE *stream = NULL;
     bool extracted = false;
-    mz_uint file_count = mz_zip_reader_get_num_files(&archive);
-    if (file_count > ZIP_ARCHIVE_MAX_ENTRIES)
+    ZipMember member;
+    int type = zip_archive_world_type(normalized_member);
+    if (!zip_reader_find_member(&reader, archive_path, normalized_member, &member, out_error, out_error_size) ||
+        type < 0 || member.is_directory || !member.is_supported)
+    {
+        // Fall through to the generic message below
+    }
+    else if (member.uncomp_size > ZIP_ARCHIVE_MAX_WORLD_BYTES)
     {
-        mz_zip_reader_end(&archive);
         zip_archive_set_error(out_error,
                               out_error_size,
-                              "Zip archive has too many entries to inspect safely.");
-        return false;
+                              "Selected world inside zip is too large.");
     }
-
-    for (mz_uint i = 0; i < file_count; ++i)
+    else
     {
-        mz_zip_archive_file_stat st;
-        if (!mz_zip_reader_file_stat(&archive, i, &st))
-            continue;
-
-        char candidate_path[ZIP_ARCHIVE_MAX_MEMBER_PATH] = {0};
-        if (!zip_archive_normalize_path(st.m_filename, candidate_path, sizeof(candidate_path)))
-            continue;
-
-        if (strcmp(candidate_path, normalized_member) != 0)
-            continue;
-
-        int type = zip_archive_world_type(candidate_path);
-        if ((int)type < 0 || st.m_is_directory || st.m_is_encrypted || !st.m_is_supported)
-            break;
-
-        if (st.m_uncomp_size > ZIP_ARCHIVE_MAX_WORLD_BYTES)
+        // The size is capped above, so the whole member fits in one small buffer
+        size_t size = (size_t)member.uncomp_size;
+        uint8_t *data = malloc(size > 0 ? size : 1);
+        if (!data)
         {
-            zip_archive_set_error(out_error,
-                                  out_error_size,
-                                  "Selected world inside zip is too large.");
-            break;
+            zip_archive_set_error(out_error, out_error_size, "Out of memory while extracting world from zip.");
         }
-
-        stream = tmpfile();
-        if (!stream)
+        else if (!zip_reader_extract(&reader, &member, data, size))
         {
-            zip_archive_set_error(out_error, out_error_size, "Unable to create a temporary world file.");
-            break;
+            free(data);
+            zip_archive_set_error(out_error, out_error_size, "Failed to extract selected world from zip.");
         }
-
-        if (!mz_zip_reader_extract_to_cfile(&archive, i, stream, 0))
+        else
         {
-            zip_archive_set_error(out_error, out_error_size, "Failed to extract selected world from zip.");
-            fclose(stream);
-            stream = NULL;
-            break;
+            *out_data = data;
+            *out_size = size;
+            extracted = true;
         }
-
-        rewind(stream);
-        *out_stream = stream;
-        extracted = true;
-        break;
     }
 
-    mz_zip_reader_end(&archive);
+    zip_reader_close(&reader);
 
-    if (!extracted)
-    {
-        if (stream)
-            fclose(stream);
-        if (out_error && out_error[0] == '\0')
-            zip_archive_set_error(out_error, out_error_size, "Unable to extract selected world from zip.");
-    }
+    if (!extracted && out_error && out_error[0] == '\0')
+        zip_archive_set_error(out_error, out_error_size, "Unable to extract selected world from zip.");
 
     return extracted;
 }
 
-bool ZipArchive_Extract_Member_To_Temp_File(const char *archive_path,
-                                            const char *member_path,
-                                            char *out_temp_path,
-                                            size_t out_temp_path_size,
-                                            char *out_error,
-                                            size_t out_error_size)
+bool ZipArchive_Open_Nested(const char *archive_path,
+                            const char *member_path,
+                            char *out_nested_path,
+                            size_t out_nested_path_size,
+                            char *out_error,
+                            size_t out_error_size)
 {
-    if (!archive_path || !member_path || !out_temp_path || out_temp_path_size == 0)
+    if (!archive_path || !member_path || !out_nested_path || out_nested_path_size == 0)
         return false;
 
-    out_temp_path[0] = '\0';
-
-    if (!zip_archive_check_file_size(archive_path, out_error, out_error_size))
-        return false;
+    out_nested_path[0] = '\0';
 
     char normalized_member[ZIP_ARCHIVE_MAX_MEMBER_PATH] = {0};
     if (!zip_archive_normalize_path(member_path, normalized_member, sizeof(normalized_member)))
@@ -526,91 +1443,72 @@ bool ZipArchive_Extract_Member_To_Temp_File(const char *archive_path,
         return false;
     }
 
-    mz_zip_archive archive;
-    MZ_CLEAR_OBJ(archive);
-    if (!mz_zip_reader_init_file(&archive, archive_path, 0))
+    if (snprintf(out_nested_path,
+                 out_nested_path_size,
+                 "%s" ZIP_ARCHIVE_NESTED_SEPARATOR "%s",
+                 archive_path,
+                 normalized_member) >= (int)out_nested_path_size)
     {
-        zip_archive_set_error(out_error, out_error_size, "Unable to read that zip archive.");
+        out_nested_path[0] = '\0';
+        zip_archive_set_error(out_error, out_error_size, "Nested zip path is too long.");
         return false;
     }
 
-    bool extracted = false;
-    mz_uint file_count = mz_zip_reader_get_num_files(&archive);
-    if (file_count > ZIP_ARCHIVE_MAX_ENTRIES)
+    // Opening it once validates the member and leaves its bytes in the cache
+    ZipReader reader;
+    if (!zip_reader_open(out_nested_path, &reader, out_error, out_error_size))
     {
-        mz_zip_reader_end(&archive);
-        zip_archive_set_error(out_error,
-                              out_error_size,
-                              "Zip archive has too many entries to inspect safely.");
+        out_nested_path[0] = '\0';
         return false;
     }
+    zip_reader_close(&reader);
+    return true;
+}
 
-    for (mz_uint i = 0; i < file_count; ++i)
+void ZipArchive_Clear_Caches(void)
+{
+    ZipIndex *unused_indexes = NULL;
+    pthread_mutex_lock(&index_lock);
+    ZipIndex **index_it = &indexes;
+    while (*index_it)
     {
-        mz_zip_archive_file_stat st;
-        if (!mz_zip_reader_file_stat(&archive, i, &st))
-            continue;
-
-        char candidate_path[ZIP_ARCHIVE_MAX_MEMBER_PATH] = {0};
-        if (!zip_archive_normalize_path(st.m_filename, candidate_path, sizeof(candidate_path)))
-            continue;
-
-        if (strcmp(candidate_path, normalized_member) != 0)
-            continue;
-
-        int type = zip_archive_member_type(candidate_path);
-        if (type != ZIP_ARCHIVE_ENTRY_ZIP || st.m_is_directory || st.m_is_encrypted || !st.m_is_supported)
-            break;
-
-        if (st.m_uncomp_size > ZIP_ARCHIVE_MAX_BYTES)
-        {
-            zip_archive_set_error(out_error,
-                                  out_error_size,
-                                  "Selected zip inside archive is too large.");
-            break;
-        }
-
-        char temp_template[] = "/tmp/bzzt-zip-XXXXXX";
-        int fd = mkstemp(temp_template);
-        if (fd < 0)
-        {
-            zip_archive_set_error(out_error, out_error_size, "Unable to create a temporary zip file.");
-            break;
-        }
-
-        FILE *stream = fdopen(fd, "w+b");
-        if (!stream)
-        {
-            close(fd);
-            unlink(temp_template);
-            zip_archive_set_error(out_error, out_error_size, "Unable to create a temporary zip file.");
-            break;
-        }
-
-        if (!mz_zip_reader_extract_to_cfile(&archive, i, stream, 0))
+        ZipIndex *index = *index_it;
+        if (index->refs > 0)
         {
-            fclose(stream);
-            unlink(temp_template);
-            zip_archive_set_error(out_error, out_error_size, "Failed to extract selected zip from archive.");
-            break;
+            index_it = &index->next;
+            continue;
         }
+        *index_it = index->next;
+        index_count--;
+        index->next = unused_indexes;
+        unused_indexes = index;
+    }
+    pthread_mutex_unlock(&index_lock);
+    zip_index_free_unlinked(unused_indexes);
 
-        fclose(stream);
-        if (snprintf(out_temp_path, out_temp_path_size, "%s", temp_template) >= (int)out_temp_path_size)
+    ZipNestedBuffer *unused = NULL;
+    pthread_mutex_lock(&nested_lock);
+    ZipNestedBuffer **it = &nested_buffers;
+    while (*it)
+    {
+        ZipNestedBuffer *buf = *it;
+        if (buf->refs > 0)
         {
-            unlink(temp_template);
-            zip_archive_set_error(out_error, out_error_size, "Temporary zip path is too long.");
-            break;
+            it = &buf->next;
+            continue;
         }
-
-        extracted = true;
-        break;
+        *it = buf->next;
+        buf->next = unused;
+        unused = buf;
     }
+    pthread_mutex_unlock(&nested_lock);
 
-    mz_zip_reader_end(&archive);
-
-    if (!extracted && out_error && out_error[0] == '\0')
-        zip_archive_set_error(out_error, out_error_size, "Unable to extract selected zip from archive.");
-
-    return extracted;
+    // Outside nested_lock, which the budget's evict callback takes
+    while (unused)
+    {
+        ZipNestedBuffer *buf = unused;
+        unused = buf->next;
+        Bzzt_Mem_Cache_Remove(buf);
+        zip_nested_free(buf);
+    }
 }
@@ -2,7 +2,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
-#include <stdio.h>
+#include <stdint.h>
 
 typedef enum ZipArchiveEntryType
 {
@@ -27,14 +27,21 @@ bool ZipArchive_List(const char *archive_path,
                      size_t out_error_size);
 void ZipArchive_FreeEntries(ZipArchiveEntry *entries, int count);
 
-bool ZipArchive_Extract_World_To_Stream(const char *archive_path,
+// Inflate a world member onto the heap; the caller frees *out_data
+bool ZipArchive_Extract_World_To_Memory(const char *archive_path,
                                         const char *member_path,
-                                        FILE **out_stream,
+                                        uint8_t **out_data,
+                                        size_t *out_size,
                                         char *out_error,
                                         size_t out_error_size);
-bool ZipArchive_Extract_Member_To_Temp_File(const char *archive_path,
-                                            const char *member_path,
-                                            char *out_temp_path,
-                                            size_t out_temp_path_size,
-                                            char *out_error,
-                                            size_t out_error_size);
+// Check that member_path inside archive_path is a zip and write the path that
+// names it ("archive!/member"). That path works anywhere an archive path is
+// taken; its bytes live in a shared in-memory cache rather than on disk.
+bool ZipArchive_Open_Nested(const char *archive_path,
+                            const char *member_path,
+                            char *out_nested_path,
+                            size_t out_nested_path_size,
+                            char *out_error,
+                            size_t out_error_size);
+// Drop cached directory indexes and nested archives that are not in use
+void ZipArchive_Clear_Caches(void);
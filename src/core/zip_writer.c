@@ -0,0 +1,564 @@
+#include "zip_writer.h"
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include "bzzt.h"
+#include "debugger.h"
+#include "file_map.h"
+#include "miniz.h"
+#include "thread_pool.h"
+
+#define ZIP_SIG_LOCAL 0x04034b50u
+#define ZIP_SIG_CENTRAL 0x02014b50u
+#define ZIP_SIG_END 0x06054b50u
+#define ZIP_LOCAL_HEADER_SIZE 30
+#define ZIP_CENTRAL_HEADER_SIZE 46
+#define ZIP_END_SIZE 22
+#define ZIP_VERSION_NEEDED 20
+#define ZIP_METHOD_STORED 0
+#define ZIP_METHOD_DEFLATED 8
+#define ZIP_FLAG_UTF8 0x0800
+// Past these the archive would need ZIP64 records, which the writer doesn't produce
+#define ZIP_WRITER_MAX_MEMBERS 0xFFFF
+#define ZIP_WRITER_MAX_OFFSET 0xFFFFFFFFull
+#define ZIP_WRITER_MAX_NAME 0xFFFF
+
+typedef struct ZipWriterMember
+{
+    char *name;
+    char *file_path;  // Read on the pool when set
+    uint8_t *source;  // Otherwise the caller's bytes, copied; freed once compressed
+    size_t source_size;
+    time_t mtime;
+
+    // Filled in by the compress job
+    bool ok;
+    char error[128];
+    uint8_t *data;    // What goes in the archive, deflated or stored
+    size_t data_size;
+    bool data_from_miniz;
+    uint16_t method;
+    uint32_t crc32;
+    size_t size;
+
+    uint64_t local_offset; // Set while writing
+} ZipWriterMember;
+
+struct ZipWriter
+{
+    Bzzt_Thread_Pool *pool;
+    bool owns_pool;
+    Bzzt_Job_Group group;
+    int comp_flags; // 0 stores every member
+    ZipWriterMember **members;
+    int members_count, members_cap;
+    int *name_slots; // Open-addressed set of member names: member index + 1, 0 when empty
+    size_t name_slot_count;
+};
+
+static void zip_writer_set_error(char *out_error, size_t out_error_size, const char *fmt, ...)
+{
+    if (!out_error || out_error_size == 0)
+        return;
+
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(out_error, out_error_size, fmt, args);
+    va_end(args);
+}
+
+static char *zip_writer_strdup(const char *text)
+{
+    size_t len = strlen(text);
+    char *copy = malloc(len + 1);
+    if (copy)
+        memcpy(copy, text, len + 1);
+    return copy;
+}
+
+static void zip_writer_free_member(ZipWriterMember *m)
+{
+    if (!m)
+        return;
+
+    free(m->name);
+    free(m->file_path);
+    free(m->source);
+    if (m->data_from_miniz)
+        mz_free(m->data);
+    else
+        free(m->data);
+    free(m);
+}
+
+// Relative, '/' separated, with no empty, "." or ".." parts
+static bool zip_writer_valid_member_path(const char *path)
+{
+    size_t len = strlen(path);
+    if (len == 0 || len > ZIP_WRITER_MAX_NAME || path[0] == '/' || path[len - 1] == '/')
+        return false;
+
+    const char *part = path;
+    while (*part)
+    {
+        size_t part_len = strcspn(part, "/");
+        if (part_len == 0 || (part_len == 1 && part[0] == '.') ||
+            (part_len == 2 && part[0] == '.' && part[1] == '.') || memchr(part, '\\', part_len))
+            return false;
+        part += part_len;
+        if (*part == '/')
+            part++;
+    }
+    return true;
+}
+
+static bool zip_writer_is_ascii(const char *text)
+{
+    for (; *text; ++text)
+    {
+        if ((unsigned char)*text >= 0x80)
+            return false;
+    }
+    return true;
+}
+
+static void zip_writer_dos_time(time_t t, uint16_t *out_time, uint16_t *out_date)
+{
+    struct tm local;
+#if defined(_WIN32)
+    bool ok = localtime_s(&local, &t) == 0;
+#else
+    bool ok = localtime_r(&t, &local) != NULL;
+#endif
+    // DOS dates start in 1980
+    if (!ok || local.tm_year < 80)
+    {
+        *out_time = 0;
+        *out_date = (1 << 5) | 1;
+        return;
+    }
+
+    *out_time = (uint16_t)((local.tm_hour << 11) | (local.tm_min << 5) | (local.tm_sec / 2));
+    *out_date = (uint16_t)(((local.tm_year - 80) << 9) | ((local.tm_mon + 1) << 5) | local.tm_mday);
+}
+
+static void zip_writer_compress_with_flags(ZipWriterMember *m, const uint8_t *src, size_t size, int comp_flags)
+{
+    if (size >= ZIP_WRITER_MAX_OFFSET)
+    {
+        zip_writer_set_error(m->error, sizeof(m->error), "too large for a zip without ZIP64");
+        return;
+    }
+
+    m->size = size;
+    m->crc32 = (uint32_t)mz_crc32(MZ_CRC32_INIT, src, size);
+
+    if (comp_flags && size > 0)
+    {
+        size_t packed_size = 0;
+        void *packed = tdefl_compress_mem_to_heap(src, size, &packed_size, comp_flags);
+        // Keep the deflated copy only if it is actually smaller
+        if (packed && packed_size < size)
+        {
+            m->data = packed;
+            m->data_size = packed_size;
+            m->data_from_miniz = true;
+            m->method = ZIP_METHOD_DEFLATED;
+            m->ok = true;
+            return;
+        }
+        mz_free(packed);
+    }
+
+    if (src == m->source)
+    {
+        m->data = m->source;
+        m->source = NULL;
+    }
+    else
+    {
+        m->data = malloc(size ? size : 1);
+        if (!m->data)
+        {
+            zip_writer_set_error(m->error, sizeof(m->error), "out of memory");
+            return;
+        }
+        memcpy(m->data, src, size);
+    }
+    m->data_size = size;
+    m->method = ZIP_METHOD_STORED;
+    m->ok = true;
+}
+
+typedef struct ZipWriterJob
+{
+    ZipWriterMember *member;
+    int comp_flags;
+} ZipWriterJob;
+
+static void zip_writer_run_job(void *arg)
+{
+    ZipWriterJob *job = (ZipWriterJob *)arg;
+    ZipWriterMember *m = job->member;
+
+    if (m->file_path)
+    {
+        Bzzt_File_Map map;
+        if (!Bzzt_File_Map_Open(m->file_path, &map))
+        {
+            zip_writer_set_error(m->error, sizeof(m->error), "could not read %s", m->file_path);
+            free(job);
+            return;
+        }
+
+        struct stat st;
+        if (stat(m->file_path, &st) == 0)
+            m->mtime = st.st_mtime;
+        zip_writer_compress_with_flags(m, map.data, map.size, job->comp_flags);
+        Bzzt_File_Map_Close(&map);
+    }
+    else
+    {
+        zip_writer_compress_with_flags(m, m->source, m->source_size, job->comp_flags);
+        free(m->source);
+        m->source = NULL;
+    }
+
+    free(job);
+}
+
+ZipWriter *ZipWriter_Create(Bzzt_Thread_Pool *pool, int level)
+{
+    ZipWriter *w = calloc(1, sizeof(ZipWriter));
+    if (!w)
+        return NULL;
+
+    w->pool = pool;
+    if (!w->pool)
+    {
+        w->pool = Bzzt_Thread_Pool_Create(0);
+        w->owns_pool = w->pool != NULL;
+    }
+
+    if (level < 0)
+        level = ZIP_WRITER_DEFAULT_LEVEL;
+    if (level > 10)
+        level = 10;
+    // Negative window bits: raw deflate, as zip members are stored
+    w->comp_flags = level > 0 ? (int)tdefl_create_comp_flags_from_zip_params(level, -MZ_DEFAULT_WINDOW_BITS,
+                                                                              MZ_DEFAULT_STRATEGY)
+                              : 0;
+
+    Bzzt_Job_Group_Init(&w->group);
+    return w;
+}
+
+static uint64_t zip_writer_name_hash(const char *name)
+{
+    uint64_t h = 1469598103934665603ull;
+    for (; *name; ++name)
+        h = (h ^ (uint8_t)*name) * 1099511628211ull;
+    return h;
+}
+
+// The slot holding name, or the empty slot it would go in
+static size_t zip_writer_name_slot(const ZipWriter *w, const char *name)
+{
+    size_t mask = w->name_slot_count - 1;
+    size_t slot = (size_t)zip_writer_name_hash(name) & mask;
+    while (w->name_slots[slot] && strcmp(w->members[w->name_slots[slot] - 1]->name, name) != 0)
+        slot = (slot + 1) & mask;
+    return slot;
+}
+
+// Keep the name set at no more than half load, rehashing into a bigger one when needed
+static bool zip_writer_reserve_names(ZipWriter *w, size_t count)
+{
+    if (count * 2 <= w->name_slot_count)
+        return true;
+
+    size_t slot_count = w->name_slot_count ? w->name_slot_count : 64;
+    while (slot_count < count * 2)
+        slot_count *= 2;
+    int *slots = calloc(slot_count, sizeof(int));
+    if (!slots)
+        return false;
+
+    free(w->name_slots);
+    w->name_slots = slots;
+    w->name_slot_count = slot_count;
+    for (int i = 0; i < w->members_count; ++i)
+        w->name_slots[zip_writer_name_slot(w, w->members[i]->name)] = i + 1;
+    return true;
+}
+
+static bool zip_writer_add_member(ZipWriter *w, ZipWriterMember *m)
+{
+    if (!zip_writer_reserve_names(w, (size_t)w->members_count + 1))
+        return false;
+
+    size_t name_slot = zip_writer_name_slot(w, m->name);
+    if (w->name_slots[name_slot])
+    {
+        Debug_Log(LOG_LEVEL_WARN, LOG_ENGINE, "Zip member %s was added twice.", m->name);
+        return false;
+    }
+
+    if (w->members_count >= ZIP_WRITER_MAX_MEMBERS)
+    {
+        Debug_Log(LOG_LEVEL_WARN, LOG_ENGINE, "Zip archives are limited to %d members.", ZIP_WRITER_MAX_MEMBERS);
+        return false;
+    }
+
+    if (w->members_count == w->members_cap)
+    {
+        int new_cap = w->members_cap ? w->members_cap * 2 : 64;
+        ZipWriterMember **grown = realloc(w->members, sizeof(ZipWriterMember *) * new_cap);
+        if (!grown)
+            return false;
+        w->members = grown;
+        w->members_cap = new_cap;
+    }
+
+    ZipWriterJob *job = malloc(sizeof(ZipWriterJob));
+    if (!job)
+        return false;
+    job->member = m;
+    job->comp_flags = w->comp_flags;
+
+    w->members[w->members_count++] = m;
+    w->name_slots[name_slot] = w->members_count;
+    if (!w->pool || !Bzzt_Thread_Pool_Submit(w->pool, &w->group, zip_writer_run_job, job))
+        zip_writer_run_job(job);
+    return true;
+}
+
+bool ZipWriter_Add_Memory(ZipWriter *w, const char *member_path, const void *data, size_t size)
+{
+    if (!w || !member_path || (!data && size > 0) || !zip_writer_valid_member_path(member_path))
+        return false;
+
+    ZipWriterMember *m = calloc(1, sizeof(ZipWriterMember));
+    if (!m)
+        return false;
+
+    m->name = zip_writer_strdup(member_path);
+    m->source = malloc(size ? size : 1);
+    if (!m->name || !m->source)
+    {
+        zip_writer_free_member(m);
+        return false;
+    }
+    if (size > 0)
+        memcpy(m->source, data, size);
+    m->source_size = size;
+    m->mtime = time(NULL);
+
+    if (!zip_writer_add_member(w, m))
+    {
+        zip_writer_free_member(m);
+        return false;
+    }
+    return true;
+}
+
+bool ZipWriter_Add_File(ZipWriter *w, const char *member_path, const char *file_path)
+{
+    if (!w || !member_path || !file_path || !zip_writer_valid_member_path(member_path))
+        return false;
+
+    ZipWriterMember *m = calloc(1, sizeof(ZipWriterMember));
+    if (!m)
+        return false;
+
+    m->name = zip_writer_strdup(member_path);
+    m->file_path = zip_writer_strdup(file_path);
+    if (!m->name || !m->file_path || !zip_writer_add_member(w, m))
+    {
+        zip_writer_free_member(m);
+        return false;
+    }
+    return true;
+}
+
+static void zip_writer_put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void zip_writer_put32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+// The fields local and central headers share, from "version needed" through the name length
+static void zip_writer_put_common(uint8_t *p, const ZipWriterMember *m)
+{
+    uint16_t dos_time, dos_date;
+    zip_writer_dos_time(m->mtime, &dos_time, &dos_date);
+    zip_writer_put16(p + 0, ZIP_VERSION_NEEDED);
+    zip_writer_put16(p + 2, zip_writer_is_ascii(m->name) ? 0 : ZIP_FLAG_UTF8);
+    zip_writer_put16(p + 4, m->method);
+    zip_writer_put16(p + 6, dos_time);
+    zip_writer_put16(p + 8, dos_date);
+    zip_writer_put32(p + 10, m->crc32);
+    zip_writer_put32(p + 14, (uint32_t)m->data_size);
+    zip_writer_put32(p + 18, (uint32_t)m->size);
+    zip_writer_put16(p + 22, (uint16_t)strlen(m->name));
+}
+
+static bool zip_writer_write_archive(ZipWriter *w, FILE *fp, char *out_error, size_t out_error_size)
+{
+    uint64_t offset = 0;
+    for (int i = 0; i < w->members_count; ++i)
+    {
+        ZipWriterMember *m = w->members[i];
+        if (!m->ok)
+        {
+            zip_writer_set_error(out_error, out_error_size, "Could not add %s: %s", m->name, m->error);
+            return false;
+        }
+
+        size_t name_len = strlen(m->name);
+        if (offset + ZIP_LOCAL_HEADER_SIZE + name_len + m->data_size > ZIP_WRITER_MAX_OFFSET)
+        {
+            zip_writer_set_error(out_error, out_error_size, "Archive is too large for a zip without ZIP64.");
+            return false;
+        }
+
+        uint8_t header[ZIP_LOCAL_HEADER_SIZE] = {0};
+        zip_writer_put32(header, ZIP_SIG_LOCAL);
+        zip_writer_put_common(header + 4, m);
+        m->local_offset = offset;
+        if (fwrite(header, 1, sizeof(header), fp) != sizeof(header) || fwrite(m->name, 1, name_len, fp) != name_len ||
+            fwrite(m->data, 1, m->data_size, fp) != m->data_size)
+        {
+            zip_writer_set_error(out_error, out_error_size, "Write failed.");
+            return false;
+        }
+        offset += ZIP_LOCAL_HEADER_SIZE + name_len + m->data_size;
+
+        // Only the central directory is left to write for this member
+        if (m->data_from_miniz)
+            mz_free(m->data);
+        else
+            free(m->data);
+        m->data = NULL;
+        m->data_from_miniz = false;
+    }
+
+    uint64_t central_offset = offset;
+    for (int i = 0; i < w->members_count; ++i)
+    {
+        ZipWriterMember *m = w->members[i];
+        size_t name_len = strlen(m->name);
+        uint8_t header[ZIP_CENTRAL_HEADER_SIZE] = {0};
+        zip_writer_put32(header, ZIP_SIG_CENTRAL);
+        zip_writer_put16(header + 4, ZIP_VERSION_NEEDED); // Version made by: MS-DOS attributes
+        zip_writer_put_common(header + 6, m);
+        zip_writer_put32(header + 42, (uint32_t)m->local_offset);
+        if (fwrite(header, 1, sizeof(header), fp) != sizeof(header) || fwrite(m->name, 1, name_len, fp) != name_len)
+        {
+            zip_writer_set_error(out_error, out_error_size, "Write failed.");
+            return false;
+        }
+        offset += ZIP_CENTRAL_HEADER_SIZE + name_len;
+    }
+
+    if (offset > ZIP_WRITER_MAX_OFFSET)
+    {
+        zip_writer_set_error(out_error, out_error_size, "Archive is too large for a zip without ZIP64.");
+        return false;
+    }
+
+    uint8_t end[ZIP_END_SIZE] = {0};
+    zip_writer_put32(end, ZIP_SIG_END);
+    zip_writer_put16(end + 8, (uint16_t)w->members_count);
+    zip_writer_put16(end + 10, (uint16_t)w->members_count);
+    zip_writer_put32(end + 12, (uint32_t)(offset - central_offset));
+    zip_writer_put32(end + 16, (uint32_t)central_offset);
+    if (fwrite(end, 1, sizeof(end), fp) != sizeof(end))
+    {
+        zip_writer_set_error(out_error, out_error_size, "Write failed.");
+        return false;
+    }
+    return true;
+}
+
+bool ZipWriter_Finish(ZipWriter *w, const char *archive_path, char *out_error, size_t out_error_size)
+{
+    if (!w)
+        return false;
+
+    Bzzt_Job_Group_Wait(&w->group);
+
+    // Written next to the target and renamed into place once complete
+    char part_path[BZZT_MAX_PATH_LENGTH + 8];
+    int part_len = archive_path ? snprintf(part_path, sizeof(part_path), "%s.part", archive_path) : -1;
+    bool ok = part_len >= 0 && (size_t)part_len < sizeof(part_path);
+    if (!ok)
+        zip_writer_set_error(out_error, out_error_size, "Archive path is too long.");
+
+    FILE *fp = ok ? fopen(part_path, "wb") : NULL;
+    if (ok && !fp)
+    {
+        zip_writer_set_error(out_error, out_error_size, "Could not create %s.", part_path);
+        ok = false;
+    }
+
+    if (fp)
+    {
+        ok = zip_writer_write_archive(w, fp, out_error, out_error_size);
+        if (fclose(fp) != 0 && ok)
+        {
+            zip_writer_set_error(out_error, out_error_size, "Write failed.");
+            ok = false;
+        }
+
+        if (ok)
+        {
+#if defined(_WIN32)
+            remove(archive_path); // rename() won't replace an existing file here
+#endif
+            if (rename(part_path, archive_path) != 0)
+            {
+                zip_writer_set_error(out_error, out_error_size, "Could not move the archive to %s.", archive_path);
+                ok = false;
+            }
+        }
+        if (!ok)
+            remove(part_path);
+    }
+
+    if (ok)
+        Debug_Log(LOG_LEVEL_DEBUG, LOG_ENGINE, "Wrote %d members to %s.", w->members_count, archive_path);
+    ZipWriter_Abort(w);
+    return ok;
+}
+
+void ZipWriter_Abort(ZipWriter *w)
+{
+    if (!w)
+        return;
+
+    Bzzt_Job_Group_Wait(&w->group);
+    Bzzt_Job_Group_Destroy(&w->group);
+    if (w->owns_pool)
+        Bzzt_Thread_Pool_Destroy(w->pool);
+
+    for (int i = 0; i < w->members_count; ++i)
+        zip_writer_free_member(w->members[i]);
+    free(w->members);
+    free(w->name_slots);
+    free(w);
+}
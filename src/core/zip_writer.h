@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct Bzzt_Thread_Pool Bzzt_Thread_Pool;
+
+#define ZIP_WRITER_DEFAULT_LEVEL 6 // miniz deflate level, 0 (store) to 10
+
+/* Builds a zip archive. Members are deflated on a thread pool as they are
+ * added; ZipWriter_Finish waits for them and writes the archive in the order
+ * they were added, followed by its central directory. */
+typedef struct ZipWriter ZipWriter;
+
+// pool may be NULL, in which case the writer runs its own with one thread per CPU
+ZipWriter *ZipWriter_Create(Bzzt_Thread_Pool *pool, int level);
+// Add a copy of data as member_path ("dir/name", '/' separated)
+bool ZipWriter_Add_Memory(ZipWriter *w, const char *member_path, const void *data, size_t size);
+// Add the file at file_path as member_path; the file is read on the pool
+bool ZipWriter_Add_File(ZipWriter *w, const char *member_path, const char *file_path);
+// Write the archive to archive_path and free the writer. Nothing is left at
+// archive_path unless every member made it in.
+bool ZipWriter_Finish(ZipWriter *w, const char *archive_path, char *out_error, size_t out_error_size);
+// Free the writer without writing anything
+void ZipWriter_Abort(ZipWriter *w);
@@ -34,92 +34,6 @@ int zztParamCopyPtr(ZZTparam *dest, ZZTparam *src);
 
 /* Helper functions native to board.c */
 
-int _zzt_rle_decode(uint8_t *packed, ZZTblock *block)
-{
-	int ofs = 0, count = 0;
-	int maxcount = block->width * block->height;
-	int i;
-
-	/* NOTE: we assume that the decompressed rle string is not smaller than the
-	 * size of the block. A larger rle string will safely generate an error */
-
-	do {
-		int run_length = (packed[ofs] > 0) ? packed[ofs] : 256;
-		for(i = 0; i < run_length; i++) {
-			if (count >= maxcount)   /* Do not exceed the block size */
-				return 0;
-			block->tiles[count].type = packed[ofs+1];
-			block->tiles[count++].color = packed[ofs+2];
-		}
-		ofs += 3;
-	} while(count < maxcount);
-	return 1;
-}
-
-int _zzt_rle_encoded_size(ZZTblock *block)
-{
-	int size = 0, ofs = 0;
-	int maxcount = block->width * block->height;
-	uint8_t blocks;
-	uint8_t type;
-	uint8_t color;
-
-	/* Get size of RLE data */
-	do {
-		/* Start with one block */
-		blocks = 1;
-		type = block->tiles[ofs].type;
-		color = block->tiles[ofs++].color;
-
-		while(ofs < maxcount && type == block->tiles[ofs].type && color == block->tiles[ofs].color && blocks < 255) {
-			blocks++;
-			ofs++;
-		}
-		size++;
-	} while(ofs < maxcount);
-
-	return size;
-}
-
-uint8_t *_zzt_rle_encode(ZZTblock *block)
-{
-	int size = 0, ofs = 0, ofs2 = 0;
-	int maxcount = block->width * block->height;
-	uint8_t blocks = 1;
-	uint8_t type;
-	uint8_t color;
-
-	uint8_t *packed;
-
-	/* NOTE: the compressed string will only represent as many tiles as
-	 * are in the given block. If the block is not ZZT size, the encoded
-	 * string will not be ZZT size either. */
-
-	size = _zzt_rle_encoded_size(block);
-
-	/* Reallocate data */
-	packed = malloc(size*3);
-	/* RLE encode from unpacked */
-	ofs = ofs2 = 0;
-	do {
-		blocks = 1;
-		type = block->tiles[ofs].type;
-		color = block->tiles[ofs++].color;
-		if(ofs < maxcount) {
-			while(type == block->tiles[ofs].type && color == block->tiles[ofs].color && blocks < 255) {
-				blocks++;
-				ofs++;
-				if(ofs >= maxcount)
-					break;
-			}
-		}
-		packed[ofs2++] = blocks;
-		packed[ofs2++] = type;
-		packed[ofs2++] = color;
-	} while (ofs < maxcount);
-	return packed;
-}
-
 int _zzt_param_decode(ZZTparam* params, int paramcount, ZZTblock *block)
 {
 	int i;
@@ -189,24 +103,20 @@ void _zztBoardFree(ZZTboard board)
 	}
 	board.bigboard = NULL;
 	board.packed = NULL;
+	board.packedlen = 0;
 	board.params = NULL;
 }
 
 void zztBoardCopyPtr(ZZTboard *dest, ZZTboard *src)
 {
-	int tiles = 0, ofs = 0;
 	int i;
 
 	/* Base board junk */
 	memcpy(dest, src, sizeof(ZZTboard));
 	/* Packed board */
 	if (src->packed != NULL) {
-		do {
-			tiles += src->packed[ofs];
-			ofs += 3;
-		} while(tiles < ZZT_BOARD_MAX_SIZE);
-		dest->packed = malloc(ofs);
-		memcpy(dest->packed, src->packed, ofs);
+		dest->packed = malloc(src->packedlen);
+		memcpy(dest->packed, src->packed, src->packedlen);
 	}
 	/* Parameters */
 	if(dest->params != NULL) {
@@ -314,6 +224,7 @@ ZZTboard *zztBoardCreate(char *title)
 		board->packed[ofs++] = 0x0F;
 	}
 	board->packed[ofs-3] = remainder;
+	board->packedlen = ofs;
 	/* Make player param */
 	board->params = malloc(sizeof(ZZTparam));
 	memset(board->params, 0, sizeof(ZZTparam));
@@ -405,6 +316,7 @@ int zztBoardDecompress(ZZTboard *board)
 	free(board->params);
 
 	board->packed = NULL;
+	board->packedlen = 0;
 	board->params = NULL;
 
 	return 1;
@@ -423,6 +335,7 @@ int zztBoardCompress(ZZTboard *board)
 	board->packed = _zzt_rle_encode(board->bigboard);
 	if (board->packed == NULL)
 		return 0;
+	board->packedlen = (size_t)_zzt_rle_encoded_size(board->bigboard) * 3;
 	board->params = _zzt_param_encode(&paramcount, board->plx, board->ply,
 																		board->bigboard);
 	if (board->params == NULL)
@@ -31,15 +31,6 @@
 /* File macros */
 /* ----------- */
 /* ZZT files are on a 16-bit little-endian architecture */
-#define _zzt_outb(a, fp)	fwrite(a, 1, 1, fp)
-size_t _zzt_outw(uint16_t *a, FILE *fp)
-{
-	size_t result; uint8_t b = (*a & 0x00FF);
-	result = fwrite(&b, 1, 1, fp);
-	b = (*a & 0xFF00) >> 8;
-	result += fwrite(&b, 1, 1, fp);
-	return result;
-}
 #define _zzt_inb(a, fp)		fread(a, 1, 1, fp)
 size_t _zzt_inw(uint16_t *a, FILE *fp)
 {
@@ -50,23 +41,6 @@ size_t _zzt_inw(uint16_t *a, FILE *fp)
         *a += b << 8;
         return result;
 }
-size_t _zzt_outs(char *s, int len, FILE *fp)
-{
-	size_t result = 0;
-	if(len != 0)
-		result = fwrite(s, 1, len, fp);
-	return result;
-}
-size_t _zzt_outspad(char *s, int len, int total, FILE *fp)
-{
-	size_t result = 0; int i; uint8_t b = 0;
-	if(len > total)
-		return -1;
-	result += _zzt_outs(s, len, fp);
-	for(i = 0; i < total-len; i++)
-		result += _zzt_outb(&b, fp);
-	return result;
-}
 size_t _zzt_ins(char *s, int len, FILE *fp)
 {
 	size_t result = 0;
@@ -89,61 +63,142 @@ size_t _zzt_inspad(char *s, int len, int total, FILE *fp)
 
 #define _zzt_inb_or(a, fp)		if(_zzt_inb(a, fp) != 1)
 #define _zzt_inw_or(a, fp)		if(_zzt_inw(a, fp) != 2)
-#define _zzt_outb_ordie(a, fp)		if(_zzt_outb(a, fp) != 1) return 0
-#define _zzt_outw_ordie(a, fp)		if(_zzt_outw(a, fp) != 2) return 0
 #define _zzt_ins_or(s, len, fp)		if(_zzt_ins(s, len, fp) != len)
 #define _zzt_inspad_or(s, len, total, fp)	if(_zzt_inspad(s, len, total, fp) != total)
-#define _zzt_outs_ordie(s, len, fp)	if(_zzt_outs(s, len, fp) != len) return 0
-#define _zzt_outspad_ordie(s, len, total, fp)	if(_zzt_outspad(s, len, total, fp) != total) return 0
 
-int zztWorldWrite(ZZTworld *world, FILE *fp)
+/* Output buffer. Worlds and boards are encoded into memory and handed to
+ * the file in one write, instead of a stdio call per field. A failed
+ * allocation sticks, so callers only check once at the end. */
+typedef struct _zzt_outbuf {
+	uint8_t *data;
+	size_t len, cap;
+	int failed;
+} _zzt_outbuf;
+
+static int _zzt_buf_reserve(_zzt_outbuf *ob, size_t extra)
+{
+	size_t cap;
+	uint8_t *grown;
+
+	if (ob->failed)
+		return 0;
+	if (ob->cap - ob->len >= extra)
+		return 1;
+	cap = ob->cap ? ob->cap : 65536;
+	while (cap - ob->len < extra)
+		cap *= 2;
+	grown = realloc(ob->data, cap);
+	if (grown == NULL) {
+		ob->failed = 1;
+		return 0;
+	}
+	ob->data = grown;
+	ob->cap = cap;
+	return 1;
+}
+static void _zzt_buf_b(_zzt_outbuf *ob, uint8_t b)
+{
+	if (_zzt_buf_reserve(ob, 1))
+		ob->data[ob->len++] = b;
+}
+static void _zzt_buf_w(_zzt_outbuf *ob, uint16_t w)
+{
+	if (!_zzt_buf_reserve(ob, 2))
+		return;
+	ob->data[ob->len++] = w & 0x00FF;
+	ob->data[ob->len++] = (w & 0xFF00) >> 8;
+}
+static void _zzt_buf_s(_zzt_outbuf *ob, const void *s, size_t len)
+{
+	if (len == 0 || !_zzt_buf_reserve(ob, len))
+		return;
+	memcpy(ob->data + ob->len, s, len);
+	ob->len += len;
+}
+/* len bytes of s, then zeros up to total */
+static void _zzt_buf_spad(_zzt_outbuf *ob, const void *s, int len, int total)
+{
+	if (len > total)
+		len = total;
+	if (!_zzt_buf_reserve(ob, total))
+		return;
+	if (len > 0)
+		memcpy(ob->data + ob->len, s, len);
+	memset(ob->data + ob->len + len, 0, total - len);
+	ob->len += total;
+}
+static int _zzt_buf_flush(_zzt_outbuf *ob, FILE *fp)
+{
+	int ok = !ob->failed && fwrite(ob->data, 1, ob->len, fp) == ob->len;
+	free(ob->data);
+	return ok;
+}
+
+static int _zzt_board_write_buf(ZZTboard *board, _zzt_outbuf *ob);
+
+static void _zzt_world_write_buf(ZZTworld *world, _zzt_outbuf *ob)
 {
-	char *magicnumber = "\xFF\xFF";
-	uint16_t w;
 	uint8_t b;
 	int i;
 
 	/* Header */
-	_zzt_outs_ordie(magicnumber, 2, fp);
-	w = world->header->boardcount-1;
-	_zzt_outw_ordie(&w, fp);
-	_zzt_outw_ordie(&world->header->ammo, fp);
-	_zzt_outw_ordie(&world->header->gems, fp);
-	for(i = 0; i < 7; i++)
-		_zzt_outb_ordie(&world->header->keys[i], fp);
-	_zzt_outw_ordie(&world->header->health, fp);
-	_zzt_outw_ordie(&world->header->startboard, fp);
-	_zzt_outw_ordie(&world->header->torches, fp);
-	_zzt_outw_ordie(&world->header->torchcycles, fp);
-	_zzt_outw_ordie(&world->header->energizercycles, fp);
-	w = 0; /* Unused */
-	_zzt_outw_ordie(&w, fp);
-	_zzt_outw_ordie(&world->header->score, fp);
+	_zzt_buf_s(ob, "\xFF\xFF", 2);
+	_zzt_buf_w(ob, world->header->boardcount-1);
+	_zzt_buf_w(ob, world->header->ammo);
+	_zzt_buf_w(ob, world->header->gems);
+	_zzt_buf_s(ob, world->header->keys, 7);
+	_zzt_buf_w(ob, world->header->health);
+	_zzt_buf_w(ob, world->header->startboard);
+	_zzt_buf_w(ob, world->header->torches);
+	_zzt_buf_w(ob, world->header->torchcycles);
+	_zzt_buf_w(ob, world->header->energizercycles);
+	_zzt_buf_w(ob, 0); /* Unused */
+	_zzt_buf_w(ob, world->header->score);
 	b = strlen((char *)world->header->title);
-	_zzt_outb_ordie(&b, fp);
-	_zzt_outspad_ordie((char *)world->header->title,
-			strlen((char *)world->header->title),
-			ZZT_WORLD_TITLE_SIZE, fp);
+	if (b > ZZT_WORLD_TITLE_SIZE)
+		b = ZZT_WORLD_TITLE_SIZE;
+	_zzt_buf_b(ob, b);
+	_zzt_buf_spad(ob, world->header->title, b, ZZT_WORLD_TITLE_SIZE);
 	/* Flags */
 	for(i = 0; i < ZZT_MAX_FLAGS; i++) {
 		b = strlen((char *)world->header->flags[i]);
-		_zzt_outb_ordie(&b, fp);
-		_zzt_outspad_ordie((char *)world->header->flags[i],
-				strlen((char *)world->header->flags[i]),
-				ZZT_FLAG_SIZE, fp);
+		if (b > ZZT_FLAG_SIZE)
+			b = ZZT_FLAG_SIZE;
+		_zzt_buf_b(ob, b);
+		_zzt_buf_spad(ob, world->header->flags[i], b, ZZT_FLAG_SIZE);
 	}
 	/* More header */
-	_zzt_outw_ordie(&world->header->timepassed, fp);
-	_zzt_outw_ordie(&world->header->timepassedhsec, fp);
-	_zzt_outb_ordie(&world->header->savegame, fp);
-	_zzt_outspad_ordie(NULL, 0, 247, fp);
+	_zzt_buf_w(ob, world->header->timepassed);
+	_zzt_buf_w(ob, world->header->timepassedhsec);
+	_zzt_buf_b(ob, world->header->savegame);
+	_zzt_buf_spad(ob, NULL, 0, 247);
 	/* Write boards */
 	for(i = 0; i < world->header->boardcount; i++) {
-		if(!zztBoardWrite(&world->boards[i], fp))
-			return 0;
+		if(!_zzt_board_write_buf(&world->boards[i], ob))
+			ob->failed = 1;
 	}
-	
-	return 1;
+}
+
+uint8_t *zztWorldWriteMem(ZZTworld *world, size_t *size)
+{
+	_zzt_outbuf ob = { NULL, 0, 0, 0 };
+
+	_zzt_world_write_buf(world, &ob);
+	if (ob.failed) {
+		free(ob.data);
+		return NULL;
+	}
+	if (size != NULL)
+		*size = ob.len;
+	return ob.data;
+}
+
+int zztWorldWrite(ZZTworld *world, FILE *fp)
+{
+	_zzt_outbuf ob = { NULL, 0, 0, 0 };
+
+	_zzt_world_write_buf(world, &ob);
+	return _zzt_buf_flush(&ob, fp);
 }
 
 ZZTworld *zztWorldRead(FILE *fp)
@@ -286,6 +341,7 @@ ZZTboard *zztBoardRead(FILE *fp)
 	/* Create structure w/ exactly right size */
 	board->packed = malloc(packsize);
 	memcpy(board->packed, packed, packsize);
+	board->packedlen = packofs;
 	free(packed);
 	packed = board->packed;
 
@@ -375,94 +431,385 @@ boardReadDone:
 	return board;
 }
 
-int zztBoardWrite(ZZTboard *board, FILE *fp)
+/* In-memory reading */
+/* ----------------- */
+/* A bounds-checked view of a whole file already in memory. Every read
+ * either succeeds completely or fails without moving past the end. */
+typedef struct _zzt_span {
+	const uint8_t *data;
+	size_t size;
+	size_t pos;
+} _zzt_span;
+
+static int _zzt_span_has(_zzt_span *sp, size_t len)
+{
+	return sp->pos <= sp->size && len <= sp->size - sp->pos;
+}
+static int _zzt_span_b(_zzt_span *sp, uint8_t *a)
+{
+	if (!_zzt_span_has(sp, 1))
+		return 0;
+	*a = sp->data[sp->pos++];
+	return 1;
+}
+static int _zzt_span_w(_zzt_span *sp, void *a)
 {
-	uint32_t size;
 	uint16_t w;
-	uint8_t b;
-	int i, ofs;
+	if (!_zzt_span_has(sp, 2))
+		return 0;
+	w = sp->data[sp->pos] | (sp->data[sp->pos + 1] << 8);
+	memcpy(a, &w, sizeof(w));
+	sp->pos += 2;
+	return 1;
+}
+/* Copy len bytes plus a terminating null into s, then skip to total */
+static int _zzt_span_spad(_zzt_span *sp, char *s, int len, int total)
+{
+	if (len > total || !_zzt_span_has(sp, total))
+		return 0;
+	if (s != NULL && len != 0) {
+		memcpy(s, sp->data + sp->pos, len);
+		s[len] = '\0';
+	}
+	sp->pos += total;
+	return 1;
+}
+
+#define _zzt_span_b_or(a, sp)			if(!_zzt_span_b(sp, a))
+#define _zzt_span_w_or(a, sp)			if(!_zzt_span_w(sp, a))
+#define _zzt_span_spad_or(s, len, total, sp)	if(!_zzt_span_spad(sp, s, len, total))
 
-	ZZTparam *p;
+/* Same layout and failure rules as zztBoardRead */
+static ZZTboard *_zzt_board_read_span(_zzt_span *sp)
+{
+	ZZTboard *board = malloc(sizeof(ZZTboard));
+	uint8_t *packed = NULL;
+	size_t packstart, packlen;
+	unsigned int tiles = 0;
+	size_t board_end = sp->size;
+	uint16_t board_size, w;
+	uint8_t len;
+	int i;
+
+	if (board == NULL)
+		return NULL;
+	board->params = NULL;
+	board->info.paramcount = 0;
+	board->bigboard = NULL;
 
-	/* First, determine size of board */
-	size = 51;	/* Title length + Title + Pad */
-	for(i = 0, ofs = 0; i < ZZT_BOARD_MAX_SIZE;) {
-		i += board->packed[ofs];
-		ofs += 3;
+	_zzt_span_w_or(&board_size, sp) goto boardReadFailed;
+	board_end = sp->pos + board_size;
+	/* A truncated world: the board claims more bytes than are left */
+	if (board_end > sp->size) {
+		board_end = sp->size;
+		goto boardReadFailed;
 	}
-	size += ofs;	/* Size of packed data */
-	size += 0x58;	/* Board info */
-	for(i = 0; i < board->info.paramcount; i++) {
-		size += 0x21;			/* Object header */
-		size += board->params[i].length;/* Object data */
+
+	/* Board header */
+	_zzt_span_b_or(&len, sp) goto boardReadFailed;
+	_zzt_span_spad_or((char *)board->title, len, ZZT_BOARD_TITLE_SIZE, sp) goto boardReadFailed;
+	board->title[len] = '\0';
+
+	/* Board packed tiles: find the end of the runs, then copy them in one go */
+	packstart = sp->pos;
+	do {
+		if (!_zzt_span_has(sp, 3) || sp->pos + 3 > board_end)
+			goto boardReadFailed;
+		tiles += (sp->data[sp->pos] > 0) ? sp->data[sp->pos] : 256;
+		sp->pos += 3;
+	} while (tiles < ZZT_BOARD_MAX_SIZE);
+	packlen = sp->pos - packstart;
+	packed = malloc(packlen);
+	if (packed == NULL)
+		goto boardReadFailed;
+	memcpy(packed, sp->data + packstart, packlen);
+
+	/* Board info */
+	_zzt_span_b_or(&board->info.maxshots, sp) goto boardReadFailed;
+	_zzt_span_b_or(&board->info.darkness, sp) goto boardReadFailed;
+	_zzt_span_b_or(&board->info.board_n, sp) goto boardReadFailed;
+	_zzt_span_b_or(&board->info.board_s, sp) goto boardReadFailed;
+	_zzt_span_b_or(&board->info.board_w, sp) goto boardReadFailed;
+	_zzt_span_b_or(&board->info.board_e, sp) goto boardReadFailed;
+	_zzt_span_b_or(&board->info.reenter, sp) goto boardReadFailed;
+	_zzt_span_b_or(&len, sp) goto boardReadFailed;
+	board->info.message[0] = '\0';
+	_zzt_span_spad_or((char *)board->info.message, len, ZZT_MESSAGE_SIZE, sp) goto boardReadFailed;
+	_zzt_span_b_or(&board->info.reenter_x, sp) goto boardReadFailed;
+	_zzt_span_b_or(&board->info.reenter_y, sp) goto boardReadFailed;
+	board->info.reenter_x--;
+	board->info.reenter_y--;
+	_zzt_span_w_or(&board->info.timelimit, sp) goto boardReadFailed;
+	_zzt_span_spad_or(NULL, 0, 16, sp) goto boardReadFailed;
+	_zzt_span_w_or(&w, sp) goto boardReadFailed;
+
+	/* Every param record is 0x21 bytes; refuse counts the data cannot hold
+	 * before allocating for them */
+	if (!_zzt_span_has(sp, (size_t)(w + 1) * 0x21))
+		goto boardReadFailed;
+	board->info.paramcount = w + 1;
+
+	/* All the parameter records */
+	board->params = calloc(board->info.paramcount, sizeof(ZZTparam));
+	if (board->params == NULL) {
+		board->info.paramcount = 0;
+		goto boardReadFailed;
+	}
+	for (i = 0; i < board->info.paramcount; i++) {
+		ZZTparam *p = &board->params[i];
+		const uint8_t *rec;
+
+		if (!_zzt_span_has(sp, 0x21))
+			goto boardReadFailed;
+		rec = sp->data + sp->pos;
+		p->x = rec[0] - 1;
+		p->y = rec[1] - 1;
+		p->xstep = (int16_t)(rec[2] | (rec[3] << 8));
+		p->ystep = (int16_t)(rec[4] | (rec[5] << 8));
+		p->cycle = (int16_t)(rec[6] | (rec[7] << 8));
+		memcpy(p->data, rec + 8, 3);
+		p->followerindex = (int16_t)(rec[11] | (rec[12] << 8));
+		p->leaderindex = (int16_t)(rec[13] | (rec[14] << 8));
+		p->utype = rec[15];
+		p->ucolor = rec[16];
+		memcpy(p->magic, rec + 17, 4);
+		p->instruction = rec[21] | (rec[22] << 8);
+		w = rec[23] | (rec[24] << 8);
+		sp->pos += 0x21;
+
+		/* Bound objects store -(param index) as their length */
+		if (w < (65535 - ZZT_BOARD_MAX_PARAMS + 1)) {
+			p->length = w;
+			p->bindindex = 0;
+		} else {
+			p->bindindex = -w;
+			p->length = 0;
+			w = 0;
+		}
+		if (w != 0) {
+			if (!_zzt_span_has(sp, w)) {
+				p->length = 0;
+				goto boardReadFailed;
+			}
+			p->program = malloc(w + 1);
+			if (p->program == NULL) {
+				p->length = 0;
+				goto boardReadFailed;
+			}
+			memcpy(p->program, sp->data + sp->pos, w);
+			p->program[w] = '\0';
+			sp->pos += w;
+		}
 	}
 
-	/* Completely forbid saving boards which go over the 16-bit length */
-	if (size > 65535) {
-		return 0;
+	board->packed = packed;
+	board->packedlen = packlen;
+	board->plx = board->params[0].x;
+	board->ply = board->params[0].y;
+
+	/* Skip any junk left at the end of the board record */
+	sp->pos = board_end;
+	return board;
+
+boardReadFailed:
+	_zzt_boardread_freestuff(board, packed);
+	sp->pos = board_end;
+	return NULL;
+}
+
+ZZTboard *zztBoardReadMem(const uint8_t *data, size_t size, size_t *used)
+{
+	_zzt_span sp = { data, size, 0 };
+	ZZTboard *board = _zzt_board_read_span(&sp);
+
+	if (used != NULL)
+		*used = sp.pos;
+	return board;
+}
+
+ZZTworld *zztWorldReadMem(const uint8_t *data, size_t size)
+{
+	_zzt_span span = { data, size, 0 };
+	_zzt_span *sp = &span;
+	ZZTworld *world;
+	int i;
+
+	uint8_t len;
+	uint16_t bcount, unusedw;
+
+	/* Check header */
+	if (size < 2 || data[0] != 0xFF || data[1] != 0xFF)
+		return NULL;
+	sp->pos = 2;
+
+	/* Allocate memory for world */
+	world = malloc(sizeof(ZZTworld));
+	if (world == NULL)
+		return NULL;
+	world->header = malloc(sizeof(ZZTworldinfo));
+	world->boards = NULL;
+	world->filename = NULL;
+	if (world->header == NULL)
+		freeworld;
+
+	/* Load header */
+	_zzt_span_w_or(&bcount, sp) freeworld;
+	_zzt_span_w_or(&world->header->ammo, sp) freeworld;
+	_zzt_span_w_or(&world->header->gems, sp) freeworld;
+	for (i = 0; i < 7; i++)
+		_zzt_span_b_or(&world->header->keys[i], sp) freeworld;
+	_zzt_span_w_or(&world->header->health, sp) freeworld;
+	_zzt_span_w_or(&world->header->startboard, sp) freeworld;
+	_zzt_span_w_or(&world->header->torches, sp) freeworld;
+	_zzt_span_w_or(&world->header->torchcycles, sp) freeworld;
+	_zzt_span_w_or(&world->header->energizercycles, sp) freeworld;
+	/* Unused */
+	_zzt_span_w_or(&unusedw, sp) freeworld;
+	_zzt_span_w_or(&world->header->score, sp) freeworld;
+	_zzt_span_b_or(&len, sp) freeworld;
+	_zzt_span_spad_or((char *)world->header->title, len, ZZT_WORLD_TITLE_SIZE, sp) freeworld;
+	world->header->title[len] = '\0';
+	/* Flags */
+	for (i = 0; i < ZZT_MAX_FLAGS; i++) {
+		world->header->flags[i][0] = '\0';
+		_zzt_span_b_or(&len, sp) freeworld;
+		_zzt_span_spad_or((char *)world->header->flags[i], len, ZZT_FLAG_SIZE, sp) freeworld;
+	}
+	/* More header */
+	_zzt_span_w_or(&world->header->timepassed, sp) freeworld;
+	_zzt_span_w_or(&world->header->timepassedhsec, sp) freeworld;
+	_zzt_span_b_or(&world->header->savegame, sp) freeworld;
+	_zzt_span_spad_or(NULL, 0, 247, sp) freeworld;
+
+	/* The board count is known up front, so fill the board array in place
+	 * instead of growing it one board at a time */
+	world->header->boardcount = (uint16_t)(bcount + 1);
+	if (world->header->boardcount == 0)
+		world->header->boardcount = 1;
+	world->boards = malloc(sizeof(ZZTboard) * world->header->boardcount);
+	if (world->boards == NULL)
+		freeworld;
+	world->cur_board = 0;
+	for (i = 0; i < world->header->boardcount; i++) {
+		ZZTboard *board = _zzt_board_read_span(sp);
+		if (board == NULL)
+			board = zztBoardCreate("Error Loading Board");
+		memcpy(&world->boards[i], board, sizeof(ZZTboard));
+		free(board);
 	}
 
-	/* Write board header */
-	w = size;
-	_zzt_outw_ordie(&w, fp);
+	/* Don't know the filename, something else must set it */
+	world->filename = malloc(2);
+	strcpy(world->filename, "-");
+	return world;
+}
+
+static void _zzt_param_write_buf(ZZTparam *p, uint8_t x, uint8_t y, _zzt_outbuf *ob)
+{
+	_zzt_buf_b(ob, x+1);
+	_zzt_buf_b(ob, y+1);
+	_zzt_buf_w(ob, p->xstep);
+	_zzt_buf_w(ob, p->ystep);
+	_zzt_buf_w(ob, p->cycle);
+	_zzt_buf_s(ob, p->data, 3);
+	_zzt_buf_w(ob, p->followerindex);
+	_zzt_buf_w(ob, p->leaderindex);
+	_zzt_buf_b(ob, p->utype);
+	_zzt_buf_b(ob, p->ucolor);
+	_zzt_buf_s(ob, p->magic, 4);
+	_zzt_buf_w(ob, p->instruction);
+
+	/* Ignore binding for anything with code */
+	_zzt_buf_w(ob, p->length != 0 ? p->length : -p->bindindex);
+	_zzt_buf_spad(ob, NULL, 0, 8);
+	_zzt_buf_s(ob, p->program, p->length);
+}
+
+/* Boards still packed from loading are copied out as they are. An unpacked
+ * board is run-length encoded straight into the buffer, leaving the board
+ * itself unpacked, where zztBoardCompress would encode it and then throw
+ * the tiles away. */
+static int _zzt_board_write_buf(ZZTboard *board, _zzt_outbuf *ob)
+{
+	ZZTblock *block = board->bigboard;
+	size_t start = ob->len, size;
+	uint16_t paramcount;
+	uint8_t b;
+	int i, ofs;
+
+	/* Board size goes here once it is known */
+	_zzt_buf_w(ob, 0);
 	b = strlen((char *)board->title);
 	if (b > ZZT_BOARD_TITLE_SIZE)
 		b = ZZT_BOARD_TITLE_SIZE;
-	_zzt_outb_ordie(&b, fp);
-	_zzt_outspad_ordie((char *)board->title, b, ZZT_BOARD_TITLE_SIZE, fp);
+	_zzt_buf_b(ob, b);
+	_zzt_buf_spad(ob, board->title, b, ZZT_BOARD_TITLE_SIZE);
+
 	/* Write board */
-	_zzt_outs_ordie((char *)board->packed, ofs, fp);
+	if (block != NULL) {
+		if (_zzt_buf_reserve(ob, (size_t)block->width * block->height * 3))
+			ob->len += _zzt_rle_encode_to(block, ob->data + ob->len);
+		paramcount = block->paramcount;
+	} else {
+		for(i = 0, ofs = 0; i < ZZT_BOARD_MAX_SIZE;) {
+			i += board->packed[ofs];
+			ofs += 3;
+		}
+		_zzt_buf_s(ob, board->packed, ofs);
+		paramcount = board->info.paramcount;
+	}
+
 	/* Write board info */
-	_zzt_outb_ordie(&board->info.maxshots, fp);
-	_zzt_outb_ordie(&board->info.darkness, fp);
-	_zzt_outb_ordie(&board->info.board_n, fp);
-	_zzt_outb_ordie(&board->info.board_s, fp);
-	_zzt_outb_ordie(&board->info.board_w, fp);
-	_zzt_outb_ordie(&board->info.board_e, fp);
-	_zzt_outb_ordie(&board->info.reenter, fp);
+	_zzt_buf_b(ob, board->info.maxshots);
+	_zzt_buf_b(ob, board->info.darkness);
+	_zzt_buf_b(ob, board->info.board_n);
+	_zzt_buf_b(ob, board->info.board_s);
+	_zzt_buf_b(ob, board->info.board_w);
+	_zzt_buf_b(ob, board->info.board_e);
+	_zzt_buf_b(ob, board->info.reenter);
 	b = strlen((char *)board->info.message);
-	_zzt_outb_ordie(&b, fp);
-	_zzt_outspad_ordie((char *)board->info.message, b, ZZT_MESSAGE_SIZE, fp);
-	/* Increment re-entry points by 1 before storing to file */
-	board->info.reenter_x++;
-	board->info.reenter_y++;
-	_zzt_outb_ordie(&board->info.reenter_x, fp);
-	_zzt_outb_ordie(&board->info.reenter_y, fp);
-	/* Decrease again so that they are still usable */
-	board->info.reenter_x--;
-	board->info.reenter_y--;
-	_zzt_outw_ordie(&board->info.timelimit, fp);
-	_zzt_outspad_ordie(NULL, 0, 16, fp);
-	w = (board->info.paramcount == 0) ? 0 : board->info.paramcount-1;
-	_zzt_outw_ordie(&w, fp);
+	_zzt_buf_b(ob, b);
+	_zzt_buf_spad(ob, board->info.message, b, ZZT_MESSAGE_SIZE);
+	/* Re-entry points are stored 1-based */
+	_zzt_buf_b(ob, board->info.reenter_x+1);
+	_zzt_buf_b(ob, board->info.reenter_y+1);
+	_zzt_buf_w(ob, board->info.timelimit);
+	_zzt_buf_spad(ob, NULL, 0, 16);
+	_zzt_buf_w(ob, (paramcount == 0) ? 0 : paramcount-1);
+
 	/* Write parameter records */
-	for(i = 0; i < board->info.paramcount; i++) {
-		p = &board->params[i];
-		b = p->x+1;
-		_zzt_outb_ordie(&b, fp);
-		b = p->y+1;
-		_zzt_outb_ordie(&b, fp);
-		_zzt_outw_ordie(&p->xstep, fp);
-		_zzt_outw_ordie(&p->ystep, fp);
-		_zzt_outw_ordie(&p->cycle, fp);
-		_zzt_outb_ordie(&p->data[0], fp);
-		_zzt_outb_ordie(&p->data[1], fp);
-		_zzt_outb_ordie(&p->data[2], fp);
-		_zzt_outw_ordie(&p->followerindex, fp);
-		_zzt_outw_ordie(&p->leaderindex, fp);
-		_zzt_outb_ordie(&p->utype, fp);
-		_zzt_outb_ordie(&p->ucolor, fp);
-		_zzt_outb_ordie(&p->magic[0], fp);
-		_zzt_outb_ordie(&p->magic[1], fp);
-		_zzt_outb_ordie(&p->magic[2], fp);
-		_zzt_outb_ordie(&p->magic[3], fp);
-		_zzt_outw_ordie(&p->instruction, fp);
-
-		/* Ignore binding for anything with code */
-		w = (p->length != 0 ? p->length : -p->bindindex);
-		_zzt_outw_ordie(&w, fp);
-		_zzt_outspad_ordie(NULL, 0, 8, fp);
-		_zzt_outs_ordie((char *)p->program, p->length, fp);
+	for(i = 0; i < paramcount; i++) {
+		if (block != NULL) {
+			/* The first param always follows the player, as when compressing */
+			ZZTparam *p = block->params[i];
+			_zzt_param_write_buf(p, i == 0 ? board->plx : p->x, i == 0 ? board->ply : p->y, ob);
+		} else {
+			ZZTparam *p = &board->params[i];
+			_zzt_param_write_buf(p, p->x, p->y, ob);
+		}
 	}
+
+	if (ob->failed)
+		return 0;
+
+	/* Completely forbid saving boards which go over the 16-bit length */
+	size = ob->len - start - 2;
+	if (size > 65535) {
+		ob->len = start;
+		return 0;
+	}
+	ob->data[start] = size & 0x00FF;
+	ob->data[start + 1] = (size & 0xFF00) >> 8;
 	return 1;
 }
+
+int zztBoardWrite(ZZTboard *board, FILE *fp)
+{
+	_zzt_outbuf ob = { NULL, 0, 0, 0 };
+
+	if (!_zzt_board_write_buf(board, &ob)) {
+		free(ob.data);
+		return 0;
+	}
+	return _zzt_buf_flush(&ob, fp);
+}
@@ -0,0 +1,319 @@
+/* rle.c	-- Board RLE kernels
+ * Copyright (C) 2001 Kev Vance <kvance@kvance.com>
+ *
+ * Local modifications by Vince Patterson <vinceip532@gmail.com>
+ * Moved here from board.c; added the SSE2 kernels and runtime selection
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place Suite 330; Boston, MA 02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zzt.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define ZZT_RLE_HAVE_SSE2 1
+#include <emmintrin.h>
+#define ZZT_RLE_SSE2_FN __attribute__((target("sse2")))
+#endif
+
+/* Longest run one RLE triplet can hold when encoding */
+#define ZZT_RLE_MAX_RUN 255
+
+static int _zzt_rle_requested = ZZT_RLE_AUTO;
+
+/* Scalar kernels: the original one-run-at-a-time code, used everywhere the
+ * SSE2 ones can't run and kept as the reference they must match */
+
+static int _zzt_rle_decode_scalar(uint8_t *packed, ZZTblock *block)
+{
+	int ofs = 0, count = 0;
+	int maxcount = block->width * block->height;
+	int i;
+
+	/* NOTE: we assume that the decompressed rle string is not smaller than the
+	 * size of the block. A larger rle string will safely generate an error */
+
+	do {
+		int run_length = (packed[ofs] > 0) ? packed[ofs] : 256;
+		for(i = 0; i < run_length; i++) {
+			if (count >= maxcount)   /* Do not exceed the block size */
+				return 0;
+			block->tiles[count].type = packed[ofs+1];
+			block->tiles[count++].color = packed[ofs+2];
+		}
+		ofs += 3;
+	} while(count < maxcount);
+	return 1;
+}
+
+static int _zzt_rle_encoded_size_scalar(ZZTblock *block)
+{
+	int size = 0, ofs = 0;
+	int maxcount = block->width * block->height;
+	uint8_t blocks;
+	uint8_t type;
+	uint8_t color;
+
+	/* Get size of RLE data */
+	do {
+		/* Start with one block */
+		blocks = 1;
+		type = block->tiles[ofs].type;
+		color = block->tiles[ofs++].color;
+
+		while(ofs < maxcount && type == block->tiles[ofs].type && color == block->tiles[ofs].color && blocks < 255) {
+			blocks++;
+			ofs++;
+		}
+		size++;
+	} while(ofs < maxcount);
+
+	return size;
+}
+
+static int _zzt_rle_encode_to_scalar(ZZTblock *block, uint8_t *packed)
+{
+	int ofs = 0, ofs2 = 0;
+	int maxcount = block->width * block->height;
+	uint8_t blocks = 1;
+	uint8_t type;
+	uint8_t color;
+
+	do {
+		blocks = 1;
+		type = block->tiles[ofs].type;
+		color = block->tiles[ofs++].color;
+		if(ofs < maxcount) {
+			while(type == block->tiles[ofs].type && color == block->tiles[ofs].color && blocks < 255) {
+				blocks++;
+				ofs++;
+				if(ofs >= maxcount)
+					break;
+			}
+		}
+		packed[ofs2++] = blocks;
+		packed[ofs2++] = type;
+		packed[ofs2++] = color;
+	} while (ofs < maxcount);
+	return ofs2;
+}
+
+static uint8_t *_zzt_rle_encode_scalar(ZZTblock *block)
+{
+	int size = 0;
+
+	uint8_t *packed;
+
+	/* NOTE: the compressed string will only represent as many tiles as
+	 * are in the given block. If the block is not ZZT size, the encoded
+	 * string will not be ZZT size either. */
+
+	size = _zzt_rle_encoded_size_scalar(block);
+
+	/* Reallocate data */
+	packed = malloc(size*3);
+	/* RLE encode from unpacked */
+	_zzt_rle_encode_to_scalar(block, packed);
+	return packed;
+}
+
+#ifdef ZZT_RLE_HAVE_SSE2
+
+/* SSE2 kernels. They treat a tile as one 16-byte vector whose low word is
+ * type | color << 8, so they only run where ZZTtile is laid out that way
+ * (64-bit builds); see _zzt_rle_supported() */
+
+ZZT_RLE_SSE2_FN
+static int _zzt_rle_decode_sse2(uint8_t *packed, ZZTblock *block)
+{
+	__m128i *tiles = (__m128i *)block->tiles;
+	int maxcount = block->width * block->height;
+	int ofs = 0, count = 0;
+
+	/* Each run is one vector store per tile. The rest of the vector is
+	 * zero, so every tile comes out with a NULL param, as in a fresh block */
+	do {
+		int run_length = (packed[ofs] > 0) ? packed[ofs] : 256;
+		int end = count + run_length;
+		int overflow = end > maxcount;
+		__m128i tile = _mm_cvtsi32_si128(packed[ofs+1] | (packed[ofs+2] << 8));
+
+		if (overflow)
+			end = maxcount;
+		for (; count + 4 <= end; count += 4) {
+			_mm_storeu_si128(tiles + count, tile);
+			_mm_storeu_si128(tiles + count + 1, tile);
+			_mm_storeu_si128(tiles + count + 2, tile);
+			_mm_storeu_si128(tiles + count + 3, tile);
+		}
+		for (; count < end; count++)
+			_mm_storeu_si128(tiles + count, tile);
+		if (overflow)   /* Do not exceed the block size */
+			return 0;
+		ofs += 3;
+	} while(count < maxcount);
+	return 1;
+}
+
+/* Index of the first tile after ofs that differs from tiles[ofs], or limit */
+ZZT_RLE_SSE2_FN
+static int _zzt_rle_run_end_sse2(const ZZTtile *tiles, int ofs, int limit)
+{
+	const __m128i *t = (const __m128i *)tiles;
+	__m128i key = _mm_set1_epi16((short)(tiles[ofs].type | (tiles[ofs].color << 8)));
+	int i = ofs + 1;
+
+	/* Most runs are short; check a few tiles one at a time before going wide */
+	for (; i < limit && i < ofs + 4; i++)
+		if (tiles[i].type != tiles[ofs].type || tiles[i].color != tiles[ofs].color)
+			return i;
+
+	/* Interleave the low words of eight tiles into one vector and compare
+	 * them all against the run's type/color at once */
+	for (; i + 8 <= limit; i += 8) {
+		__m128i w01 = _mm_unpacklo_epi16(_mm_loadu_si128(t + i), _mm_loadu_si128(t + i + 1));
+		__m128i w23 = _mm_unpacklo_epi16(_mm_loadu_si128(t + i + 2), _mm_loadu_si128(t + i + 3));
+		__m128i w45 = _mm_unpacklo_epi16(_mm_loadu_si128(t + i + 4), _mm_loadu_si128(t + i + 5));
+		__m128i w67 = _mm_unpacklo_epi16(_mm_loadu_si128(t + i + 6), _mm_loadu_si128(t + i + 7));
+		__m128i keys = _mm_unpacklo_epi64(_mm_unpacklo_epi32(w01, w23), _mm_unpacklo_epi32(w45, w67));
+		int mask = _mm_movemask_epi8(_mm_cmpeq_epi16(keys, key));
+
+		if (mask != 0xFFFF)
+			return i + __builtin_ctz(~mask) / 2;
+	}
+	while (i < limit && tiles[i].type == tiles[ofs].type && tiles[i].color == tiles[ofs].color)
+		i++;
+	return i;
+}
+
+ZZT_RLE_SSE2_FN
+static int _zzt_rle_encoded_size_sse2(ZZTblock *block)
+{
+	int maxcount = block->width * block->height;
+	int size = 0, ofs = 0;
+
+	do {
+		int limit = (maxcount - ofs > ZZT_RLE_MAX_RUN) ? ofs + ZZT_RLE_MAX_RUN : maxcount;
+		ofs = _zzt_rle_run_end_sse2(block->tiles, ofs, limit);
+		size++;
+	} while(ofs < maxcount);
+
+	return size;
+}
+
+ZZT_RLE_SSE2_FN
+static int _zzt_rle_encode_to_sse2(ZZTblock *block, uint8_t *packed)
+{
+	int maxcount = block->width * block->height;
+	int ofs = 0, ofs2 = 0;
+
+	do {
+		int limit = (maxcount - ofs > ZZT_RLE_MAX_RUN) ? ofs + ZZT_RLE_MAX_RUN : maxcount;
+		int end = _zzt_rle_run_end_sse2(block->tiles, ofs, limit);
+
+		packed[ofs2++] = end - ofs;
+		packed[ofs2++] = block->tiles[ofs].type;
+		packed[ofs2++] = block->tiles[ofs].color;
+		ofs = end;
+	} while(ofs < maxcount);
+	return ofs2;
+}
+
+#endif /* ZZT_RLE_HAVE_SSE2 */
+
+static int _zzt_rle_supported(int kernel)
+{
+	switch (kernel) {
+	case ZZT_RLE_SCALAR:
+		return 1;
+#ifdef ZZT_RLE_HAVE_SSE2
+	case ZZT_RLE_SSE2:
+		return sizeof(ZZTtile) == 16 && offsetof(ZZTtile, type) == 0 &&
+			offsetof(ZZTtile, color) == 1 && offsetof(ZZTtile, param) == 8 &&
+			__builtin_cpu_supports("sse2");
+#endif
+	default:
+		return 0;
+	}
+}
+
+int zztRleGetKernel(void)
+{
+	if (_zzt_rle_requested != ZZT_RLE_AUTO)
+		return _zzt_rle_requested;
+	return _zzt_rle_supported(ZZT_RLE_SSE2) ? ZZT_RLE_SSE2 : ZZT_RLE_SCALAR;
+}
+
+int zztRleSetKernel(int kernel)
+{
+	if (kernel != ZZT_RLE_AUTO && !_zzt_rle_supported(kernel))
+		kernel = ZZT_RLE_SCALAR;
+	_zzt_rle_requested = kernel;
+	return zztRleGetKernel();
+}
+
+int _zzt_rle_decode(uint8_t *packed, ZZTblock *block)
+{
+#ifdef ZZT_RLE_HAVE_SSE2
+	if (zztRleGetKernel() == ZZT_RLE_SSE2)
+		return _zzt_rle_decode_sse2(packed, block);
+#endif
+	return _zzt_rle_decode_scalar(packed, block);
+}
+
+int _zzt_rle_encoded_size(ZZTblock *block)
+{
+#ifdef ZZT_RLE_HAVE_SSE2
+	if (zztRleGetKernel() == ZZT_RLE_SSE2)
+		return _zzt_rle_encoded_size_sse2(block);
+#endif
+	return _zzt_rle_encoded_size_scalar(block);
+}
+
+int _zzt_rle_encode_to(ZZTblock *block, uint8_t *packed)
+{
+#ifdef ZZT_RLE_HAVE_SSE2
+	if (zztRleGetKernel() == ZZT_RLE_SSE2)
+		return _zzt_rle_encode_to_sse2(block, packed);
+#endif
+	return _zzt_rle_encode_to_scalar(block, packed);
+}
+
+uint8_t *_zzt_rle_encode(ZZTblock *block)
+{
+#ifdef ZZT_RLE_HAVE_SSE2
+	if (zztRleGetKernel() == ZZT_RLE_SSE2) {
+		/* One pass into a worst-case buffer, then give back the slack */
+		int maxcount = block->width * block->height;
+		uint8_t *packed = malloc((maxcount > 0 ? maxcount : 1) * 3);
+		uint8_t *shrunk;
+		int size;
+
+		if (packed == NULL)
+			return NULL;
+		size = _zzt_rle_encode_to_sse2(block, packed);
+		shrunk = realloc(packed, size);
+		return shrunk ? shrunk : packed;
+	}
+#endif
+	return _zzt_rle_encode_scalar(block);
+}
@@ -115,14 +115,11 @@ int zztWorldSave(ZZTworld *world)
 	if(fp == NULL)
 		return 0;
 	
-	/* Commit current board */
-	zztBoardCommit(world);
-	/* Write to file */
+	/* Write to file. The current board is encoded without packing it, so
+	 * there is nothing to unpack again afterwards */
 	result = zztWorldWrite(world, fp);
-	fclose(fp);
-
-	/* Decompress the current board */
-	zztBoardDecompress(&(world->boards[zztBoardGetCurrent(world)]));
+	if (fclose(fp) != 0)
+		result = 0;
 
 	/* Done */
 	return result;
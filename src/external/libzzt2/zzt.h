@@ -7,6 +7,9 @@
  * Added extern declarations for _zzt_display_char_table and
  * _zzt_display_char_line_table (tiles.c)
  * Added inline helper zzt_type_to_cp437()
+ * Added zztWorldReadMem() and zztBoardReadMem() for worlds already in memory
+ * Added zztWorldWriteMem(); world and board writes go through one buffer
+ * Moved the RLE helpers to rle.c and added SSE2 kernels picked at runtime
  *
  * This program is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -168,6 +171,7 @@ extern "C"
 		uint8_t title[ZZT_BOARD_TITLE_SIZE + 1]; /* Board title */
 		ZZTboardinfo info;						 /* Board info */
 		uint8_t *packed;						 /* RLE packed board data */
+		size_t packedlen;						 /* Bytes of RLE data in packed */
 		ZZTparam *params;						 /* Array of parameters */
 		ZZTblock *bigboard;						 /* Data & params when unpacked */
 
@@ -402,6 +406,11 @@ extern "C"
 	 * Write a single board to an open file
 	 */
 	int zztBoardWrite(ZZTboard *board, FILE *fp);
+	/* zztWorldWriteMem(world, size)
+	 * Encode a whole world as it would be written to a file. Returns a
+	 * malloc()ed buffer and its length in size, or NULL on failure
+	 */
+	uint8_t *zztWorldWriteMem(ZZTworld *world, size_t *size);
 	/* zztWorldRead(fp)
 	 * Read in a whole world from an open file
 	 */
@@ -410,6 +419,16 @@ extern "C"
 	 * Read in a single board from an open file
 	 */
 	ZZTboard *zztBoardRead(FILE *fp);
+	/* zztWorldReadMem(data, size)
+	 * Read in a whole world from a buffer holding the entire file. Nothing
+	 * in the result points into the buffer, so it can be released afterwards
+	 */
+	ZZTworld *zztWorldReadMem(const uint8_t *data, size_t size);
+	/* zztBoardReadMem(data, size, used)
+	 * Read in a single board from a buffer; used (if not NULL) receives how
+	 * many bytes the board record took up
+	 */
+	ZZTboard *zztBoardReadMem(const uint8_t *data, size_t size, size_t *used);
 
 	/***** BLOCK MANIPULATORS ******/
 	/* zztBlockCreate(width, height)
@@ -434,6 +453,39 @@ extern "C"
 	 */
 	int zztBlockPaste(ZZTblock *dest, ZZTblock *src, int x, int y);
 
+	/***** RLE *****/
+	/* Kernels behind the board RLE helpers */
+#define ZZT_RLE_AUTO 0   /* Fastest one the CPU supports (the default) */
+#define ZZT_RLE_SCALAR 1 /* Portable one-run-at-a-time code */
+#define ZZT_RLE_SSE2 2   /* Vector stores and compares; x86 64-bit builds */
+	/* zztRleSetKernel(kernel)
+	 * Pick the RLE kernel, mainly for testing. Not thread-safe. Returns the
+	 * kernel now in use, ZZT_RLE_SCALAR if the CPU can't run the one asked for
+	 */
+	int zztRleSetKernel(int kernel);
+	/* zztRleGetKernel()
+	 * The kernel the RLE helpers use, never ZZT_RLE_AUTO
+	 */
+	int zztRleGetKernel(void);
+	/* _zzt_rle_decode(packed, block)
+	 * Fill block's tiles from RLE data, leaving their params NULL. Returns 0
+	 * if the data runs past the end of the block
+	 */
+	int _zzt_rle_decode(uint8_t *packed, ZZTblock *block);
+	/* _zzt_rle_encoded_size(block)
+	 * Number of RLE triplets block encodes to
+	 */
+	int _zzt_rle_encoded_size(ZZTblock *block);
+	/* _zzt_rle_encode_to(block, packed)
+	 * RLE encode block into packed, which must have room for 3 bytes per
+	 * tile. Returns the number of bytes written
+	 */
+	int _zzt_rle_encode_to(ZZTblock *block, uint8_t *packed);
+	/* _zzt_rle_encode(block)
+	 * RLE encode block into a new malloc()ed buffer
+	 */
+	uint8_t *_zzt_rle_encode(ZZTblock *block);
+
 	/***** PARAMETER MANIPULATORS *****/
 	/* zztParamCreateBlank()
 	 * Create a blank, typeless param. Use only in advanced situations!
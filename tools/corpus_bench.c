@@ -0,0 +1,120 @@
+/**
+ * @file corpus_bench.c
+ * @brief Bulk world reading: one file at a time vs the batched corpus reader
+ *
+ * Usage: corpus_bench [-b batch] world.zzt [more.zzt ...]
+ *
+ * Reads every file and parses it with zztWorldReadMem, first with plain
+ * sequential stdio, then through Bzzt_Corpus_Reader on threads and on
+ * io_uring where the kernel has it. Reports MB/s of file data and worlds
+ * parsed per second. Files already in the page cache make this mostly a
+ * syscall benchmark; drop caches between runs to measure the disk.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+#include "zzt.h"
+#include "clock.h"
+#include "corpus_reader.h"
+
+typedef struct Bench_Totals
+{
+    int files, worlds, boards;
+    uint64_t bytes;
+} Bench_Totals;
+
+static void parse_file(const uint8_t *data, size_t size, Bench_Totals *t)
+{
+    t->files++;
+    t->bytes += size;
+    ZZTworld *zw = zztWorldReadMem((uint8_t *)data, size);
+    if (!zw)
+        return;
+    t->worlds++;
+    t->boards += zztWorldGetBoardcount(zw);
+    zztWorldFree(zw);
+}
+
+static void print_row(const char *label, const Bench_Totals *t, double ms)
+{
+    double s = ms / 1000.0;
+    printf("%-10s %8d %8d %10.1f %10.1f %10.1f %12.1f\n", label, t->files, t->worlds, t->bytes / 1e6, ms,
+           s > 0 ? t->bytes / 1e6 / s : 0.0, s > 0 ? t->worlds / s : 0.0);
+}
+
+static void run_stdio(char **files, int count)
+{
+    Bench_Totals t = {0};
+    double start_ms = Bzzt_Clock_Now_Ms();
+    for (int i = 0; i < count; ++i)
+    {
+        FILE *fp = fopen(files[i], "rb");
+        if (!fp)
+            continue;
+        struct stat st;
+        uint8_t *data = NULL;
+        if (fstat(fileno(fp), &st) == 0 && (data = malloc(st.st_size ? st.st_size : 1)) &&
+            fread(data, 1, st.st_size, fp) == (size_t)st.st_size)
+            parse_file(data, st.st_size, &t);
+        free(data);
+        fclose(fp);
+    }
+    print_row("stdio", &t, Bzzt_Clock_Now_Ms() - start_ms);
+}
+
+static void run_reader(char **files, int count, Bzzt_Corpus_Backend backend, int batch)
+{
+    Bzzt_Corpus_Reader *r = Bzzt_Corpus_Reader_Open((const char *const *)files, count, backend, batch);
+    if (!r)
+    {
+        fprintf(stderr, "corpus_bench: could not start the %s reader\n", Bzzt_Corpus_Backend_Name(backend));
+        return;
+    }
+
+    Bench_Totals t = {0};
+    Bzzt_Corpus_File f;
+    while (Bzzt_Corpus_Reader_Next(r, &f))
+    {
+        if (f.data)
+            parse_file(f.data, f.size, &t);
+        free(f.data);
+    }
+
+    Bzzt_Corpus_Stats stats;
+    Bzzt_Corpus_Reader_Get_Stats(r, &stats);
+    Bzzt_Corpus_Reader_Close(r);
+    if (stats.backend != backend)
+    {
+        printf("%-10s (not available)\n", Bzzt_Corpus_Backend_Name(backend));
+        return;
+    }
+    print_row(Bzzt_Corpus_Backend_Name(stats.backend), &t, stats.elapsed_ms);
+}
+
+int main(int argc, char **argv)
+{
+    int batch = BZZT_CORPUS_DEFAULT_BATCH;
+    int first = 1;
+    if (first + 1 < argc && strcmp(argv[first], "-b") == 0)
+    {
+        batch = atoi(argv[first + 1]);
+        first += 2;
+    }
+
+    if (first >= argc)
+    {
+        fprintf(stderr, "usage: %s [-b batch] world.zzt [more.zzt ...]\n", argv[0]);
+        return 1;
+    }
+
+    char **files = argv + first;
+    int count = argc - first;
+    printf("%-10s %8s %8s %10s %10s %10s %12s\n", "reader", "files", "worlds", "MB", "ms", "MB/s", "worlds/s");
+    run_stdio(files, count);
+    run_reader(files, count, BZZT_CORPUS_THREADS, batch);
+    run_reader(files, count, BZZT_CORPUS_IO_URING, batch);
+    return 0;
+}
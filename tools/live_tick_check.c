@@ -0,0 +1,222 @@
+/**
+ * @file live_tick_check.c
+ * @brief Checks parallel ticking of live boards against the plain tick
+ *
+ * Usage: live_tick_check [ticks]
+ *
+ * Builds a world whose current board and several live background boards are
+ * full of stars, guns and bullets, plus one board that isn't live. The cases:
+ *   - the current board ends exactly as the plain tick leaves it, and the
+ *     board that isn't live never changes;
+ *   - live boards keep ticking, and every board ends the same whatever the
+ *     worker count;
+ *   - shots at where the player last stood on a background board hurt no one;
+ *   - score earned on background boards is merged into the world's.
+ * Prints each case and exits non-zero if any of them fails.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bzzt.h"
+#include "timing.h"
+#include "ui.h"
+
+#define CHECK_BOARD_W 60
+#define CHECK_BOARD_H 25
+#define CURRENT_BOARD 1 // Board 0 is the empty title board every new world starts with
+#define LIVE_BOARDS 6   // Live background boards follow the current one
+#define STILL_BOARD (CURRENT_BOARD + LIVE_BOARDS + 1) // Not live; must never change
+
+static int failures;
+
+static void expect(bool ok, const char *what)
+{
+    printf("%-60s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok)
+        failures++;
+}
+
+static uint64_t hash_board(const Bzzt_Board *b)
+{
+    uint64_t h = 1469598103934665603ull;
+    for (int i = 0; i < b->width * b->height; ++i)
+    {
+        h = (h ^ b->tiles[i].element) * 1099511628211ull;
+        h = (h ^ b->tiles[i].glyph) * 1099511628211ull;
+    }
+    return (h ^ (uint64_t)b->stat_count) * 1099511628211ull;
+}
+
+// Fills a board below row 0 with a fixed layout per seed, so every run starts the same
+static void populate(Bzzt_Board *b, uint32_t seed, int stats)
+{
+    uint32_t lcg = seed;
+    int placed = 1;
+    for (int tries = 0; placed < stats && tries < stats * 8; ++tries)
+    {
+        lcg = lcg * 1103515245u + 12345u;
+        int x = (int)((lcg >> 8) % CHECK_BOARD_W);
+        lcg = lcg * 1103515245u + 12345u;
+        int y = 1 + (int)((lcg >> 8) % (CHECK_BOARD_H - 1));
+        if (Bzzt_Board_Get_Tile(b, x, y).element != ZZT_EMPTY)
+            continue;
+
+        uint8_t element = (placed % 4 == 0) ? ZZT_BULLET : (placed % 3 == 0) ? ZZT_STAR : ZZT_SPINNINGGUN;
+        Bzzt_Stat *s = Bzzt_Board_Spawn_Stat(b, element, x, y, COLOR_LIGHT_GREEN, COLOR_BLACK);
+        if (!s)
+            break;
+
+        s->cycle = 1 + placed % 2;
+        if (element == ZZT_SPINNINGGUN)
+        {
+            s->data[0] = 4; // Intelligence
+            s->data[1] = 3; // Fire rate
+        }
+        else if (element == ZZT_STAR)
+        {
+            s->data[0] = 255; // Lifetime
+        }
+        else
+        {
+            s->data[0] = 1; // Fired by an enemy
+            s->step_x = (placed & 1) ? 1 : -1;
+        }
+        placed++;
+    }
+}
+
+/* A player bullet next to a lion in row 0. Added right after the player, so
+ * the bullet ticks before anything else and kills the lion for a point. */
+static void add_lion_kill(Bzzt_Board *b)
+{
+    Bzzt_Stat *bullet = Bzzt_Board_Spawn_Stat(b, ZZT_BULLET, 1, 0, COLOR_WHITE, COLOR_BLACK);
+    Bzzt_Stat *lion = Bzzt_Board_Spawn_Stat(b, ZZT_LION, 2, 0, COLOR_RED, COLOR_BLACK);
+    if (!bullet || !lion)
+        return;
+    bullet->cycle = 1;
+    bullet->step_x = 1;
+    bullet->data[0] = 0; // Fired by the player
+    lion->cycle = 3;
+}
+
+// An enemy bullet about to hit where the player stands
+static void add_shot_at_player(Bzzt_Board *b)
+{
+    Bzzt_Stat *bullet = Bzzt_Board_Spawn_Stat(b, ZZT_BULLET, CHECK_BOARD_W / 2 - 1, CHECK_BOARD_H / 2,
+                                              COLOR_WHITE, COLOR_BLACK);
+    if (!bullet)
+        return;
+    bullet->cycle = 1;
+    bullet->step_x = 1;
+    bullet->data[0] = 1;
+}
+
+static Bzzt_World *build_world(void)
+{
+    Bzzt_World *w = Bzzt_World_Create("live tick check");
+    if (!w)
+        return NULL;
+
+    for (int i = CURRENT_BOARD; i <= STILL_BOARD; ++i)
+    {
+        Bzzt_Board *b = Bzzt_Board_Create("live", CHECK_BOARD_W, CHECK_BOARD_H);
+        if (!b)
+        {
+            Bzzt_World_Destroy(w);
+            return NULL;
+        }
+        Bzzt_World_Add_Board(w, b);
+        Bzzt_Board_Spawn_Stat(b, ZZT_PLAYER, CHECK_BOARD_W / 2, CHECK_BOARD_H / 2, COLOR_WHITE, COLOR_BLUE);
+        if (i != CURRENT_BOARD)
+        {
+            add_lion_kill(b);
+            add_shot_at_player(b);
+        }
+        populate(b, 1000u + (uint32_t)i, 200);
+        b->live = i != STILL_BOARD;
+    }
+
+    w->boards_current = CURRENT_BOARD;
+    w->on_title = false;
+    w->health = 16000; // Enough that hits on the current board never bring it to 0
+    return w;
+}
+
+typedef struct Run_Result
+{
+    uint64_t board_hash[STILL_BOARD + 1];
+    int16_t health, score;
+} Run_Result;
+
+// threads < 0 runs the plain tick; otherwise parallel ticking with that many workers
+static bool run(UI *ui, int ticks, int threads, Run_Result *out)
+{
+    Bzzt_World *w = build_world();
+    if (!w)
+        return false;
+
+    if (threads >= 0 && !Bzzt_World_Set_Parallel_Ticking(w, true, threads))
+    {
+        Bzzt_World_Destroy(w);
+        return false;
+    }
+
+    for (int i = 0; i < ticks; ++i)
+        Bzzt_Timer_Run_Tick(ui, w);
+
+    for (int i = 0; i <= STILL_BOARD; ++i)
+        out->board_hash[i] = hash_board(w->boards[i]);
+    out->health = w->health;
+    out->score = w->score;
+    Bzzt_World_Destroy(w);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int ticks = argc > 1 ? atoi(argv[1]) : 60;
+    if (ticks < 1)
+        ticks = 1;
+
+    UI *ui = UI_Create_Headless();
+    Bzzt_World *initial = build_world();
+    if (!ui || !initial)
+    {
+        fprintf(stderr, "live_tick_check: could not build the world\n");
+        return 1;
+    }
+
+    Run_Result plain, x1, x2, x4;
+    bool ran = run(ui, ticks, -1, &plain) && run(ui, ticks, 1, &x1) && run(ui, ticks, 2, &x2) &&
+               run(ui, ticks, 4, &x4);
+    expect(ran, "setup: every run started");
+    if (ran)
+    {
+        expect(x1.board_hash[CURRENT_BOARD] == plain.board_hash[CURRENT_BOARD],
+               "current: ends as the plain tick leaves it");
+        expect(x1.board_hash[STILL_BOARD] == hash_board(initial->boards[STILL_BOARD]),
+               "still: a board that isn't live never changes");
+
+        bool all_changed = true;
+        for (int i = CURRENT_BOARD + 1; i < STILL_BOARD; ++i)
+            all_changed = all_changed && x1.board_hash[i] != hash_board(initial->boards[i]);
+        expect(all_changed, "live: every live background board ticked");
+
+        bool same = x1.health == x2.health && x1.health == x4.health && x1.score == x2.score &&
+                    x1.score == x4.score;
+        for (int i = 0; i <= STILL_BOARD; ++i)
+            same = same && x1.board_hash[i] == x2.board_hash[i] && x1.board_hash[i] == x4.board_hash[i];
+        expect(same, "live: same boards and counters with 1, 2 and 4 workers");
+
+        expect(x1.health == plain.health, "player: shots on background boards hurt no one");
+        expect(x1.score == plain.score + LIVE_BOARDS, "score: one lion per live board merged in");
+    }
+
+    Bzzt_World_Destroy(initial);
+    UI_Destroy(ui);
+
+    printf("%d failure%s\n", failures, failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file load_bench.c
+ * @brief Full-world load and conversion speed, serial vs a growing board pool
+ *
+ * Usage: load_bench world.zzt [more.zzt ...]
+ *
+ * Every world is loaded with all of its boards converted, first on the
+ * calling thread and then with 1, 2, 4, ... pool workers. The hash column
+ * covers every converted board and must match across rows.
+ */
+#include <stdio.h>
+#include <stdint.h>
+
+#include "bzzt.h"
+#include "clock.h"
+#include "thread_pool.h"
+
+static uint64_t hash_world(const Bzzt_World *w, uint64_t h)
+{
+    for (int i = 0; i < w->boards_count; ++i)
+    {
+        const Bzzt_Board *b = w->boards[i];
+        if (!b)
+            continue;
+        for (int t = 0; t < b->width * b->height; ++t)
+        {
+            h = (h ^ b->tiles[t].element) * 1099511628211ull;
+            h = (h ^ b->tiles[t].glyph) * 1099511628211ull;
+            h = (h ^ b->tiles[t].fg.r) * 1099511628211ull;
+        }
+        h = (h ^ (uint64_t)b->stat_count) * 1099511628211ull;
+    }
+    return h;
+}
+
+// threads == 0 converts on this thread
+static void run_case(char **files, int file_count, int threads)
+{
+    Bzzt_Thread_Pool *pool = threads > 0 ? Bzzt_Thread_Pool_Create(threads) : NULL;
+    uint64_t h = 1469598103934665603ull;
+    int worlds = 0, boards = 0;
+
+    double start_ms = Bzzt_Clock_Now_Ms();
+    for (int i = 0; i < file_count; ++i)
+    {
+        Bzzt_World *w = Bzzt_World_From_ZZT_World_Parallel(files[i], pool);
+        if (!w)
+        {
+            fprintf(stderr, "load_bench: could not load %s\n", files[i]);
+            continue;
+        }
+        worlds++;
+        boards += w->boards_count;
+        h = hash_world(w, h);
+        Bzzt_World_Destroy(w);
+    }
+    double elapsed_s = (Bzzt_Clock_Now_Ms() - start_ms) / 1000.0;
+    Bzzt_Thread_Pool_Destroy(pool);
+
+    char label[32];
+    if (threads == 0)
+        snprintf(label, sizeof(label), "serial");
+    else
+        snprintf(label, sizeof(label), "pool x%d", threads);
+
+    printf("%-10s %8d %8d %10.3f %12.1f %12.1f  %016llx\n", label, worlds, boards, elapsed_s,
+           elapsed_s > 0.0 ? worlds / elapsed_s : 0.0,
+           elapsed_s > 0.0 ? boards / elapsed_s : 0.0,
+           (unsigned long long)h);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s world.zzt [more.zzt ...]\n", argv[0]);
+        return 1;
+    }
+
+    int cpus = Bzzt_Cpu_Count();
+    printf("%d files, %d CPUs\n", argc - 1, cpus);
+    printf("%-10s %8s %8s %10s %12s %12s  %s\n", "mode", "worlds", "boards", "seconds", "worlds/sec", "boards/sec", "hash");
+
+    run_case(argv + 1, argc - 1, 0);
+    for (int threads = 1; threads <= cpus * 2 && threads <= 64; threads *= 2)
+        run_case(argv + 1, argc - 1, threads);
+
+    return 0;
+}
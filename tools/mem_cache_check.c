@@ -0,0 +1,151 @@
+/**
+ * @file mem_cache_check.c
+ * @brief Checks the shared memory cache's eviction bookkeeping
+ *
+ * Usage: mem_cache_check
+ *
+ * Items are slots of a static array, so an evicted slot's address comes
+ * straight back as a new item, the way malloc hands a freed block out again.
+ * The cases:
+ *   - an evict callback frees its slot and inserts the same address as a
+ *     new item before Trim has taken the lock back;
+ *   - a callback that keeps its item re-inserts it with a new size;
+ *   - the victim comes from the category furthest over its share, not
+ *     just the least recently used item of any category over its share.
+ * Prints each case and exits non-zero if any of them fails.
+ */
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mem_cache.h"
+
+#define SLOT_COUNT 8
+#define KB 1024
+
+typedef struct Slot
+{
+    bool live;
+    int generation; // Bumped each time the slot is handed out again
+} Slot;
+
+static Slot slots[SLOT_COUNT];
+static int evict_calls;
+static int failures;
+
+// Frees the slot, then puts the same address back in the cache as a new item
+static bool evict_and_reuse(void *ctx, void *item)
+{
+    (void)ctx;
+    Slot *slot = item;
+    evict_calls++;
+    slot->live = false;
+    if (evict_calls == 1)
+    {
+        slot->live = true;
+        slot->generation++;
+        Bzzt_Mem_Cache_Insert(BZZT_MEM_CACHE_ZIP_MEMBERS, slot, 4 * KB, evict_and_reuse, NULL);
+    }
+    return true;
+}
+
+// Keeps the item but reports a new size for it, as an owner refreshing its entry would
+static bool keep_and_resize(void *ctx, void *item)
+{
+    (void)ctx;
+    evict_calls++;
+    Bzzt_Mem_Cache_Insert(BZZT_MEM_CACHE_ZIP_MEMBERS, item, 2 * KB, keep_and_resize, NULL);
+    return false;
+}
+
+static bool recording_evict(void *ctx, void *item)
+{
+    *(void **)ctx = item;
+    ((Slot *)item)->live = false;
+    return true;
+}
+
+static void expect(bool ok, const char *what)
+{
+    printf("%-60s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok)
+        failures++;
+}
+
+static size_t used(void)
+{
+    Bzzt_Mem_Cache_Stats stats;
+    Bzzt_Mem_Cache_Get_Stats(&stats);
+    return stats.used;
+}
+
+static void reset(void)
+{
+    for (int i = 0; i < SLOT_COUNT; ++i)
+        Bzzt_Mem_Cache_Remove(&slots[i]);
+    memset(slots, 0, sizeof(slots));
+    evict_calls = 0;
+    Bzzt_Mem_Cache_Configure(0);
+}
+
+static void check_reinsert_during_eviction(void)
+{
+    reset();
+    Slot *slot = &slots[0];
+    slot->live = true;
+    Bzzt_Mem_Cache_Insert(BZZT_MEM_CACHE_ZIP_MEMBERS, slot, 16 * KB, evict_and_reuse, NULL);
+
+    // Evicts the 16 KB item; its callback reuses the slot for a 4 KB one that fits
+    Bzzt_Mem_Cache_Configure(8 * KB);
+    expect(evict_calls == 1, "reinsert: old item evicted once");
+    expect(slot->live && slot->generation == 1, "reinsert: new item alive");
+    expect(used() == 4 * KB, "reinsert: new item still tracked after Trim");
+
+    // Still tracked means a tighter budget evicts it in turn
+    Bzzt_Mem_Cache_Configure(2 * KB);
+    expect(evict_calls == 2 && !slot->live, "reinsert: new item evictable later");
+    expect(used() == 0, "reinsert: nothing left tracked");
+}
+
+static void check_resize_during_eviction(void)
+{
+    reset();
+    Slot *slot = &slots[1];
+    slot->live = true;
+    Bzzt_Mem_Cache_Insert(BZZT_MEM_CACHE_ZIP_MEMBERS, slot, 16 * KB, keep_and_resize, NULL);
+
+    Bzzt_Mem_Cache_Configure(8 * KB);
+    expect(evict_calls == 1, "resize: callback ran once");
+    expect(used() == 2 * KB, "resize: counted once, at the new size");
+
+    Bzzt_Mem_Cache_Remove(slot);
+    expect(used() == 0, "resize: Remove drops it");
+}
+
+static void check_victim_category(void)
+{
+    reset();
+    void *victim = NULL;
+
+    // Oldest: a world 1 KB over its third of the budget
+    slots[2].live = true;
+    Bzzt_Mem_Cache_Insert(BZZT_MEM_CACHE_WORLDS, &slots[2], 13 * KB, recording_evict, &victim);
+    // Newer: zip members 20 KB over theirs
+    slots[3].live = true;
+    Bzzt_Mem_Cache_Insert(BZZT_MEM_CACHE_ZIP_MEMBERS, &slots[3], 32 * KB, recording_evict, &victim);
+
+    Bzzt_Mem_Cache_Configure(36 * KB);
+    expect(victim == &slots[3], "victim: taken from the category furthest over its share");
+    expect(slots[2].live, "victim: the older, barely-over item stays");
+}
+
+int main(void)
+{
+    check_reinsert_during_eviction();
+    check_resize_during_eviction();
+    check_victim_category();
+    reset();
+
+    printf("%d failure%s\n", failures, failures == 1 ? "" : "s");
+    return failures ? 1 : 0;
+}
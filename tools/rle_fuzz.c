@@ -0,0 +1,245 @@
+/**
+ * @file rle_fuzz.c
+ * @brief Checks that libzzt2's RLE kernels all match the scalar one exactly
+ *
+ * Usage: rle_fuzz [-n rounds] [-s seed] world.zzt [more.zzt ...]
+ *
+ * Every board of every world is decoded and re-encoded with each kernel the
+ * CPU supports, and the tiles, triplet counts and encoded bytes are compared
+ * with what ZZT_RLE_SCALAR produces. Each board then seeds rounds of mutated
+ * boards and random RLE streams, run on odd block sizes as well as the full
+ * 60x25, to reach the run and block edges real worlds rarely hit.
+ * Every mismatch is reported on stderr and the run carries on, so one bad
+ * kernel shows all the cases it gets wrong; the exit status is non-zero if
+ * there was any.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "zzt.h"
+#include "file_map.h"
+
+typedef struct Rle_Result
+{
+    int decoded;
+    ZZTblock *block;
+    int size;
+    uint8_t *packed;
+    int packed_len;
+} Rle_Result;
+
+static const int kernels[] = {ZZT_RLE_SSE2};
+static const char *kernel_names[] = {"auto", "scalar", "sse2"}; // By ZZT_RLE_* value
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+static long checks, failures;
+
+static uint32_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (uint32_t)(rng_state >> 32);
+}
+
+static Rle_Result run_kernel(int kernel, const uint8_t *packed, const ZZTblock *source, int width, int height)
+{
+    Rle_Result r = {0};
+    zztRleSetKernel(kernel);
+
+    r.block = zztBlockCreate(width, height);
+    if (packed)
+        r.decoded = _zzt_rle_decode((uint8_t *)packed, r.block);
+    else
+        memcpy(r.block->tiles, source->tiles, sizeof(ZZTtile) * width * height);
+
+    r.size = _zzt_rle_encoded_size(r.block);
+    r.packed = _zzt_rle_encode(r.block);
+    uint8_t *direct = malloc((size_t)width * height * 3);
+    r.packed_len = _zzt_rle_encode_to(r.block, direct);
+    if (r.packed_len != r.size * 3 || memcmp(direct, r.packed, r.packed_len) != 0)
+        r.packed_len = -1; // _zzt_rle_encode and _zzt_rle_encode_to disagree
+    free(direct);
+    return r;
+}
+
+static void free_result(Rle_Result *r)
+{
+    zztBlockFree(r->block);
+    free(r->packed);
+}
+
+static bool same_tiles(const ZZTblock *a, const ZZTblock *b)
+{
+    for (int i = 0; i < a->width * a->height; ++i)
+    {
+        if (a->tiles[i].type != b->tiles[i].type || a->tiles[i].color != b->tiles[i].color ||
+            a->tiles[i].param != b->tiles[i].param)
+            return false;
+    }
+    return true;
+}
+
+// Run every supported kernel on the same input and compare with the scalar one
+static bool check_case(const char *what, const uint8_t *packed, const ZZTblock *source, int width, int height)
+{
+    Rle_Result ref = run_kernel(ZZT_RLE_SCALAR, packed, source, width, height);
+    bool ok = true;
+
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]) && ok; ++k)
+    {
+        if (zztRleSetKernel(kernels[k]) != kernels[k])
+            continue;
+
+        Rle_Result got = run_kernel(kernels[k], packed, source, width, height);
+        checks++;
+        ok = got.decoded == ref.decoded && same_tiles(got.block, ref.block) && got.size == ref.size &&
+             got.packed_len == ref.packed_len && got.packed_len >= 0 &&
+             memcmp(got.packed, ref.packed, ref.packed_len) == 0;
+        if (!ok)
+        {
+            fprintf(stderr, "rle_fuzz: %s kernel differs from scalar on %s (%dx%d)\n", kernel_names[kernels[k]],
+                    what, width, height);
+            failures++;
+        }
+        free_result(&got);
+    }
+
+    free_result(&ref);
+    zztRleSetKernel(ZZT_RLE_AUTO);
+    return ok;
+}
+
+// Overwrite spans of the board with runs, single tiles and copies of their neighbors
+static void mutate_block(ZZTblock *block)
+{
+    int count = block->width * block->height;
+    int edits = 1 + rng_next() % 8;
+    for (int e = 0; e < edits; ++e)
+    {
+        int start = rng_next() % count;
+        int len = (rng_next() % 4 == 0) ? 1 : (int)(rng_next() % 600);
+        ZZTtile fill = block->tiles[rng_next() % count];
+        if (rng_next() % 2)
+        {
+            fill.type = rng_next() % 4 ? block->tiles[start].type : (uint8_t)rng_next();
+            fill.color = (uint8_t)rng_next();
+        }
+        for (int i = start; i < count && i < start + len; ++i)
+            block->tiles[i] = fill;
+    }
+}
+
+// Random runs (0 meaning 256) until the block is covered, sometimes overshooting it
+static int random_stream(uint8_t *out, int count)
+{
+    int covered = 0, len = 0;
+    while (covered < count)
+    {
+        int run = rng_next() % 3 == 0 ? (int)(rng_next() % 256) : 1 + (int)(rng_next() % 8);
+        out[len++] = (uint8_t)run;
+        out[len++] = (uint8_t)(rng_next() % 5);
+        out[len++] = (uint8_t)(rng_next() % 3);
+        covered += run ? run : 256;
+    }
+    return len;
+}
+
+static void fuzz_board(const char *name, int board_idx, ZZTboard *zb, int rounds)
+{
+    char what[300];
+    snprintf(what, sizeof(what), "%s board %d", name, board_idx);
+    if (!check_case(what, zb->packed, NULL, ZZT_BOARD_X_SIZE, ZZT_BOARD_Y_SIZE))
+        return;
+
+    ZZTblock *block = zztBlockCreate(ZZT_BOARD_X_SIZE, ZZT_BOARD_Y_SIZE);
+    _zzt_rle_decode(zb->packed, block);
+
+    static uint8_t stream[ZZT_BOARD_MAX_SIZE * 3];
+    for (int r = 0; r < rounds; ++r)
+    {
+        snprintf(what, sizeof(what), "%s board %d round %d", name, board_idx, r);
+        mutate_block(block);
+        if (!check_case(what, NULL, block, ZZT_BOARD_X_SIZE, ZZT_BOARD_Y_SIZE))
+            break;
+
+        // The board's tiles again, in a block of some other size
+        int width = 1 + rng_next() % ZZT_BOARD_X_SIZE;
+        int height = 1 + rng_next() % ZZT_BOARD_Y_SIZE;
+        if (!check_case(what, NULL, block, width, height))
+            break;
+
+        random_stream(stream, width * height);
+        if (!check_case(what, stream, NULL, width, height))
+            break;
+    }
+
+    zztBlockFree(block);
+}
+
+int main(int argc, char **argv)
+{
+    int rounds = 200;
+    int first = 1;
+    for (; first < argc && argv[first][0] == '-' && first + 1 < argc; first += 2)
+    {
+        if (strcmp(argv[first], "-n") == 0)
+            rounds = atoi(argv[first + 1]);
+        else if (strcmp(argv[first], "-s") == 0)
+            rng_state = strtoull(argv[first + 1], NULL, 0) | 1;
+        else
+            break;
+    }
+
+    if (first >= argc)
+    {
+        fprintf(stderr, "usage: %s [-n rounds] [-s seed] world.zzt [more.zzt ...]\n", argv[0]);
+        return 1;
+    }
+
+    int supported = 0;
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); ++k)
+    {
+        if (zztRleSetKernel(kernels[k]) == kernels[k])
+        {
+            printf("checking %s against scalar\n", kernel_names[kernels[k]]);
+            supported++;
+        }
+    }
+    zztRleSetKernel(ZZT_RLE_AUTO);
+    if (supported == 0)
+        printf("only the scalar kernel runs on this machine; nothing to compare\n");
+
+    int worlds = 0, boards = 0;
+    for (int i = first; i < argc; ++i)
+    {
+        Bzzt_File_Map map;
+        if (!Bzzt_File_Map_Open(argv[i], &map))
+        {
+            fprintf(stderr, "rle_fuzz: could not read %s\n", argv[i]);
+            continue;
+        }
+
+        ZZTworld *zw = zztWorldReadMem(map.data, map.size);
+        Bzzt_File_Map_Close(&map);
+        if (!zw)
+        {
+            fprintf(stderr, "rle_fuzz: %s is not a ZZT world\n", argv[i]);
+            continue;
+        }
+
+        // zztWorldReadMem leaves every board packed, so each one's RLE data is there to decode
+        for (int b = 0; b < zztWorldGetBoardcount(zw); ++b)
+            fuzz_board(argv[i], b, &zw->boards[b], rounds);
+
+        worlds++;
+        boards += zztWorldGetBoardcount(zw);
+        zztWorldFree(zw);
+    }
+
+    printf("%d worlds, %d boards, %ld comparisons, %ld mismatches\n", worlds, boards, checks, failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file save_bench.c
+ * @brief ZZT world save speed through libzzt2's buffered writer
+ *
+ * Usage: save_bench world.zzt [more.zzt ...]
+ *
+ * Each world is read, then written back out repeatedly, once with every
+ * board still packed and once with the current board unpacked the way an
+ * editor leaves it. The "same" column says whether the packed save came
+ * out byte for byte identical to the file that was read.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "zzt.h"
+#include "clock.h"
+#include "file_map.h"
+
+#define SAVE_BENCH_REPS 50
+
+static double time_saves(ZZTworld *zw, size_t *out_size)
+{
+    double start_ms = Bzzt_Clock_Now_Ms();
+    for (int i = 0; i < SAVE_BENCH_REPS; ++i)
+    {
+        size_t size = 0;
+        uint8_t *data = zztWorldWriteMem(zw, &size);
+        free(data);
+        *out_size = size;
+    }
+    return (Bzzt_Clock_Now_Ms() - start_ms) / SAVE_BENCH_REPS;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s world.zzt [more.zzt ...]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%-32s %8s %10s %12s %12s %6s\n", "world", "boards", "bytes", "packed ms", "unpacked ms", "same");
+    for (int i = 1; i < argc; ++i)
+    {
+        Bzzt_File_Map map;
+        if (!Bzzt_File_Map_Open(argv[i], &map))
+        {
+            fprintf(stderr, "save_bench: could not read %s\n", argv[i]);
+            continue;
+        }
+
+        ZZTworld *zw = zztWorldReadMem(map.data, map.size);
+        if (!zw)
+        {
+            fprintf(stderr, "save_bench: %s is not a ZZT world\n", argv[i]);
+            Bzzt_File_Map_Close(&map);
+            continue;
+        }
+
+        // zztWorldReadMem leaves every board packed, which is the first case timed
+        size_t size = 0;
+        uint8_t *saved = zztWorldWriteMem(zw, &size);
+        bool same = saved && size == map.size && memcmp(saved, map.data, size) == 0;
+        free(saved);
+
+        double packed_ms = time_saves(zw, &size);
+        zztBoardSelect(zw, zztWorldGetBoardcount(zw) / 2);
+        double unpacked_ms = time_saves(zw, &size);
+
+        printf("%-32s %8d %10zu %12.3f %12.3f %6s\n", argv[i], zztWorldGetBoardcount(zw), size, packed_ms,
+               unpacked_ms, same ? "yes" : "no");
+
+        zztWorldFree(zw);
+        Bzzt_File_Map_Close(&map);
+    }
+
+    return 0;
+}
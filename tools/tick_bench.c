@@ -0,0 +1,163 @@
+/**
+ * @file tick_bench.c
+ * @brief Ticks/sec of the serial tick loop vs the two-phase tick as workers are added
+ *
+ * Usage: tick_bench [stats] [ticks]
+ *
+ * Builds one large board full of spinning guns, bullets, stars and pushers,
+ * on a mix of cycles, then runs the same number of ticks through
+ * Bzzt_Timer_Run_Tick in each mode. Every two-phase run, whatever the worker
+ * count, must end on exactly the board the serial tick ends on; the board
+ * hash column shows it. Exits non-zero if any run differs.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "bzzt.h"
+#include "timing.h"
+#include "clock.h"
+#include "thread_pool.h"
+#include "ui.h"
+
+#define BENCH_BOARD_W 240
+#define BENCH_BOARD_H 120
+
+static Bzzt_World *build_world(int stat_target)
+{
+    Bzzt_World *w = Bzzt_World_Create("tick bench");
+    if (!w)
+        return NULL;
+
+    Bzzt_Board *b = Bzzt_Board_Create("bench", BENCH_BOARD_W, BENCH_BOARD_H);
+    if (!b)
+    {
+        Bzzt_World_Destroy(w);
+        return NULL;
+    }
+    Bzzt_World_Add_Board(w, b);
+
+    Bzzt_Board_Spawn_Stat(b, ZZT_PLAYER, BENCH_BOARD_W / 2, BENCH_BOARD_H / 2, COLOR_WHITE, COLOR_BLUE);
+
+    // Fixed LCG so every run starts from the same layout
+    uint32_t lcg = 12345u;
+    int placed = 1;
+    for (int tries = 0; placed < stat_target && tries < stat_target * 8; ++tries)
+    {
+        lcg = lcg * 1103515245u + 12345u;
+        int x = (int)((lcg >> 8) % BENCH_BOARD_W);
+        lcg = lcg * 1103515245u + 12345u;
+        int y = (int)((lcg >> 8) % BENCH_BOARD_H);
+        if (Bzzt_Board_Get_Tile(b, x, y).element != ZZT_EMPTY)
+            continue;
+
+        uint8_t element = (placed % 8 == 0)   ? ZZT_PUSHER
+                          : (placed % 5 == 0) ? ZZT_BULLET
+                          : (placed % 3 == 0) ? ZZT_STAR
+                                              : ZZT_SPINNINGGUN;
+        Bzzt_Stat *s = Bzzt_Board_Spawn_Stat(b, element, x, y, COLOR_LIGHT_GREEN, COLOR_BLACK);
+        if (!s)
+            break;
+
+        // Cycles above 1 make whether a stat acts depend on its index, which shifts as stats die
+        s->cycle = 1 + placed % 3;
+        if (element == ZZT_SPINNINGGUN)
+        {
+            s->data[0] = 4; // Intelligence
+            s->data[1] = 3; // Fire rate
+        }
+        else if (element == ZZT_STAR)
+        {
+            s->data[0] = 255; // Lifetime
+        }
+        else if (element == ZZT_BULLET)
+        {
+            s->data[0] = 1; // Fired by an enemy
+            s->step_x = (placed & 2) ? 1 : -1;
+        }
+        else
+        {
+            s->step_x = (placed & 1) ? 1 : -1;
+        }
+        placed++;
+    }
+
+    w->boards_current = w->boards_count - 1;
+    w->on_title = false;
+    return w;
+}
+
+static uint64_t hash_board(const Bzzt_Board *b)
+{
+    uint64_t h = 1469598103934665603ull;
+    for (int i = 0; i < b->width * b->height; ++i)
+    {
+        h = (h ^ b->tiles[i].element) * 1099511628211ull;
+        h = (h ^ b->tiles[i].glyph) * 1099511628211ull;
+    }
+    return (h ^ (uint64_t)b->stat_count) * 1099511628211ull;
+}
+
+// threads < 0 runs the plain serial tick; otherwise two-phase with that many workers (0 = inline plan).
+// Returns the hash of the board it ends on.
+static uint64_t run_case(UI *ui, int stat_target, int ticks, int threads)
+{
+    Bzzt_World *w = build_world(stat_target);
+    if (!w)
+    {
+        fprintf(stderr, "tick_bench: could not build the world\n");
+        return 0;
+    }
+
+    if (threads >= 0 && !Bzzt_World_Set_Two_Phase_Ticking(w, true, threads))
+        fprintf(stderr, "tick_bench: could not start %d workers\n", threads);
+
+    Bzzt_Board *b = w->boards[w->boards_current];
+    int start_stats = b->stat_count;
+    double start_ms = Bzzt_Clock_Now_Ms();
+    for (int i = 0; i < ticks; ++i)
+        Bzzt_Timer_Run_Tick(ui, w);
+    double elapsed_ms = Bzzt_Clock_Now_Ms() - start_ms;
+
+    char label[32];
+    if (threads < 0)
+        snprintf(label, sizeof(label), "serial");
+    else if (threads == 0)
+        snprintf(label, sizeof(label), "two-phase inline");
+    else
+        snprintf(label, sizeof(label), "two-phase x%d", threads);
+
+    uint64_t hash = hash_board(b);
+    printf("%-18s %8d %8d %12.1f %10.3f  %016llx\n", label, start_stats, b->stat_count,
+           elapsed_ms > 0.0 ? ticks * 1000.0 / elapsed_ms : 0.0,
+           elapsed_ms / ticks, (unsigned long long)hash);
+
+    Bzzt_World_Destroy(w);
+    return hash;
+}
+
+int main(int argc, char **argv)
+{
+    int stat_target = argc > 1 ? atoi(argv[1]) : 8000;
+    int ticks = argc > 2 ? atoi(argv[2]) : 200;
+    if (stat_target < 2)
+        stat_target = 2;
+    if (ticks < 1)
+        ticks = 1;
+
+    int cpus = Bzzt_Cpu_Count();
+    printf("%d stats requested, %d ticks, %d CPUs\n", stat_target, ticks, cpus);
+    printf("%-18s %8s %8s %12s %10s  %s\n", "mode", "stats", "end", "ticks/sec", "ms/tick", "board hash");
+
+    // Hits on the player flash messages on the UI; a headless one is enough
+    UI *ui = UI_Create_Headless();
+    uint64_t serial = run_case(ui, stat_target, ticks, -1);
+    int mismatches = run_case(ui, stat_target, ticks, 0) != serial;
+    for (int threads = 1; threads <= cpus * 2 && threads <= 64; threads *= 2)
+        mismatches += run_case(ui, stat_target, ticks, threads) != serial;
+    UI_Destroy(ui);
+
+    printf("two-phase %s the serial tick\n", mismatches ? "DIFFERS from" : "matches");
+    return mismatches ? 1 : 0;
+}